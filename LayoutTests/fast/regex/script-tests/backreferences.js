@@ -0,0 +1,28 @@
+description(
+"Tests back references to subpatterns that have not matched, that failed, that contain the back reference, and that are backtracked into."
+);
+
+// A reference to a subpattern that has not participated in the match matches the empty string.
+shouldBe('/\\1(a)/.exec("aa")', '["a", "a"]');
+shouldBe('/(a)?b\\1/.exec("bc")', '["b", undefined]');
+shouldBe('/(?:(a)b|ac)\\1/.exec("acd")', '["ac", undefined]');
+shouldBe('/(?:(a)x|a)\\1y/.exec("aay")', '["ay", undefined]');
+
+// A reference inside the subpattern it refers to matches the empty string.
+shouldBe('/(a\\1)/.exec("aa")', '["a", "a"]');
+shouldBe('/^(a\\1b)/.exec("aab")', 'null');
+shouldBe('/(a\\1b)/.exec("ab")', '["ab", "ab"]');
+shouldBe('/(a|\\1b)+/.exec("aab")', '["aab", "b"]');
+shouldBe('/(a|b\\1)+/.exec("aba")', '["aba", "a"]');
+
+// Backtracking into and out of a back reference.
+shouldBe('/(a+)\\1/.exec("aaaaa")', '["aaaa", "aa"]');
+shouldBe('/(a+)\\1b/.exec("aaaab")', '["aaaab", "aa"]');
+shouldBe('/(a*)\\1c/.exec("aaac")', '["aac", "a"]');
+shouldBe('/(a|ab)\\1c/.exec("ababc")', '["ababc", "ab"]');
+shouldBe('/(x)(y)?\\2\\1/.exec("xx")', '["xx", "x", undefined]');
+shouldBe('/^(.)(.)\\2\\1$/.test("abba")', 'true');
+shouldBe('/^(.)(.)\\2\\1$/.test("abab")', 'false');
+shouldBe('"abcabcab".replace(/(abc)\\1/, "-")', '"-ab"');
+
+var successfullyParsed = true;
@@ -46,6 +46,18 @@ using namespace JSC;
 JSContextGroupRef JSContextGroupCreate()
 {
     initializeThreading();
+    RefPtr<JSGlobalData> globalData = JSGlobalData::createContextGroup(ThreadStackTypeSmall);
+#if ENABLE(JSC_MULTIPLE_THREADS)
+    globalData->makeUsableFromMultipleThreads();
+#endif
+    return toRef(globalData.release().leakRef());
+}
+
+JSContextGroupRef JSContextGroupCreateWithThreadAffinity()
+{
+    initializeThreading();
+    // The group's heap does not track the threads that use it, so collection only scans the
+    // stack of the thread that is inside the group at the time.
     return toRef(JSGlobalData::createContextGroup(ThreadStackTypeSmall).leakRef());
 }
 
@@ -83,15 +95,13 @@ JSGlobalContextRef JSGlobalContextCreateInGroup(JSContextGroupRef group, JSClass
 {
     initializeThreading();
 
-    JSLock lock(LockForReal);
-    RefPtr<JSGlobalData> globalData = group ? PassRefPtr<JSGlobalData>(toJS(group)) : JSGlobalData::createContextGroup(ThreadStackTypeSmall);
+    // Only the shared group is guarded by the global lock; any other group is only ever
+    // used by the threads its client lets in.
+    JSLock lock(group && toJS(group)->isSharedInstance() ? LockForReal : SilenceAssertionsOnly);
+    RefPtr<JSGlobalData> globalData = group ? PassRefPtr<JSGlobalData>(toJS(group)) : adoptRef(toJS(JSContextGroupCreate()));
 
     APIEntryShim entryShim(globalData.get(), false);
 
-#if ENABLE(JSC_MULTIPLE_THREADS)
-    globalData->makeUsableFromMultipleThreads();
-#endif
-
     if (!globalObjectClass) {
         JSGlobalObject* globalObject = new (globalData.get()) JSGlobalObject(*globalData);
         return JSGlobalContextRetain(toGlobalRef(globalObject->globalExec()));
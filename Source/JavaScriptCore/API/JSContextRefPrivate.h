@@ -46,6 +46,20 @@ extern "C" {
 */
 JS_EXPORT JSGlobalContextRef JSContextGetGlobalContext(JSContextRef ctx);
 
+/*!
+@function
+@abstract Creates a JavaScript context group that is used by one thread at a time.
+@discussion A group created this way behaves like one created by JSContextGroupCreate,
+ except that it does not keep track of the threads that have used it. Garbage collection
+ in the group only scans the stack of the thread that is using the group at the time,
+ rather than stopping every thread that has ever entered it, so that groups run from
+ a pool of threads do not interrupt one another. The client must make sure that at most
+ one thread uses the group at any time, and that no other thread holds unprotected
+ JSValueRefs or JSObjectRefs from the group while it does.
+@result The created JSContextGroup.
+*/
+JS_EXPORT JSContextGroupRef JSContextGroupCreateWithThreadAffinity();
+
 #ifdef __cplusplus
 }
 #endif
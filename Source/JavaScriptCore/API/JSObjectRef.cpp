@@ -31,6 +31,7 @@
 #include "APICast.h"
 #include "CodeBlock.h"
 #include "DateConstructor.h"
+#include "Error.h"
 #include "ErrorConstructor.h"
 #include "FunctionConstructor.h"
 #include "Identifier.h"
@@ -159,6 +160,21 @@ JSObjectRef JSObjectMakeArray(JSContextRef ctx, size_t argumentCount, const JSVa
     return toRef(result);
 }
 
+JSObjectRef JSObjectMakeWithProperties(JSContextRef ctx, size_t propertyCount, const JSStringRef propertyNames[], const JSValueRef propertyValues[])
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    // Objects built from the same names in the same order follow the same Structure
+    // transitions, and so end up sharing a Structure.
+    JSGlobalData& globalData = exec->globalData();
+    JSObject* result = constructEmptyObject(exec);
+    for (size_t i = 0; i < propertyCount; ++i)
+        result->putDirect(globalData, propertyNames[i]->identifier(&globalData), toJS(exec, propertyValues[i]));
+
+    return toRef(result);
+}
+
 JSObjectRef JSObjectMakeDate(JSContextRef ctx, size_t argumentCount, const JSValueRef arguments[],  JSValueRef* exception)
 {
     ExecState* exec = toJS(ctx);
@@ -320,6 +336,65 @@ void JSObjectSetPropertyAtIndex(JSContextRef ctx, JSObjectRef object, unsigned p
     }
 }
 
+static bool isValidIndexRange(ExecState* exec, unsigned firstIndex, size_t count, JSValueRef* exception)
+{
+    if (count <= static_cast<size_t>(UINT_MAX - firstIndex))
+        return true;
+    if (exception)
+        *exception = toRef(exec, createRangeError(exec, "Index range extends past the largest property index"));
+    return false;
+}
+
+size_t JSObjectGetPropertiesAtIndexRange(JSContextRef ctx, JSObjectRef object, unsigned firstIndex, size_t count, JSValueRef values[], JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    if (!isValidIndexRange(exec, firstIndex, count, exception))
+        return 0;
+
+    JSObject* jsObject = toJS(object);
+    JSArray* jsArray = isJSArray(&exec->globalData(), jsObject) ? static_cast<JSArray*>(jsObject) : 0;
+
+    // The values handed back are kept alive until this returns, since reading a
+    // later one may allocate.
+    MarkedArgumentBuffer readValues;
+    for (size_t i = 0; i < count; ++i) {
+        unsigned propertyIndex = firstIndex + i;
+        JSValue jsValue = jsArray && jsArray->canGetIndex(propertyIndex) ? jsArray->getIndex(propertyIndex) : jsObject->get(exec, propertyIndex);
+        if (exec->hadException()) {
+            if (exception)
+                *exception = toRef(exec, exec->exception());
+            exec->clearException();
+            return i;
+        }
+        values[i] = toRef(exec, jsValue);
+        readValues.append(toJSForGC(exec, values[i]));
+    }
+    return count;
+}
+
+size_t JSObjectSetPropertiesAtIndexRange(JSContextRef ctx, JSObjectRef object, unsigned firstIndex, size_t count, const JSValueRef values[], JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    if (!isValidIndexRange(exec, firstIndex, count, exception))
+        return 0;
+
+    JSObject* jsObject = toJS(object);
+    for (size_t i = 0; i < count; ++i) {
+        jsObject->put(exec, firstIndex + i, toJS(exec, values[i]));
+        if (exec->hadException()) {
+            if (exception)
+                *exception = toRef(exec, exec->exception());
+            exec->clearException();
+            return i;
+        }
+    }
+    return count;
+}
+
 bool JSObjectDeleteProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName, JSValueRef* exception)
 {
     ExecState* exec = toJS(ctx);
@@ -378,6 +453,22 @@ JSValueRef JSObjectGetPrivateProperty(JSContextRef ctx, JSObjectRef object, JSSt
     return toRef(exec, result);
 }
 
+bool JSObjectIsFunctionOptimized(JSContextRef ctx, JSObjectRef object)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+#if ENABLE(DFG_JIT)
+    JSObject* jsObject = toJS(object);
+    if (!jsObject->inherits(&JSFunction::s_info))
+        return false;
+    JSFunction* function = static_cast<JSFunction*>(jsObject);
+    return !function->isHostFunction() && function->jsExecutable()->isOptimizedForCall();
+#else
+    UNUSED_PARAM(object);
+    return false;
+#endif
+}
+
 bool JSObjectSetPrivateProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName, JSValueRef value)
 {
     ExecState* exec = toJS(ctx);
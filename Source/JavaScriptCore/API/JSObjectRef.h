@@ -443,6 +443,18 @@ JS_EXPORT JSObjectRef JSObjectMakeConstructor(JSContextRef ctx, JSClassRef jsCla
  */
 JS_EXPORT JSObjectRef JSObjectMakeArray(JSContextRef ctx, size_t argumentCount, const JSValueRef arguments[], JSValueRef* exception) AVAILABLE_IN_WEBKIT_VERSION_4_0;
 
+/*!
+ @function
+ @abstract Creates a JavaScript object with the given properties.
+ @param ctx The execution context to use.
+ @param propertyCount The number of properties in propertyNames and propertyValues.
+ @param propertyNames A JSString array of property names. Pass NULL if propertyCount is 0.
+ @param propertyValues A JSValue array of the properties' values, in the same order as propertyNames. Pass NULL if propertyCount is 0.
+ @result A JSObject with the default object class, holding the given properties.
+ @discussion The properties are defined in order, like those of an object literal, so setters on Object.prototype are not called. Objects created from the same property names in the same order share their internal layout, which makes creating many objects of one shape cheap.
+ */
+JS_EXPORT JSObjectRef JSObjectMakeWithProperties(JSContextRef ctx, size_t propertyCount, const JSStringRef propertyNames[], const JSValueRef propertyValues[]);
+
 /*!
  @function
  @abstract Creates a JavaScript Date object, as if by invoking the built-in Date constructor.
@@ -577,6 +589,36 @@ JS_EXPORT JSValueRef JSObjectGetPropertyAtIndex(JSContextRef ctx, JSObjectRef ob
 */
 JS_EXPORT void JSObjectSetPropertyAtIndex(JSContextRef ctx, JSObjectRef object, unsigned propertyIndex, JSValueRef value, JSValueRef* exception);
 
+/*!
+@function
+@abstract Gets a contiguous range of an object's properties by numeric index.
+@param ctx The execution context to use.
+@param object The JSObject whose properties you want to get.
+@param firstIndex The index of the first property to get.
+@param count The number of properties to get.
+@param values A JSValue array with room for count values, in which to store the properties' values.
+@param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result The number of values stored in values. This is less than count only if getting a property threw an exception, in which case no further properties are read. If firstIndex + count exceeds UINT_MAX, no properties are read, 0 is returned and a RangeError is stored in exception.
+@discussion Calling JSObjectGetPropertiesAtIndexRange is equivalent to calling JSObjectGetPropertyAtIndex for each index from firstIndex to firstIndex + count - 1, but enters the execution context only once.
+
+The values stored in values are not protected from garbage collection. They remain valid only while they are referenced from the stack; a caller that keeps them anywhere else, such as in a heap-allocated array, must call JSValueProtect on each one it needs.
+*/
+JS_EXPORT size_t JSObjectGetPropertiesAtIndexRange(JSContextRef ctx, JSObjectRef object, unsigned firstIndex, size_t count, JSValueRef values[], JSValueRef* exception);
+
+/*!
+@function
+@abstract Sets a contiguous range of an object's properties by numeric index.
+@param ctx The execution context to use.
+@param object The JSObject whose properties you want to set.
+@param firstIndex The index of the first property to set.
+@param count The number of properties to set.
+@param values A JSValue array of count values to use as the properties' values.
+@param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result The number of properties set. This is less than count only if setting a property threw an exception, in which case no further properties are set. If firstIndex + count exceeds UINT_MAX, no properties are set, 0 is returned and a RangeError is stored in exception.
+@discussion Calling JSObjectSetPropertiesAtIndexRange is equivalent to calling JSObjectSetPropertyAtIndex for each index from firstIndex to firstIndex + count - 1, but enters the execution context only once.
+*/
+JS_EXPORT size_t JSObjectSetPropertiesAtIndexRange(JSContextRef ctx, JSObjectRef object, unsigned firstIndex, size_t count, const JSValueRef values[], JSValueRef* exception);
+
 /*!
 @function
 @abstract Gets an object's private data.
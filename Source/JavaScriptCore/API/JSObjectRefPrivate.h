@@ -67,6 +67,16 @@ JS_EXPORT JSValueRef JSObjectGetPrivateProperty(JSContextRef ctx, JSObjectRef ob
  */
 JS_EXPORT bool JSObjectDeletePrivateProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName);
 
+/*!
+ @function
+ @abstract Tests whether calls to a function run code from the optimizing JIT.
+ @param ctx The execution context to use.
+ @param object The JSObject to test.
+ @result true if object is a JavaScript function that the DFG JIT has recompiled, otherwise false.
+ @discussion Functions start out in the baseline JIT, and are recompiled by the DFG JIT once they have run often enough, if it can compile them. This is meant for testing that tier-up; builds without the DFG JIT always return false.
+ */
+JS_EXPORT bool JSObjectIsFunctionOptimized(JSContextRef ctx, JSObjectRef object);
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,6 +39,12 @@ JSStringRef JSStringCreateWithCharacters(const JSChar* chars, size_t numChars)
     return OpaqueJSString::create(chars, numChars).leakRef();
 }
 
+JSStringRef JSStringCreateWithCharactersNoCopy(const JSChar* chars, size_t numChars, JSStringReleaseCallback releaseCallback, void* context)
+{
+    initializeThreading();
+    return OpaqueJSString::createWithExternalBuffer(chars, numChars, releaseCallback, context).leakRef();
+}
+
 JSStringRef JSStringCreateWithUTF8CString(const char* string)
 {
     initializeThreading();
@@ -57,6 +57,25 @@ extern "C" {
 */
 JS_EXPORT JSStringRef JSStringCreateWithCharacters(const JSChar* chars, size_t numChars);
 /*!
+@typedef JSStringReleaseCallback
+@abstract The callback invoked when a JavaScript string no longer needs the buffer it was created with.
+@param chars The buffer passed to JSStringCreateWithCharactersNoCopy.
+@param context The context passed to JSStringCreateWithCharactersNoCopy.
+@discussion The callback may be invoked on any thread, and may be invoked before JSStringCreateWithCharactersNoCopy returns.
+*/
+typedef void (*JSStringReleaseCallback)(const JSChar* chars, void* context);
+/*!
+@function
+@abstract         Creates a JavaScript string that uses a buffer of Unicode characters without copying it.
+@param chars      The buffer of Unicode characters for the new JSString to use.
+@param numChars   The number of characters in the buffer pointed to by chars.
+@param releaseCallback The callback to invoke once neither the JSString nor any JavaScript string value made from it uses chars any more. The buffer must not change until then.
+@param context    A pointer to pass back to releaseCallback.
+@result           A JSString containing chars. Ownership follows the Create Rule.
+@discussion       JavaScript string values made from the result with JSValueMakeString share the buffer as well, and so do strings copied back out of them with JSValueToStringCopy. Strings of fewer than 20 characters are copied instead, and releaseCallback is invoked before this function returns.
+*/
+JS_EXPORT JSStringRef JSStringCreateWithCharactersNoCopy(const JSChar* chars, size_t numChars, JSStringReleaseCallback releaseCallback, void* context);
+/*!
 @function
 @abstract         Creates a JavaScript string from a null-terminated UTF8 string.
 @param string     The null-terminated UTF8 string to copy into the new JSString.
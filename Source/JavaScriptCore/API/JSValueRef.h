@@ -259,6 +259,7 @@ JS_EXPORT double JSValueToNumber(JSContextRef ctx, JSValueRef value, JSValueRef*
 @param value    The JSValue to convert.
 @param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
 @result         A JSString with the result of conversion, or NULL if an exception is thrown. Ownership follows the Create Rule.
+@discussion     The result only shares the characters of the converted string, rather than copying them, when they are 16-bit, at least 20 characters long, and held in a buffer of their own, such as one passed to JSStringCreateWithCharactersNoCopy. Other strings are copied, including strings that keep their characters inline or as 8-bit Latin-1, and strings built by concatenation.
 */
 JS_EXPORT JSStringRef JSValueToStringCopy(JSContextRef ctx, JSValueRef value, JSValueRef* exception);
 
@@ -68,6 +68,27 @@ JSObjectRef JSWeakObjectMapGet(JSContextRef ctx, JSWeakObjectMapRef map, void* k
     return toRef(static_cast<JSObject*>(map->map().get(key)));
 }
 
+void JSWeakObjectMapSetCapacity(JSContextRef ctx, JSWeakObjectMapRef map, size_t capacity)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+    map->map().setCapacity(capacity);
+}
+
+void JSWeakObjectMapGetStatistics(JSContextRef ctx, JSWeakObjectMapRef map, JSWeakObjectMapStatistics* statistics)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+    WeakMapType& weakMap = map->map();
+    weakMap.purgeDeadEntries();
+    statistics->size = weakMap.size();
+    statistics->capacity = weakMap.capacity();
+    statistics->hits = weakMap.hits();
+    statistics->misses = weakMap.misses();
+    statistics->evictions = weakMap.evictions();
+    statistics->finalizations = weakMap.finalizations();
+}
+
 // We need to keep this function in the build to keep the nightlies running.
 JS_EXPORT bool JSWeakObjectMapClear(JSContextRef, JSWeakObjectMapRef, void*, JSObjectRef);
 bool JSWeakObjectMapClear(JSContextRef, JSWeakObjectMapRef, void*, JSObjectRef)
@@ -44,6 +44,25 @@ typedef struct OpaqueJSWeakObjectMap* JSWeakObjectMapRef;
  */
 typedef void (*JSWeakMapDestroyedCallback)(JSWeakObjectMapRef map, void* data);
 
+/*!
+ @struct JSWeakObjectMapStatistics
+ @abstract Counters describing how well a JSWeakObjectMapRef is working as a cache.
+ @field size The number of entries in the map, including entries whose objects were collected but not yet purged.
+ @field capacity The maximum number of entries, or 0 if the map is unbounded.
+ @field hits The number of lookups that found a live object.
+ @field misses The number of lookups that found nothing.
+ @field evictions The number of entries dropped to stay within capacity.
+ @field finalizations The number of entries removed because their objects were collected.
+ */
+typedef struct {
+    size_t size;
+    size_t capacity;
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t finalizations;
+} JSWeakObjectMapStatistics;
+
 /*!
  @function
  @abstract Creates a weak value map that can be used to reference user defined objects without preventing them from being collected.
@@ -76,6 +95,28 @@ JS_EXPORT void JSWeakObjectMapSet(JSContextRef ctx, JSWeakObjectMapRef map, void
  */
 JS_EXPORT JSObjectRef JSWeakObjectMapGet(JSContextRef ctx, JSWeakObjectMapRef map, void* key);
 
+/*!
+ @function
+ @abstract Limits the number of entries a JSWeakObjectMap holds.
+ @param ctx The execution context to use.
+ @param map The map to operate on.
+ @param capacity The maximum number of entries, or 0 to let the map grow without bound.
+ @discussion Once the map is full, associating a new key drops the oldest entry that has not been
+ retrieved with JSWeakObjectMapGet since the map last considered dropping it. Only bound maps whose objects
+ can be recreated on demand, since a dropped key will no longer find the object it was associated with.
+ */
+JS_EXPORT void JSWeakObjectMapSetCapacity(JSContextRef ctx, JSWeakObjectMapRef map, size_t capacity);
+
+/*!
+ @function
+ @abstract Retrieves the hit, miss, eviction and finalization counters of a JSWeakObjectMap.
+ @param ctx The execution context to use.
+ @param map The map to query.
+ @param statistics A pointer to the structure to fill in.
+ @discussion Entries whose objects were collected are purged in a batch before this function reads the counters.
+ */
+JS_EXPORT void JSWeakObjectMapGetStatistics(JSContextRef ctx, JSWeakObjectMapRef map, JSWeakObjectMapStatistics* statistics);
+
 #ifdef __cplusplus
 }
 #endif
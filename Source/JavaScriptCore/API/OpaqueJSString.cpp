@@ -32,18 +32,42 @@
 
 using namespace JSC;
 
+PassRefPtr<OpaqueJSString> OpaqueJSString::createWithExternalBuffer(const UChar* characters, unsigned length, SharableUChar::ReleaseCallback releaseCallback, void* releaseContext)
+{
+    if (!StringImpl::canShareBuffer(length)) {
+        RefPtr<OpaqueJSString> string = create(characters, length);
+        releaseCallback(characters, releaseContext);
+        return string.release();
+    }
+
+    RefPtr<SharedUChar> sharedBuffer = SharedUChar::create(new SharableUChar(characters, releaseCallback, releaseContext));
+    return adoptRef(new OpaqueJSString(characters, length, sharedBuffer->crossThreadCopy()));
+}
+
 PassRefPtr<OpaqueJSString> OpaqueJSString::create(const UString& ustring)
 {
-    if (!ustring.isNull())
-        return adoptRef(new OpaqueJSString(ustring.characters(), ustring.length()));
-    return 0;
+    if (ustring.isNull())
+        return 0;
+
+    // Share the string's buffer rather than copying it when it has one that can be shared.
+    // Strings with inline or 8-bit characters have no such buffer; handing out their
+    // storage would tie the OpaqueJSString, which may be released on any thread, to a
+    // StringImpl, which may not.
+    StringImpl* impl = ustring.impl();
+    if (!impl->is8Bit()) {
+        if (SharedUChar* sharedBuffer = impl->sharedBuffer())
+            return adoptRef(new OpaqueJSString(impl->characters16(), impl->length(), sharedBuffer->crossThreadCopy()));
+    }
+    return adoptRef(new OpaqueJSString(ustring.characters(), ustring.length()));
 }
 
 UString OpaqueJSString::ustring() const
 {
-    if (this && m_characters)
-        return UString(m_characters, m_length);
-    return UString();
+    if (!this || !m_characters)
+        return UString();
+    if (m_sharedBuffer)
+        return UString(StringImpl::create(m_characters, m_length, m_sharedBuffer->crossThreadCopy()));
+    return UString(m_characters, m_length);
 }
 
 Identifier OpaqueJSString::identifier(JSGlobalData* globalData) const
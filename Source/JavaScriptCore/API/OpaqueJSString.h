@@ -45,6 +45,9 @@ struct OpaqueJSString : public ThreadSafeRefCounted<OpaqueJSString> {
         return adoptRef(new OpaqueJSString(characters, length));
     }
 
+    // Uses a buffer owned by the caller instead of copying it; see StringImpl::createWithExternalBuffer.
+    static PassRefPtr<OpaqueJSString> createWithExternalBuffer(const UChar* characters, unsigned length, SharableUChar::ReleaseCallback, void* releaseContext);
+
     static PassRefPtr<OpaqueJSString> create(const JSC::UString&);
 
     UChar* characters() { return this ? m_characters : 0; }
@@ -69,13 +72,26 @@ private:
         memcpy(m_characters, characters, length * sizeof(UChar));
     }
 
+    // Shares characters, which must point into sharedBuffer, with the strings made from it.
+    OpaqueJSString(const UChar* characters, unsigned length, PassRefPtr<SharedUChar> sharedBuffer)
+        : m_characters(const_cast<UChar*>(characters))
+        , m_length(length)
+        , m_sharedBuffer(sharedBuffer)
+    {
+    }
+
     ~OpaqueJSString()
     {
-        delete[] m_characters;
+        if (!m_sharedBuffer)
+            delete[] m_characters;
     }
 
     UChar* m_characters;
     unsigned m_length;
+
+    // Copies of this are handed to the UStrings made from this string. It is only ever
+    // copied, never ref'ed, so it can be used from any thread.
+    RefPtr<SharedUChar> m_sharedBuffer;
 };
 
 #endif
@@ -27,6 +27,7 @@
 #include "JSBasePrivate.h"
 #include "JSContextRefPrivate.h"
 #include "JSObjectRefPrivate.h"
+#include "JSWeakObjectMapRefPrivate.h"
 #include <math.h>
 #define ASSERT_DISABLED 0
 #include <wtf/Assertions.h>
@@ -821,6 +822,151 @@ static bool checkForCycleInPrototypeChain()
     return result;
 }
 
+#if ENABLE(DFG_JIT)
+static bool checkIntegerLoopIsOptimized()
+{
+    bool result = true;
+    JSGlobalContextRef context = JSGlobalContextCreate(0);
+    JSStringRef code = JSStringCreateWithUTF8CString("(function (n) { var sum = 0; for (var i = 0; i < n; ++i) sum = sum + (i * 3 - i); return sum; })");
+    JSObjectRef function = JSValueToObject(context, JSEvaluateScript(context, code, 0, 0, 1, 0), 0);
+    JSValueRef arguments[1];
+    int i;
+
+    // Only integer add, sub and mul run here, so once the loop is hot the
+    // baseline JIT's profiles let the DFG JIT compile the function.
+    arguments[0] = JSValueMakeNumber(context, 1000);
+    for (i = 0; i < 10; ++i)
+        assertEqualsAsNumber(JSObjectCallAsFunction(context, function, 0, 1, arguments, 0), 999000);
+    result &= assertTrue(JSObjectIsFunctionOptimized(context, function), "An integer loop is compiled by the DFG JIT");
+    assertEqualsAsNumber(JSObjectCallAsFunction(context, function, 0, 1, arguments, 0), 999000);
+
+    JSStringRelease(code);
+    JSGlobalContextRelease(context);
+    return result;
+}
+#endif
+
+static void weakObjectMapDestroyed(JSWeakObjectMapRef map, void* data)
+{
+    UNUSED_PARAM(map);
+    UNUSED_PARAM(data);
+}
+
+static bool checkWeakObjectMapCapacity()
+{
+    enum { capacity = 4, objectCount = 8 };
+    bool result = true;
+    JSGlobalContextRef context = JSGlobalContextCreate(0);
+    JSWeakObjectMapRef map = JSWeakObjectMapCreate(context, 0, weakObjectMapDestroyed);
+    JSObjectRef objects[objectCount];
+    JSWeakObjectMapStatistics statistics;
+    int i;
+
+    // Each object is stored under the address of its own array slot.
+
+    for (i = 0; i < objectCount; ++i) {
+        objects[i] = JSObjectMake(context, EmptyObject_class(context), 0);
+        JSValueProtect(context, objects[i]);
+    }
+
+    JSWeakObjectMapSetCapacity(context, map, capacity);
+    for (i = 0; i < capacity; ++i)
+        JSWeakObjectMapSet(context, map, &objects[i], objects[i]);
+
+    // Looking up the oldest entry gives it a second chance, so filling past
+    // capacity drops the next oldest one instead.
+    result &= assertTrue(JSWeakObjectMapGet(context, map, &objects[0]) == objects[0], "The oldest entry can be retrieved");
+    JSWeakObjectMapSet(context, map, &objects[capacity], objects[capacity]);
+    result &= assertTrue(JSWeakObjectMapGet(context, map, &objects[0]) == objects[0], "A recently retrieved entry is not evicted");
+    result &= assertTrue(!JSWeakObjectMapGet(context, map, &objects[1]), "The oldest unreferenced entry is evicted");
+    for (i = 2; i <= capacity; ++i)
+        result &= assertTrue(JSWeakObjectMapGet(context, map, &objects[i]) == objects[i], "Entries within capacity are kept");
+
+    JSWeakObjectMapGetStatistics(context, map, &statistics);
+    result &= assertTrue(statistics.size == capacity, "The map holds capacity entries");
+    result &= assertTrue(statistics.capacity == capacity, "The capacity is reported");
+    result &= assertTrue(statistics.hits == capacity + 1, "Hits are counted");
+    result &= assertTrue(statistics.misses == 1, "Misses are counted");
+    result &= assertTrue(statistics.evictions == 1, "Evictions are counted");
+
+    // Every entry has been referenced now, so the clock clears them all and
+    // then evicts in insertion order.
+    for (i = capacity + 1; i < objectCount; ++i)
+        JSWeakObjectMapSet(context, map, &objects[i], objects[i]);
+    JSWeakObjectMapGetStatistics(context, map, &statistics);
+    result &= assertTrue(statistics.size == capacity, "The map stays within capacity");
+    result &= assertTrue(statistics.evictions == objectCount - capacity, "Each insertion past capacity evicts one entry");
+    for (i = objectCount - capacity; i < objectCount; ++i)
+        result &= assertTrue(JSWeakObjectMapGet(context, map, &objects[i]) == objects[i], "The newest entries are kept");
+
+    JSWeakObjectMapSetCapacity(context, map, 2);
+    JSWeakObjectMapGetStatistics(context, map, &statistics);
+    result &= assertTrue(statistics.size == 2, "Lowering the capacity evicts entries");
+    result &= assertTrue(statistics.evictions == objectCount - 2, "Entries evicted by lowering the capacity are counted");
+
+    for (i = 0; i < objectCount; ++i)
+        JSValueUnprotect(context, objects[i]);
+    JSGlobalContextRelease(context);
+    return result;
+}
+
+static void countStringBufferRelease(const JSChar* chars, void* context)
+{
+    UNUSED_PARAM(chars);
+    ++*(unsigned*)context;
+}
+
+static bool checkStringCreateWithCharactersNoCopy()
+{
+    enum { shortLength = 4, longLength = 64 };
+    bool result = true;
+    JSGlobalContextRef context = JSGlobalContextCreate(0);
+    JSChar shortChars[shortLength];
+    JSChar longChars[longLength];
+    unsigned shortReleaseCount = 0;
+    unsigned longReleaseCount = 0;
+    JSStringRef string;
+    JSStringRef copy;
+    JSValueRef values[2];
+    int i;
+
+    for (i = 0; i < shortLength; ++i)
+        shortChars[i] = 'a' + i;
+    for (i = 0; i < longLength; ++i)
+        longChars[i] = 'a' + i % 26;
+
+    // Strings too short to share their buffer copy it, and are done with it at once.
+    string = JSStringCreateWithCharactersNoCopy(shortChars, shortLength, countStringBufferRelease, &shortReleaseCount);
+    result &= assertTrue(shortReleaseCount == 1, "A short buffer is released as soon as it is copied");
+    result &= assertTrue(JSStringGetLength(string) == shortLength && !memcmp(JSStringGetCharactersPtr(string), shortChars, sizeof(shortChars)), "A short string holds a copy of its buffer");
+    JSStringRelease(string);
+    result &= assertTrue(shortReleaseCount == 1, "A short buffer is released once");
+
+    string = JSStringCreateWithCharactersNoCopy(longChars, longLength, countStringBufferRelease, &longReleaseCount);
+    result &= assertTrue(JSStringGetCharactersPtr(string) == longChars, "A long string uses its buffer in place");
+    for (i = 0; i < 2; ++i) {
+        values[i] = JSValueMakeString(context, string);
+        JSValueProtect(context, values[i]);
+    }
+    JSStringRelease(string);
+
+    copy = JSValueToStringCopy(context, values[0], 0);
+    result &= assertTrue(JSStringGetCharactersPtr(copy) == longChars, "Copying a string value back out shares its buffer");
+    JSStringRelease(copy);
+
+    JSGarbageCollect(context);
+    result &= assertTrue(!longReleaseCount, "A buffer is kept while string values use it");
+    JSValueUnprotect(context, values[0]);
+    JSGarbageCollect(context);
+    result &= assertTrue(!longReleaseCount, "A buffer is kept while any string value uses it");
+
+    // Releasing the context destroys the last string value.
+    JSValueUnprotect(context, values[1]);
+    JSGlobalContextRelease(context);
+    result &= assertTrue(longReleaseCount == 1, "A buffer is released once after the last string value using it dies");
+    return result;
+}
+
 int main(int argc, char* argv[])
 {
 #if OS(WINDOWS)
@@ -1429,6 +1575,29 @@ int main(int argc, char* argv[])
         failed = true;
     }
 
+#if ENABLE(DFG_JIT)
+    if (checkIntegerLoopIsOptimized())
+        printf("PASS: A hot integer loop is compiled by the DFG JIT.\n");
+    else {
+        printf("FAIL: A hot integer loop is not compiled by the DFG JIT.\n");
+        failed = true;
+    }
+#endif
+
+    if (checkWeakObjectMapCapacity())
+        printf("PASS: A bounded JSWeakObjectMap evicts unreferenced entries first and counts its statistics.\n");
+    else {
+        printf("FAIL: A bounded JSWeakObjectMap does not evict or count as expected.\n");
+        failed = true;
+    }
+
+    if (checkStringCreateWithCharactersNoCopy())
+        printf("PASS: JSStringCreateWithCharactersNoCopy releases its buffer once, after the last string using it.\n");
+    else {
+        printf("FAIL: JSStringCreateWithCharactersNoCopy does not release its buffer as expected.\n");
+        failed = true;
+    }
+
     if (failed) {
         printf("FAIL: Some tests failed.\n");
         return 1;
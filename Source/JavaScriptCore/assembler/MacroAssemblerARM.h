@@ -244,6 +244,12 @@ public:
         m_assembler.dataTransfer32(true, dest, address.base, address.offset, true);
     }
 
+    void load8(BaseIndex address, RegisterID dest)
+    {
+        m_assembler.add_r(ARMRegisters::S1, address.base, m_assembler.lsl(address.index, address.scale));
+        load8(Address(ARMRegisters::S1, address.offset), dest);
+    }
+
     void load32(ImplicitAddress address, RegisterID dest)
     {
         m_assembler.dataTransfer32(true, dest, address.base, address.offset);
@@ -45,6 +45,7 @@ public:
     using MacroAssemblerX86Common::and32;
     using MacroAssemblerX86Common::or32;
     using MacroAssemblerX86Common::sub32;
+    using MacroAssemblerX86Common::branchAdd32;
     using MacroAssemblerX86Common::load32;
     using MacroAssemblerX86Common::store32;
     using MacroAssemblerX86Common::call;
@@ -76,6 +77,12 @@ public:
         sub32(imm, Address(scratchRegister));
     }
 
+    Jump branchAdd32(Condition cond, TrustedImm32 imm, AbsoluteAddress address)
+    {
+        move(TrustedImmPtr(address.m_ptr), scratchRegister);
+        return branchAdd32(cond, imm, Address(scratchRegister));
+    }
+
     void load32(void* address, RegisterID dest)
     {
         if (dest == X86Registers::eax)
@@ -38,6 +38,7 @@
 #include "JSFunction.h"
 #include "JSStaticScopeObject.h"
 #include "JSValue.h"
+#include "RepatchBuffer.h"
 #include "UStringConcatenate.h"
 #include <stdio.h>
 #include <wtf/StringExtras.h>
@@ -270,6 +271,9 @@ static void printStructureStubInfo(const StructureStubInfo& stubInfo, unsigned i
     case access_get_string_length:
         printf("  [%4d] %s\n", instructionOffset, "op_get_string_length");
         return;
+    case access_get_by_id_megamorphic:
+        printf("  [%4d] %s: %s (%u hits, %u misses)\n", instructionOffset, "op_get_by_id_megamorphic", pointerToSourceString(stubInfo.u.getByIdMegamorphic.hotPathStructure).utf8().data(), stubInfo.u.getByIdMegamorphic.hits, stubInfo.u.getByIdMegamorphic.misses);
+        return;
     default:
         ASSERT_NOT_REACHED();
     }
@@ -1019,6 +1023,34 @@ void CodeBlock::dump(ExecState* exec, const Vector<Instruction>::const_iterator&
             printf("[%4d] jless\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
             break;
         }
+        case op_jeq: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jeq\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
+            break;
+        }
+        case op_jneq: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jneq\t\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
+            break;
+        }
+        case op_jstricteq: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jstricteq\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
+            break;
+        }
+        case op_jnstricteq: {
+            int r0 = (++it)->u.operand;
+            int r1 = (++it)->u.operand;
+            int offset = (++it)->u.operand;
+            printf("[%4d] jnstricteq\t %s, %s, %d(->%d)\n", location, registerName(exec, r0).data(), registerName(exec, r1).data(), offset, location + offset);
+            break;
+        }
         case op_jlesseq: {
             int r0 = (++it)->u.operand;
             int r1 = (++it)->u.operand;
@@ -1380,6 +1412,13 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
     , m_source(sourceProvider)
     , m_sourceOffset(sourceOffset)
     , m_symbolTable(symTab)
+#if ENABLE(JIT)
+    , m_wasExecuted(0)
+#endif
+#if ENABLE(DFG_JIT)
+    , m_isOSRExitTarget(false)
+    , m_executeCounter(0)
+#endif
 {
     ASSERT(m_source);
 
@@ -1456,6 +1495,15 @@ void EvalCodeCache::markAggregate(MarkStack& markStack)
         markStack.append(&ptr->second);
 }
 
+#if ENABLE(JIT)
+void EvalCodeCache::unlinkCallsToDiscardedCode()
+{
+    EvalCacheMap::iterator end = m_cacheMap.end();
+    for (EvalCacheMap::iterator ptr = m_cacheMap.begin(); ptr != end; ++ptr)
+        ptr->second->unlinkCallsToDiscardedCode();
+}
+#endif
+
 void CodeBlock::markAggregate(MarkStack& markStack)
 {
     markStack.append(&m_globalObject);
@@ -1494,6 +1542,10 @@ void CodeBlock::markAggregate(MarkStack& markStack)
         }
     }
 #endif
+#if ENABLE(DFG_JIT)
+    if (m_alternative)
+        m_alternative->markAggregate(markStack);
+#endif
 }
 
 HandlerInfo* CodeBlock::handlerForBytecodeOffset(unsigned bytecodeOffset)
@@ -1616,6 +1668,54 @@ bool CodeBlock::hasGlobalResolveInfoAtBytecodeOffset(unsigned bytecodeOffset)
         return false;
     return true;
 }
+
+bool CodeBlock::wasExecutedSinceLastCheck()
+{
+    bool wasExecuted = m_wasExecuted;
+    m_wasExecuted = 0;
+#if ENABLE(DFG_JIT)
+    // Optimized code may have exited to its baseline alternative.
+    if (m_alternative && m_alternative->wasExecutedSinceLastCheck())
+        wasExecuted = true;
+#endif
+    return wasExecuted;
+}
+
+void CodeBlock::unlinkOwnCallsToDiscardedCode()
+{
+    for (size_t i = 0; i < m_callLinkInfos.size(); ++i) {
+        CallLinkInfo& callLinkInfo = m_callLinkInfos[i];
+        if (!callLinkInfo.isLinked() || callLinkInfo.callee->executable()->isHostFunction())
+            continue;
+        FunctionExecutable* executable = callLinkInfo.callee->jsExecutable();
+        if (executable->isGeneratedForCall() || executable->isGeneratedForConstruct())
+            continue;
+
+        // Linking already pointed the slow path at the virtual call trampoline, so
+        // making the callee check fail is enough to stop using the stale code.
+        RepatchBuffer repatchBuffer(this);
+        repatchBuffer.repatch(callLinkInfo.hotPathBegin, 0);
+        callLinkInfo.setUnlinked();
+    }
+}
+
+void CodeBlock::unlinkCallsToDiscardedCode()
+{
+    unlinkOwnCallsToDiscardedCode();
+#if ENABLE(DFG_JIT)
+    if (m_alternative)
+        m_alternative->unlinkOwnCallsToDiscardedCode();
+#endif
+
+    // Nested functions may have compiled code even when none of their closures
+    // are currently alive, and will link against it again if one is created.
+    for (size_t i = 0; i < m_functionDecls.size(); ++i)
+        m_functionDecls[i]->unlinkCallsToDiscardedCode();
+    for (size_t i = 0; i < m_functionExprs.size(); ++i)
+        m_functionExprs[i]->unlinkCallsToDiscardedCode();
+    if (m_rareData)
+        m_rareData->m_evalCodeCache.unlinkCallsToDiscardedCode();
+}
 #endif
 
 void CodeBlock::shrinkToFit()
@@ -1631,6 +1731,9 @@ void CodeBlock::shrinkToFit()
     m_globalResolveInfos.shrinkToFit();
     m_callLinkInfos.shrinkToFit();
 #endif
+#if ENABLE(VALUE_PROFILER)
+    m_valueProfiles.shrinkToFit();
+#endif
 
     m_identifiers.shrinkToFit();
     m_functionDecls.shrinkToFit();
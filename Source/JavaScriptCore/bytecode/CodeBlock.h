@@ -176,6 +176,63 @@ namespace JSC {
         unsigned bytecodeOffset;
     };
 
+#if ENABLE(DFG_JIT)
+    // This structure is used to map from a bytecode index to the offset in
+    // bytes of the corresponding machine code in a baseline JIT CodeBlock.
+    // It is recorded for CodeBlocks that may be the target of an OSR exit.
+    struct BytecodeOffsetToMachineCodeOffset {
+        BytecodeOffsetToMachineCodeOffset(unsigned bytecodeOffset, unsigned machineCodeOffset)
+            : bytecodeOffset(bytecodeOffset)
+            , machineCodeOffset(machineCodeOffset)
+        {
+        }
+
+        unsigned bytecodeOffset;
+        unsigned machineCodeOffset;
+    };
+
+    // Describes how to recover the value of a single bytecode temporary
+    // when exiting from DFG JIT code to the baseline JIT. The value is
+    // either a constant, or is read from a register in the call frame.
+    struct OSRExitValue {
+        OSRExitValue(int operand, int virtualRegister)
+            : operand(operand)
+            , virtualRegister(virtualRegister)
+            , isConstant(false)
+            , constant(0)
+        {
+        }
+
+        OSRExitValue(int operand, EncodedJSValue constant)
+            : operand(operand)
+            , virtualRegister(0)
+            , isConstant(true)
+            , constant(constant)
+        {
+        }
+
+        int operand;
+        int virtualRegister;
+        bool isConstant;
+        EncodedJSValue constant;
+    };
+
+    // An OSR exit records the bytecode index at which execution resumes in
+    // the baseline JIT, and the range of OSRExitValues to recover.
+    struct OSRExit {
+        OSRExit(unsigned bytecodeOffset, unsigned firstValue, unsigned numberOfValues)
+            : bytecodeOffset(bytecodeOffset)
+            , firstValue(firstValue)
+            , numberOfValues(numberOfValues)
+        {
+        }
+
+        unsigned bytecodeOffset;
+        unsigned firstValue;
+        unsigned numberOfValues;
+    };
+#endif
+
     // valueAtPosition helpers for the binarySearch algorithm.
 
     inline void* getStructureStubInfoReturnLocation(StructureStubInfo* structureStubInfo)
@@ -197,6 +254,42 @@ namespace JSC {
     {
         return pc->callReturnOffset;
     }
+
+#if ENABLE(DFG_JIT)
+    inline unsigned getBytecodeOffset(BytecodeOffsetToMachineCodeOffset* mapping)
+    {
+        return mapping->bytecodeOffset;
+    }
+#endif
+#endif
+
+#if ENABLE(VALUE_PROFILER)
+    // A set of the types of JSValue that have been observed, as a bit mask.
+    typedef uint32_t PredictedType;
+    static const PredictedType PredictNone   = 0x0;
+    static const PredictedType PredictInt32  = 0x1;
+    static const PredictedType PredictDouble = 0x2;
+    static const PredictedType PredictCell   = 0x4;
+    static const PredictedType PredictOther  = 0x8; // undefined, null and booleans.
+    static const PredictedType PredictNumber = PredictInt32 | PredictDouble;
+
+    // Records the types of the values produced by a single bytecode
+    // instruction, as observed when running in the baseline JIT.
+    struct ValueProfile {
+        ValueProfile(unsigned bytecodeOffset)
+            : bytecodeOffset(bytecodeOffset)
+            , observedTypes(PredictNone)
+        {
+        }
+
+        unsigned bytecodeOffset;
+        PredictedType observedTypes;
+    };
+
+    inline unsigned getValueProfileBytecodeOffset(ValueProfile* valueProfile)
+    {
+        return valueProfile->bytecodeOffset;
+    }
 #endif
 
     class CodeBlock {
@@ -289,8 +382,69 @@ namespace JSC {
 #endif
 
 #if ENABLE(JIT)
-        JITCode& getJITCode() { return m_isConstructor ? ownerExecutable()->generatedJITCodeForConstruct() : ownerExecutable()->generatedJITCodeForCall(); }
+        JITCode& getJITCode() { return m_jitCode; }
+        void setJITCode(const JITCode& jitCode) { m_jitCode = jitCode; }
         ExecutablePool* executablePool() { return getJITCode().getExecutablePool(); }
+
+        // JIT code for a function sets this flag each time it is entered, so that
+        // JSGlobalData::releaseExecutableMemory() can tell code that has gone cold
+        // from code that is still in use.
+        int32_t* addressOfWasExecuted() { return &m_wasExecuted; }
+        bool wasExecutedSinceLastCheck();
+
+        // Undoes the linking of any call whose callee no longer has code, so that
+        // this code (and the code of the functions and eval code nested inside it)
+        // stops jumping straight into JIT code that has been thrown away.
+        void unlinkCallsToDiscardedCode();
+#endif
+
+#if ENABLE(DFG_JIT)
+        // A CodeBlock compiled by the DFG JIT owns a baseline JIT compiled
+        // CodeBlock for the same code, to which it may exit on speculation failure.
+        CodeBlock* alternative() { return m_alternative.get(); }
+        void setAlternative(PassOwnPtr<CodeBlock> alternative) { m_alternative = alternative; }
+
+        bool isOSRExitTarget() const { return m_isOSRExitTarget; }
+        void setIsOSRExitTarget() { m_isOSRExitTarget = true; }
+
+        Vector<BytecodeOffsetToMachineCodeOffset>& jitCodeMap() { return m_jitCodeMap; }
+        unsigned machineCodeOffsetForBytecodeOffset(unsigned bytecodeOffset)
+        {
+            ASSERT(m_isOSRExitTarget);
+            return binarySearch<BytecodeOffsetToMachineCodeOffset, unsigned, getBytecodeOffset>(m_jitCodeMap.begin(), m_jitCodeMap.size(), bytecodeOffset)->machineCodeOffset;
+        }
+
+        // Entry points into DFG JIT code at the heads of basic blocks, used to
+        // transfer execution from a loop running in the baseline JIT code.
+        Vector<BytecodeOffsetToMachineCodeOffset>& osrEntries() { return m_osrEntries; }
+        void* osrEntryForBytecodeOffset(unsigned bytecodeOffset)
+        {
+            for (size_t i = 0; i < m_osrEntries.size(); ++i) {
+                if (m_osrEntries[i].bytecodeOffset == bytecodeOffset)
+                    return static_cast<char*>(getJITCode().start()) + m_osrEntries[i].machineCodeOffset;
+            }
+            return 0;
+        }
+
+        unsigned addOSRExit(unsigned bytecodeOffset, unsigned firstValue, unsigned numberOfValues) { m_osrExits.append(OSRExit(bytecodeOffset, firstValue, numberOfValues)); return m_osrExits.size() - 1; }
+        OSRExit& osrExit(unsigned index) { return m_osrExits[index]; }
+        Vector<OSRExitValue>& osrExitValues() { return m_osrExitValues; }
+
+        // Baseline JIT code for a CodeBlock that is an OSR exit target counts function
+        // entries and loop back edges up from a negative threshold, and asks for the
+        // code to be recompiled by the DFG JIT once the count reaches zero.
+        int32_t* addressOfExecuteCounter() { return &m_executeCounter; }
+        void optimizeAfterWarmUp() { m_executeCounter = -1000; }
+        void optimizeNextInvocation() { m_executeCounter = -1; }
+        void dontOptimizeAnytimeSoon() { m_executeCounter = std::numeric_limits<int32_t>::min(); }
+#endif
+
+#if ENABLE(VALUE_PROFILER)
+        void addValueProfile(unsigned bytecodeOffset) { m_valueProfiles.append(ValueProfile(bytecodeOffset)); }
+        ValueProfile* valueProfileForBytecodeOffset(unsigned bytecodeOffset)
+        {
+            return binarySearch<ValueProfile, unsigned, getValueProfileBytecodeOffset>(m_valueProfiles.begin(), m_valueProfiles.size(), bytecodeOffset);
+        }
 #endif
 
         ScriptExecutable* ownerExecutable() const { return m_ownerExecutable.get(); }
@@ -482,6 +636,9 @@ namespace JSC {
         void printPutByIdOp(ExecState*, int location, Vector<Instruction>::const_iterator&, const char* op) const;
 #endif
         void markStructures(MarkStack&, Instruction* vPC) const;
+#if ENABLE(JIT)
+        void unlinkOwnCallsToDiscardedCode();
+#endif
 
         void createRareDataIfNecessary()
         {
@@ -520,6 +677,20 @@ namespace JSC {
         Vector<GlobalResolveInfo> m_globalResolveInfos;
         Vector<CallLinkInfo> m_callLinkInfos;
         Vector<MethodCallLinkInfo> m_methodCallLinkInfos;
+        JITCode m_jitCode;
+        int32_t m_wasExecuted;
+#endif
+#if ENABLE(DFG_JIT)
+        OwnPtr<CodeBlock> m_alternative;
+        bool m_isOSRExitTarget;
+        Vector<BytecodeOffsetToMachineCodeOffset> m_jitCodeMap;
+        Vector<BytecodeOffsetToMachineCodeOffset> m_osrEntries;
+        Vector<OSRExit> m_osrExits;
+        Vector<OSRExitValue> m_osrExitValues;
+        int32_t m_executeCounter;
+#endif
+#if ENABLE(VALUE_PROFILER)
+        Vector<ValueProfile> m_valueProfiles;
 #endif
 
         Vector<unsigned> m_jumpTargets;
@@ -68,6 +68,9 @@ namespace JSC {
         bool isEmpty() const { return m_cacheMap.isEmpty(); }
 
         void markAggregate(MarkStack&);
+#if ENABLE(JIT)
+        void unlinkCallsToDiscardedCode();
+#endif
 
     private:
         static const unsigned maxCacheableSourceLength = 256;
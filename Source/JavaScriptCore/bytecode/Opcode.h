@@ -148,6 +148,10 @@ namespace JSC {
         macro(op_jnlesseq, 4) \
         macro(op_jless, 4) \
         macro(op_jlesseq, 4) \
+        macro(op_jeq, 4) \
+        macro(op_jneq, 4) \
+        macro(op_jstricteq, 4) \
+        macro(op_jnstricteq, 4) \
         macro(op_jmp_scopes, 3) \
         macro(op_loop, 2) \
         macro(op_loop_if_true, 3) \
@@ -30,8 +30,13 @@
 #include "SamplingTool.h"
 
 #include "CodeBlock.h"
+#include "InternalFunction.h"
 #include "Interpreter.h"
+#include "JSFunction.h"
 #include "Opcode.h"
+#include "UStringBuilder.h"
+#include "UStringConcatenate.h"
+#include <algorithm>
 
 #if !OS(WINDOWS)
 #include <unistd.h>
@@ -156,6 +161,172 @@ void SamplingThread::stop()
     waitForThreadCompletion(s_samplingThread, 0);
 }
 
+SamplingProfiler::SamplingProfiler(JSGlobalData& globalData)
+    : m_globalData(globalData)
+    , m_sampleRequested(0)
+    , m_running(false)
+    , m_intervalInMicroseconds(0)
+    , m_samplingThread(0)
+    , m_sampleCount(0)
+{
+}
+
+SamplingProfiler::~SamplingProfiler()
+{
+    stop();
+}
+
+void SamplingProfiler::start(unsigned intervalInMicroseconds)
+{
+    if (m_running)
+        return;
+
+    m_intervalInMicroseconds = intervalInMicroseconds;
+    m_running = true;
+    m_samplingThread = createThread(threadStartFunc, this, "JavaScriptCore::SamplingProfiler");
+}
+
+void SamplingProfiler::stop()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    waitForThreadCompletion(m_samplingThread, 0);
+    m_sampleRequested = 0;
+}
+
+void* SamplingProfiler::threadStartFunc(void* profiler)
+{
+    static_cast<SamplingProfiler*>(profiler)->run();
+    return 0;
+}
+
+void SamplingProfiler::run()
+{
+    while (m_running) {
+        sleepForMicroseconds(m_intervalInMicroseconds);
+        m_sampleRequested = 1;
+    }
+}
+
+static const char* tierName(JSGlobalData& globalData, CodeBlock* codeBlock)
+{
+#if ENABLE(INTERPRETER)
+    if (!globalData.canUseJIT())
+        return "interpreter";
+#else
+    UNUSED_PARAM(globalData);
+#endif
+#if ENABLE(DFG_JIT)
+    if (codeBlock->alternative())
+        return "dfg";
+#else
+    UNUSED_PARAM(codeBlock);
+#endif
+    return "baseline";
+}
+
+static UString functionName(ExecState* exec, CallFrame* callFrame, CodeBlock* codeBlock)
+{
+    if (codeBlock) {
+        if (codeBlock->codeType() == GlobalCode)
+            return "(program)";
+        if (codeBlock->codeType() == EvalCode)
+            return "(eval)";
+    }
+
+    JSObject* callee = callFrame->callee();
+    UString name;
+    if (callee->inherits(&JSFunction::s_info))
+        name = asFunction(callee)->calculatedDisplayName(exec);
+    else if (callee->inherits(&InternalFunction::s_info))
+        name = static_cast<InternalFunction*>(callee)->calculatedDisplayName(exec);
+    return name.isEmpty() ? "(anonymous function)" : name;
+}
+
+// Returns the line of the call in callerCodeBlock that created callFrame.
+static int callerLineNumber(CallFrame* callFrame, CodeBlock* callerCodeBlock)
+{
+    unsigned bytecodeOffset = 0;
+#if ENABLE(INTERPRETER)
+    if (!callFrame->globalData().canUseJIT())
+        bytecodeOffset = callerCodeBlock->bytecodeOffset(callFrame->returnVPC());
+#if ENABLE(JIT)
+    else
+        bytecodeOffset = callerCodeBlock->bytecodeOffset(callFrame->returnPC());
+#endif
+#else
+    bytecodeOffset = callerCodeBlock->bytecodeOffset(callFrame->returnPC());
+#endif
+    return callerCodeBlock->lineNumberForBytecodeOffset(bytecodeOffset - 1);
+}
+
+void SamplingProfiler::takeSample(ExecState* exec, unsigned bytecodeOffset)
+{
+    m_sampleRequested = 0;
+
+    // Collect the frames innermost first. Host frames have no CodeBlock, and the
+    // frames that begin each entry into the VM have no callee either.
+    Vector<UString, 16> frames;
+    int lineNumber = exec->codeBlock() ? exec->codeBlock()->lineNumberForBytecodeOffset(bytecodeOffset) : -1;
+    for (CallFrame* callFrame = exec; callFrame; ) {
+        CodeBlock* codeBlock = callFrame->codeBlock();
+        if (codeBlock) {
+            frames.append(makeUString(functionName(exec, callFrame, codeBlock), " (", codeBlock->ownerExecutable()->sourceURL(), ":",
+                UString::number(lineNumber), ") [", tierName(m_globalData, codeBlock), "]"));
+        } else if (callFrame->callee())
+            frames.append(makeUString(functionName(exec, callFrame, 0), " [host]"));
+
+        CallFrame* callerFrame = callFrame->callerFrame();
+        if (callerFrame->hasHostCallFrameFlag()) {
+            callFrame = callerFrame->removeHostCallFrameFlag();
+            lineNumber = -1;
+            continue;
+        }
+        if (CodeBlock* callerCodeBlock = callerFrame->codeBlock())
+            lineNumber = callerLineNumber(callFrame, callerCodeBlock);
+        callFrame = callerFrame;
+    }
+
+    if (frames.isEmpty())
+        return;
+
+    UStringBuilder stack;
+    for (size_t i = frames.size(); i--; ) {
+        stack.append(frames[i]);
+        if (i)
+            stack.append(';');
+    }
+
+    ++m_sampleCount;
+    std::pair<StackCountMap::iterator, bool> result = m_stackCounts.add(stack.toUString().impl(), 0);
+    ++result.first->second;
+}
+
+void SamplingProfiler::clear()
+{
+    m_stackCounts.clear();
+    m_sampleCount = 0;
+}
+
+UString SamplingProfiler::collapsedStacks() const
+{
+    Vector<UString> stacks;
+    StackCountMap::const_iterator end = m_stackCounts.end();
+    for (StackCountMap::const_iterator it = m_stackCounts.begin(); it != end; ++it)
+        stacks.append(it->first);
+    std::sort(stacks.begin(), stacks.end());
+
+    UStringBuilder builder;
+    for (size_t i = 0; i < stacks.size(); ++i) {
+        builder.append(stacks[i]);
+        builder.append(' ');
+        builder.append(UString::number(m_stackCounts.get(stacks[i].impl())));
+        builder.append('\n');
+    }
+    return builder.toUString();
+}
 
 void ScriptSampleRecord::sample(CodeBlock* codeBlock, Instruction* vPC)
 {
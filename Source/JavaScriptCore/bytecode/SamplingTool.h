@@ -90,6 +90,7 @@ namespace JSC {
 
     class CodeBlock;
     class ExecState;
+    class JSGlobalData;
     class Interpreter;
     class ScopeNode;
     struct Instruction;
@@ -275,6 +276,56 @@ namespace JSC {
 #endif
     };
 
+    // SamplingProfiler:
+    //
+    // A statistical profiler cheap enough to leave running on real workloads. A timer
+    // thread asks for a sample at a fixed interval, and the JavaScript thread takes it
+    // at its next safepoint (a function entry or loop back edge), walking the CallFrames
+    // to attribute the sample to each function on the stack, the line it was at, and
+    // the tier of the code running it. The JIT only plants safepoints in code compiled
+    // while the profiler is running, so starting it recompiles all functions.
+    //
+    // Time spent in host code is charged to the next safepoint reached after it.
+    class SamplingProfiler {
+        WTF_MAKE_NONCOPYABLE(SamplingProfiler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        SamplingProfiler(JSGlobalData&);
+        ~SamplingProfiler();
+
+        void start(unsigned intervalInMicroseconds = 1000);
+        void stop();
+        bool isRunning() const { return m_running; }
+
+        bool sampleRequested() const { return m_sampleRequested; }
+        int32_t* addressOfSampleRequested() { return const_cast<int32_t*>(&m_sampleRequested); }
+        void takeSample(ExecState*, unsigned bytecodeOffset);
+
+        unsigned sampleCount() const { return m_sampleCount; }
+        void clear();
+
+        // One line per distinct stack, outermost frame first, with frames separated by
+        // ';' and followed by the number of samples: the "collapsed stack" format read
+        // by flame graph tools.
+        UString collapsedStacks() const;
+
+    private:
+        static void* threadStartFunc(void*);
+        void run();
+
+        JSGlobalData& m_globalData;
+
+        // State shared with the sampling thread.
+        volatile int32_t m_sampleRequested;
+        volatile bool m_running;
+        unsigned m_intervalInMicroseconds;
+        ThreadIdentifier m_samplingThread;
+
+        // Gathered sample data.
+        typedef HashMap<RefPtr<StringImpl>, unsigned> StackCountMap;
+        StackCountMap m_stackCounts;
+        unsigned m_sampleCount;
+    };
+
     // AbstractSamplingCounter:
     //
     // Implements a named set of counters, printed on exit if ENABLE(SAMPLING_COUNTERS).
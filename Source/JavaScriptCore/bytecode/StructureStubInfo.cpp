@@ -56,6 +56,7 @@ void StructureStubInfo::deref()
     case access_put_by_id_generic:
     case access_get_array_length:
     case access_get_string_length:
+    case access_get_by_id_megamorphic:
         // These instructions don't have to release any allocated memory
         return;
     default:
@@ -95,6 +96,10 @@ void StructureStubInfo::markAggregate(MarkStack& markStack)
     case access_put_by_id_replace:
         markStack.append(&u.putByIdReplace.baseObjectStructure);
         return;
+    case access_get_by_id_megamorphic:
+        if (u.getByIdMegamorphic.hotPathStructure)
+            markStack.append(&u.getByIdMegamorphic.hotPathStructure);
+        return;
     case access_get_by_id:
     case access_put_by_id:
     case access_get_by_id_generic:
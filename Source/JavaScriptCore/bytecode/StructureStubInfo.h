@@ -49,6 +49,7 @@ namespace JSC {
         access_put_by_id_generic,
         access_get_array_length,
         access_get_string_length,
+        access_get_by_id_megamorphic,
     };
 
     struct StructureStubInfo {
@@ -97,6 +98,18 @@ namespace JSC {
             u.getByIdProtoList.listSize = listSize;
         }
 
+        void initGetByIdMegamorphic(JSGlobalData& globalData, JSCell* owner, Structure* hotPathStructure)
+        {
+            accessType = access_get_by_id_megamorphic;
+
+            if (hotPathStructure)
+                u.getByIdMegamorphic.hotPathStructure.set(globalData, owner, hotPathStructure);
+            else
+                u.getByIdMegamorphic.hotPathStructure.clear();
+            u.getByIdMegamorphic.hits = 0;
+            u.getByIdMegamorphic.misses = 0;
+        }
+
         // PutById*
 
         void initPutByIdTransition(JSGlobalData& globalData, JSCell* owner, Structure* previousStructure, Structure* structure, StructureChain* chain)
@@ -151,6 +164,14 @@ namespace JSC {
                 PolymorphicAccessStructureList* structureList;
                 int listSize;
             } getByIdProtoList;
+            struct {
+                // The Structure still patched into the inline check, if any.
+                WriteBarrierBase<Structure> hotPathStructure;
+                // Probes of the shared cache that found the property, and
+                // calls to cti_op_get_by_id_megamorphic.
+                unsigned hits;
+                unsigned misses;
+            } getByIdMegamorphic;
             struct {
                 WriteBarrierBase<Structure> previousStructure;
                 WriteBarrierBase<Structure> structure;
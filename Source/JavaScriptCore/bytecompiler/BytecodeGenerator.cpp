@@ -714,6 +714,16 @@ void BytecodeGenerator::emitOpcode(OpcodeID opcodeID)
     m_lastOpcodeID = opcodeID;
 }
 
+void BytecodeGenerator::emitProfiledOpcode(OpcodeID opcodeID)
+{
+#if ENABLE(VALUE_PROFILER)
+    // Only function code is compiled by the DFG JIT, so only it needs profiling.
+    if (m_codeType == FunctionCode)
+        m_codeBlock->addValueProfile(instructions().size());
+#endif
+    emitOpcode(opcodeID);
+}
+
 void BytecodeGenerator::retrieveLastBinaryOp(int& dstIndex, int& src1Index, int& src2Index)
 {
     ASSERT(instructions().size() >= 4);
@@ -753,6 +763,51 @@ PassRefPtr<Label> BytecodeGenerator::emitJump(Label* target)
     return target;
 }
 
+// The interpreter runs an equality test and the branch on its result as a
+// single instruction. The JIT does not compile these, so they are only used in
+// code for the interpreter.
+bool BytecodeGenerator::emitEqualityJump(RegisterID* cond, Label* target, bool jumpIfTrue)
+{
+    if (m_globalData->canUseJIT() || !target->isForward())
+        return false;
+
+    OpcodeID opcodeID;
+    switch (m_lastOpcodeID) {
+    case op_eq:
+        opcodeID = jumpIfTrue ? op_jeq : op_jneq;
+        break;
+    case op_neq:
+        opcodeID = jumpIfTrue ? op_jneq : op_jeq;
+        break;
+    case op_stricteq:
+        opcodeID = jumpIfTrue ? op_jstricteq : op_jnstricteq;
+        break;
+    case op_nstricteq:
+        opcodeID = jumpIfTrue ? op_jnstricteq : op_jstricteq;
+        break;
+    default:
+        return false;
+    }
+
+    int dstIndex;
+    int src1Index;
+    int src2Index;
+
+    retrieveLastBinaryOp(dstIndex, src1Index, src2Index);
+
+    if (cond->index() != dstIndex || !cond->isTemporary() || cond->refCount())
+        return false;
+
+    rewindBinaryOp();
+
+    size_t begin = instructions().size();
+    emitOpcode(opcodeID);
+    instructions().append(src1Index);
+    instructions().append(src2Index);
+    instructions().append(target->bind(begin, instructions().size()));
+    return true;
+}
+
 PassRefPtr<Label> BytecodeGenerator::emitJumpIfTrue(RegisterID* cond, Label* target)
 {
     if (m_lastOpcodeID == op_less) {
@@ -821,6 +876,9 @@ PassRefPtr<Label> BytecodeGenerator::emitJumpIfTrue(RegisterID* cond, Label* tar
         }
     }
 
+    if (emitEqualityJump(cond, target, true))
+        return target;
+
     size_t begin = instructions().size();
 
     emitOpcode(target->isForward() ? op_jtrue : op_loop_if_true);
@@ -912,6 +970,9 @@ PassRefPtr<Label> BytecodeGenerator::emitJumpIfFalse(RegisterID* cond, Label* ta
         }
     }
 
+    if (emitEqualityJump(cond, target, false))
+        return target;
+
     size_t begin = instructions().size();
     emitOpcode(target->isForward() ? op_jfalse : op_loop_if_false);
     instructions().append(cond->index());
@@ -1019,7 +1080,10 @@ RegisterID* BytecodeGenerator::emitPostDec(RegisterID* dst, RegisterID* srcDst)
 
 RegisterID* BytecodeGenerator::emitBinaryOp(OpcodeID opcodeID, RegisterID* dst, RegisterID* src1, RegisterID* src2, OperandTypes types)
 {
-    emitOpcode(opcodeID);
+    if (opcodeID == op_add || opcodeID == op_mul || opcodeID == op_sub)
+        emitProfiledOpcode(opcodeID);
+    else
+        emitOpcode(opcodeID);
     instructions().append(dst->index());
     instructions().append(src1->index());
     instructions().append(src2->index());
@@ -1391,7 +1455,7 @@ RegisterID* BytecodeGenerator::emitGetById(RegisterID* dst, RegisterID* base, co
     m_codeBlock->addPropertyAccessInstruction(instructions().size());
 #endif
 
-    emitOpcode(op_get_by_id);
+    emitProfiledOpcode(op_get_by_id);
     instructions().append(dst->index());
     instructions().append(base->index());
     instructions().append(addConstant(property));
@@ -1504,7 +1568,7 @@ RegisterID* BytecodeGenerator::emitGetByVal(RegisterID* dst, RegisterID* base, R
             return dst;
         }
     }
-    emitOpcode(op_get_by_val);
+    emitProfiledOpcode(op_get_by_val);
     instructions().append(dst->index());
     instructions().append(base->index());
     instructions().append(property->index());
@@ -1679,7 +1743,7 @@ RegisterID* BytecodeGenerator::emitCall(OpcodeID opcodeID, RegisterID* dst, Regi
     instructions().append(callArguments.count()); // argCount
     instructions().append(callArguments.callFrame()); // registerOffset
     if (dst != ignoredResult()) {
-        emitOpcode(op_call_put_result);
+        emitProfiledOpcode(op_call_put_result);
         instructions().append(dst->index()); // dst
     }
 
@@ -1719,7 +1783,7 @@ RegisterID* BytecodeGenerator::emitCallVarargs(RegisterID* dst, RegisterID* func
     instructions().append(argCountRegister->index()); // arg count
     instructions().append(thisRegister->index() + RegisterFile::CallFrameHeaderSize); // initial registerOffset
     if (dst != ignoredResult()) {
-        emitOpcode(op_call_put_result);
+        emitProfiledOpcode(op_call_put_result);
         instructions().append(dst->index()); // dst
     }
     if (m_shouldEmitProfileHooks) {
@@ -1795,7 +1859,7 @@ RegisterID* BytecodeGenerator::emitConstruct(RegisterID* dst, RegisterID* func,
     instructions().append(callArguments.count()); // argCount
     instructions().append(callArguments.callFrame()); // registerOffset
     if (dst != ignoredResult()) {
-        emitOpcode(op_call_put_result);
+        emitProfiledOpcode(op_call_put_result);
         instructions().append(dst->index()); // dst
     }
 
@@ -402,10 +402,12 @@ namespace JSC {
 
     private:
         void emitOpcode(OpcodeID);
+        void emitProfiledOpcode(OpcodeID);
         void retrieveLastBinaryOp(int& dstIndex, int& src1Index, int& src2Index);
         void retrieveLastUnaryOp(int& dstIndex, int& srcIndex);
         ALWAYS_INLINE void rewindBinaryOp();
         ALWAYS_INLINE void rewindUnaryOp();
+        bool emitEqualityJump(RegisterID* cond, Label* target, bool jumpIfTrue);
 
         PassRefPtr<Label> emitComplexJumpScopes(Label* target, ControlFlowContext* topScope, ControlFlowContext* bottomScope);
 
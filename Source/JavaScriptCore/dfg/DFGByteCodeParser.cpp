@@ -37,8 +37,12 @@ namespace JSC { namespace DFG {
 #if ENABLE(DFG_JIT_RESTRICTIONS)
 // FIXME: Temporarily disable arithmetic, until we fix associated performance regressions.
 #define ARITHMETIC_OP() m_parseFailed = true
+// The regressions come from speculation checks that fail. add, sub and mul are
+// value profiled, so allow those the baseline JIT has only seen produce int32s.
+#define PROFILED_ARITHMETIC_OP() do { if (!profiledAsInt32()) m_parseFailed = true; } while (0)
 #else
 #define ARITHMETIC_OP() ((void)0)
+#define PROFILED_ARITHMETIC_OP() ((void)0)
 #endif
 
 // === ByteCodeParser ===
@@ -46,9 +50,10 @@ namespace JSC { namespace DFG {
 // This class is used to compile the dataflow graph from a CodeBlock.
 class ByteCodeParser {
 public:
-    ByteCodeParser(JSGlobalData* globalData, CodeBlock* codeBlock, Graph& graph)
+    ByteCodeParser(JSGlobalData* globalData, CodeBlock* codeBlock, CodeBlock* profiledBlock, Graph& graph)
         : m_globalData(globalData)
         , m_codeBlock(codeBlock)
+        , m_profiledBlock(profiledBlock)
         , m_graph(graph)
         , m_currentIndex(0)
         , m_parseFailed(false)
@@ -59,6 +64,10 @@ public:
         , m_arguments(codeBlock->m_numParameters)
         , m_variables(codeBlock->m_numVars)
         , m_temporaries(codeBlock->m_numCalleeRegisters - codeBlock->m_numVars)
+        , m_callLinkInfoIndex(0)
+        , m_globalResolveInfoIndex(0)
+        , m_maxArgumentCount(0)
+        , m_lastCall(NoNode)
     {
         for (unsigned i = 0; i < m_temporaries.size(); ++i)
             m_temporaries[i] = NoNode;
@@ -135,16 +144,26 @@ private:
     {
         NodeIndex priorSet = m_variables[operand].set;
         m_variables[operand].set = addToGraph(SetLocal, OpInfo(operand), value);
+#if DFG_OSR_EXIT
+        // The baseline JIT reads variables from the register file, so every store must
+        // be performed in case we exit before the next one.
+        UNUSED_PARAM(priorSet);
+#else
         if (priorSet != NoNode)
             m_graph.deref(priorSet);
+#endif
     }
 
     // Used in implementing get/set, above, where the operand is a temporary.
     NodeIndex getTemporary(unsigned operand)
     {
         NodeIndex index = m_temporaries[operand];
-        if (index != NoNode)
+        if (index != NoNode) {
+#if DFG_OSR_EXIT
+            m_temporariesRead.append(index);
+#endif
             return index;
+        }
         
         // Detect a read of an temporary that is not a yet defined within this block (e.g. use of ?:).
         m_parseFailed = true;
@@ -180,8 +199,61 @@ private:
 
         NodeIndex priorSet = m_arguments[argument].set;
         m_arguments[argument].set = addToGraph(SetLocal, OpInfo(operand), value);
+#if DFG_OSR_EXIT
+        UNUSED_PARAM(priorSet);
+#else
         if (priorSet != NoNode)
             m_graph.deref(priorSet);
+#endif
+    }
+
+#if DFG_OSR_EXIT
+    // If a speculation check fails part way through an instruction, the baseline JIT
+    // will reexecute the instruction from the start, so any temporaries it reads must
+    // remain available until all of its nodes have been generated.
+    void keepTemporariesAlive()
+    {
+        for (unsigned i = 0; i < m_temporariesRead.size(); ++i) {
+            NodeIndex index = m_temporariesRead[i];
+            if (!m_graph[index].isConstant())
+                addToGraph(Phantom, index);
+        }
+        m_temporariesRead.clear();
+    }
+
+    // Record the nodes holding the values of the temporaries at the start of the
+    // current instruction; these are written back to the register file on exit.
+    void recordTemporaries()
+    {
+        unsigned begin = m_graph.m_temporaryStates.size();
+        unsigned numVariables = m_variables.size();
+        for (unsigned i = 0; i < m_temporaries.size(); ++i) {
+            if (m_temporaries[i] != NoNode)
+                m_graph.m_temporaryStates.append(TemporaryState(i + numVariables, m_temporaries[i]));
+        }
+        m_graph.m_instructionStates.append(InstructionState(m_currentIndex, begin, m_graph.m_temporaryStates.size()));
+    }
+#endif
+
+    // Add nodes to store the arguments of a call or construct into the callee's
+    // frame, followed by the call itself. The frame is placed after all of the
+    // registers used by this function, once these are known (see parse()).
+    NodeIndex addCall(Instruction* currentInstruction, NodeType op)
+    {
+        NodeIndex callee = get(currentInstruction[1].u.operand);
+        int argCount = currentInstruction[2].u.operand;
+        int registerOffset = currentInstruction[3].u.operand;
+
+        int firstArgument = registerOffset - RegisterFile::CallFrameHeaderSize - argCount;
+        // The 'this' register for a construct is not written by the caller.
+        for (int i = op == Construct ? 1 : 0; i < argCount; ++i)
+            addToGraph(SetCallArgument, OpInfo(static_cast<unsigned>(i - argCount - RegisterFile::CallFrameHeaderSize)), get(firstArgument + i));
+
+        if (static_cast<unsigned>(argCount) > m_maxArgumentCount)
+            m_maxArgumentCount = argCount;
+
+        m_lastCall = addToGraph(op, OpInfo(argCount), OpInfo(m_callLinkInfoIndex++), callee);
+        return m_lastCall;
     }
 
     // Get an operand, and perform a ToInt32/ToNumber conversion on it.
@@ -431,6 +503,10 @@ private:
     // 'mustGenerate' then the node  will implicitly be ref'ed to ensure generation.
     NodeIndex addToGraph(NodeType op, NodeIndex child1 = NoNode, NodeIndex child2 = NoNode, NodeIndex child3 = NoNode)
     {
+#if DFG_OSR_EXIT
+        if (op == Return)
+            keepTemporariesAlive();
+#endif
         NodeIndex resultIndex = (NodeIndex)m_graph.size();
         m_graph.append(Node(op, m_currentIndex, child1, child2, child3));
 
@@ -440,6 +516,10 @@ private:
     }
     NodeIndex addToGraph(NodeType op, OpInfo info, NodeIndex child1 = NoNode, NodeIndex child2 = NoNode, NodeIndex child3 = NoNode)
     {
+#if DFG_OSR_EXIT
+        if (op & NodeIsJump)
+            keepTemporariesAlive();
+#endif
         NodeIndex resultIndex = (NodeIndex)m_graph.size();
         m_graph.append(Node(op, m_currentIndex, info, child1, child2, child3));
 
@@ -449,6 +529,10 @@ private:
     }
     NodeIndex addToGraph(NodeType op, OpInfo info1, OpInfo info2, NodeIndex child1 = NoNode, NodeIndex child2 = NoNode, NodeIndex child3 = NoNode)
     {
+#if DFG_OSR_EXIT
+        if (op & NodeIsBranch)
+            keepTemporariesAlive();
+#endif
         NodeIndex resultIndex = (NodeIndex)m_graph.size();
         m_graph.append(Node(op, m_currentIndex, info1, info2, child1, child2, child3));
 
@@ -457,8 +541,24 @@ private:
         return resultIndex;
     }
 
+    // Annotate a node with the types of value observed by the baseline JIT
+    // for the current bytecode instruction.
+    NodeIndex predict(NodeIndex nodeIndex)
+    {
+        m_graph[nodeIndex].prediction = m_profiledBlock->valueProfileForBytecodeOffset(m_currentIndex)->observedTypes;
+        return nodeIndex;
+    }
+
+    // True if the baseline JIT ran the current bytecode instruction and only
+    // ever saw it produce int32s, so integer speculation on it will hold.
+    bool profiledAsInt32()
+    {
+        return m_profiledBlock->valueProfileForBytecodeOffset(m_currentIndex)->observedTypes == PredictInt32;
+    }
+
     JSGlobalData* m_globalData;
     CodeBlock* m_codeBlock;
+    CodeBlock* m_profiledBlock;
     Graph& m_graph;
 
     // The bytecode index of the current instruction being generated.
@@ -516,6 +616,21 @@ private:
     typedef HashMap<NodeIndex, NodeIndex> UnaryOpMap;
     UnaryOpMap m_int32ToNumberNodes;
     UnaryOpMap m_numberToInt32Nodes;
+
+    // These track the indices of the CodeBlock's CallLinkInfo and GlobalResolveInfo
+    // structures, which are allocated in bytecode order.
+    unsigned m_callLinkInfoIndex;
+    unsigned m_globalResolveInfoIndex;
+
+    // The largest number of arguments passed by any call, used to size the call frame.
+    unsigned m_maxArgumentCount;
+    // The most recent call, whose result is read by op_call_put_result.
+    NodeIndex m_lastCall;
+
+#if DFG_OSR_EXIT
+    // The temporaries read by the current instruction.
+    Vector<NodeIndex, 8> m_temporariesRead;
+#endif
 };
 
 #define NEXT_OPCODE(name) \
@@ -545,12 +660,20 @@ bool ByteCodeParser::parseBlock(unsigned limit)
     Interpreter* interpreter = m_globalData->interpreter;
     Instruction* instructionsBegin = m_codeBlock->instructions().begin();
     while (true) {
+#if DFG_OSR_EXIT
+        keepTemporariesAlive();
+#endif
+
         // Don't extend over jump destinations.
         if (m_currentIndex == limit) {
             addToGraph(Jump, OpInfo(m_currentIndex));
             return !m_parseFailed;
         }
 
+#if DFG_OSR_EXIT
+        recordTemporaries();
+#endif
+
         // Switch on the current bytecode opcode.
         Instruction* currentInstruction = instructionsBegin + m_currentIndex;
         switch (interpreter->getOpcodeID(currentInstruction->u.opcode)) {
@@ -682,31 +805,31 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         // === Arithmetic operations ===
 
         case op_add: {
-            ARITHMETIC_OP();
+            PROFILED_ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
             NodeIndex op2 = get(currentInstruction[3].u.operand);
             // If both operands can statically be determined to the numbers, then this is an arithmetic add.
             // Otherwise, we must assume this may be performing a concatenation to a string.
             if (m_graph[op1].hasNumericResult() && m_graph[op2].hasNumericResult())
-                set(currentInstruction[1].u.operand, addToGraph(ArithAdd, toNumber(op1), toNumber(op2)));
+                set(currentInstruction[1].u.operand, predict(addToGraph(ArithAdd, toNumber(op1), toNumber(op2))));
             else
-                set(currentInstruction[1].u.operand, addToGraph(ValueAdd, op1, op2));
+                set(currentInstruction[1].u.operand, predict(addToGraph(ValueAdd, op1, op2)));
             NEXT_OPCODE(op_add);
         }
 
         case op_sub: {
-            ARITHMETIC_OP();
+            PROFILED_ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
-            set(currentInstruction[1].u.operand, addToGraph(ArithSub, op1, op2));
+            set(currentInstruction[1].u.operand, predict(addToGraph(ArithSub, op1, op2)));
             NEXT_OPCODE(op_sub);
         }
 
         case op_mul: {
-            ARITHMETIC_OP();
+            PROFILED_ARITHMETIC_OP();
             NodeIndex op1 = getToNumber(currentInstruction[2].u.operand);
             NodeIndex op2 = getToNumber(currentInstruction[3].u.operand);
-            set(currentInstruction[1].u.operand, addToGraph(ArithMul, op1, op2));
+            set(currentInstruction[1].u.operand, predict(addToGraph(ArithMul, op1, op2)));
             NEXT_OPCODE(op_mul);
         }
 
@@ -809,7 +932,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             NodeIndex base = get(currentInstruction[2].u.operand);
             NodeIndex property = get(currentInstruction[3].u.operand);
 
-            NodeIndex getByVal = addToGraph(GetByVal, base, property, aliases.lookupGetByVal(base, property));
+            NodeIndex getByVal = predict(addToGraph(GetByVal, base, property, aliases.lookupGetByVal(base, property)));
             set(currentInstruction[1].u.operand, getByVal);
             aliases.recordGetByVal(getByVal);
 
@@ -832,7 +955,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             NodeIndex base = get(currentInstruction[2].u.operand);
             unsigned identifier = currentInstruction[3].u.operand;
 
-            NodeIndex getById = addToGraph(GetById, OpInfo(identifier), base);
+            NodeIndex getById = predict(addToGraph(GetById, OpInfo(identifier), base));
             set(currentInstruction[1].u.operand, getById);
             aliases.recordGetById(getById);
 
@@ -868,6 +991,65 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             NEXT_OPCODE(op_put_global_var);
         }
 
+        case op_get_scoped_var: {
+            // Variables captured in an activation are not supported yet.
+            if (m_codeBlock->needsFullScopeChain())
+                return false;
+            NodeIndex getScopedVar = addToGraph(GetScopedVar, OpInfo(currentInstruction[2].u.operand), OpInfo(currentInstruction[3].u.operand));
+            set(currentInstruction[1].u.operand, getScopedVar);
+            NEXT_OPCODE(op_get_scoped_var);
+        }
+
+        case op_put_scoped_var: {
+            if (m_codeBlock->needsFullScopeChain())
+                return false;
+            NodeIndex value = get(currentInstruction[3].u.operand);
+            addToGraph(PutScopedVar, OpInfo(currentInstruction[1].u.operand), OpInfo(currentInstruction[2].u.operand), value);
+            NEXT_OPCODE(op_put_scoped_var);
+        }
+
+        case op_resolve_global: {
+            NodeIndex resolveGlobal = addToGraph(ResolveGlobal, OpInfo(currentInstruction[2].u.operand), OpInfo(m_globalResolveInfoIndex++));
+            set(currentInstruction[1].u.operand, resolveGlobal);
+            NEXT_OPCODE(op_resolve_global);
+        }
+
+        // === Calls ===
+
+        case op_call: {
+#if !DFG_OSR_EXIT
+            // Each call site has a single CallLinkInfo, so we cannot generate
+            // calls on both the speculative and non-speculative paths.
+            return false;
+#endif
+            addCall(currentInstruction, Call);
+            NEXT_OPCODE(op_call);
+        }
+
+        case op_construct: {
+#if !DFG_OSR_EXIT
+            return false;
+#endif
+            addCall(currentInstruction, Construct);
+            NEXT_OPCODE(op_construct);
+        }
+
+        case op_call_put_result: {
+            ASSERT(m_lastCall != NoNode);
+            set(currentInstruction[1].u.operand, predict(m_lastCall));
+            NEXT_OPCODE(op_call_put_result);
+        }
+
+        case op_method_check:
+            // The following op_get_by_id is generated as a normal property access.
+            NEXT_OPCODE(op_method_check);
+
+        case op_new_func_exp: {
+            NodeIndex function = addToGraph(NewFunctionExpression, OpInfo(currentInstruction[2].u.operand));
+            set(currentInstruction[1].u.operand, function);
+            NEXT_OPCODE(op_new_func_exp);
+        }
+
         // === Block terminators. ===
 
         case op_jmp: {
@@ -983,6 +1165,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
         case op_ret: {
             addToGraph(Return, get(currentInstruction[1].u.operand));
 
+#if !DFG_OSR_EXIT
             // FIXME: throw away terminal definitions of variables;
             // should not be necessary once we have proper DCE!
             for (unsigned i = 0; i < m_variables.size(); ++i) {
@@ -990,6 +1173,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
                 if (priorSet != NoNode)
                     m_graph.deref(priorSet);
             }
+#endif
 
             LAST_OPCODE(op_ret);
         }
@@ -1055,6 +1239,14 @@ bool ByteCodeParser::parse()
     // for the function (and checked for on entry). Since we perform a new and
     // different allocation of temporaries, more registers may now be required.
     unsigned calleeRegisters = scoreBoard.allocatedCount() + m_variables.size();
+
+    // Calls are made with the callee's frame placed after all of our registers,
+    // with space for the largest set of arguments passed.
+    if (m_callLinkInfoIndex) {
+        m_graph.m_callRegisterOffset = calleeRegisters + m_maxArgumentCount + RegisterFile::CallFrameHeaderSize;
+        calleeRegisters = m_graph.m_callRegisterOffset;
+    }
+
     if ((unsigned)m_codeBlock->m_numCalleeRegisters < calleeRegisters)
         m_codeBlock->m_numCalleeRegisters = calleeRegisters;
 
@@ -1065,15 +1257,16 @@ bool ByteCodeParser::parse()
     return true;
 }
 
-bool parse(Graph& graph, JSGlobalData* globalData, CodeBlock* codeBlock)
+bool parse(Graph& graph, JSGlobalData* globalData, CodeBlock* codeBlock, CodeBlock* profiledBlock)
 {
 #if DFG_DEBUG_LOCAL_DISBALE
     UNUSED_PARAM(graph);
     UNUSED_PARAM(globalData);
     UNUSED_PARAM(codeBlock);
+    UNUSED_PARAM(profiledBlock);
     return false;
 #else
-    return ByteCodeParser(globalData, codeBlock, graph).parse();
+    return ByteCodeParser(globalData, codeBlock, profiledBlock, graph).parse();
 #endif
 }
 
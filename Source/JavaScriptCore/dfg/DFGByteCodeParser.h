@@ -38,8 +38,10 @@ class JSGlobalData;
 namespace DFG {
 
 // Populate the Graph with a basic block of code from the CodeBlock,
-// starting at the provided bytecode index.
-bool parse(Graph&, JSGlobalData*, CodeBlock*);
+// starting at the provided bytecode index. The profiled CodeBlock is
+// baseline JIT code for the same function, whose value profiles are
+// used to predict the types of the values produced by each node.
+bool parse(Graph&, JSGlobalData*, CodeBlock*, CodeBlock* profiledBlock);
 
 } } // namespace JSC::DFG
 
@@ -69,7 +69,9 @@ void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
     //         arg# - an argument number.
     //         $#   - the index in the CodeBlock of a constant { for numeric constants the value is displayed | for integers, in both decimal and hex }.
     //         id#  - the index in the CodeBlock of an identifier { if codeBlock is passed to dump(), the string representation is displayed }.
-    //         var# - the index of a var on the global object, used by GetGlobalVar/PutGlobalVar operations.
+    //         var# - the index of a var on the global object, used by GetGlobalVar/PutGlobalVar operations,
+    //                or in a scope chain object, used by GetScopedVar/PutScopedVar operations.
+    //         argc# - the number of arguments passed by a call, including 'this'.
     printf("% 4d:\t<%c%u:%u>\t%s(", (int)nodeIndex, mustGenerate ? '!' : ' ', refCount, node.virtualRegister, dfgOpNames[op & NodeIdMask]);
     if (node.child1 != NoNode)
         printf("@%u", node.child1);
@@ -83,6 +85,18 @@ void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
         printf("%svar%u", hasPrinted ? ", " : "", node.varNumber());
         hasPrinted = true;
     }
+    if (op == GetScopedVar || op == PutScopedVar) {
+        printf("%sskip%u", hasPrinted ? ", " : "", node.scopeChainDepth());
+        hasPrinted = true;
+    }
+    if (node.isCall()) {
+        printf("%sargc%u", hasPrinted ? ", " : "", node.numberOfArguments());
+        hasPrinted = true;
+    }
+    if (op == SetCallArgument) {
+        printf("%sr%d", hasPrinted ? ", " : "", node.callArgumentOffset());
+        hasPrinted = true;
+    }
     if (node.hasIdentifier()) {
         if (codeBlock)
             printf("%sid%u{%s}", hasPrinted ? ", " : "", node.identifierNumber(), codeBlock->identifier(node.identifierNumber()).ustring().utf8().data());
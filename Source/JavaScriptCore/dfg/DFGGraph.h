@@ -58,6 +58,41 @@ struct BasicBlock {
     NodeIndex end;
 };
 
+#if DFG_OSR_EXIT
+// Records the node holding the value of a bytecode temporary.
+struct TemporaryState {
+    TemporaryState(int operand, NodeIndex nodeIndex)
+        : operand(operand)
+        , nodeIndex(nodeIndex)
+    {
+    }
+
+    int operand;
+    NodeIndex nodeIndex;
+};
+
+// Records the temporaries defined at the start of a bytecode instruction, as the
+// range [begin, end) of Graph::m_temporaryStates. On a speculation failure this
+// is used to rebuild the baseline JIT's view of the register file.
+struct InstructionState {
+    InstructionState(unsigned bytecodeIndex, unsigned begin, unsigned end)
+        : bytecodeIndex(bytecodeIndex)
+        , begin(begin)
+        , end(end)
+    {
+    }
+
+    static inline unsigned getBytecodeIndex(InstructionState* state)
+    {
+        return state->bytecodeIndex;
+    }
+
+    unsigned bytecodeIndex;
+    unsigned begin;
+    unsigned end;
+};
+#endif
+
 // 
 // === Graph ===
 //
@@ -66,6 +101,11 @@ struct BasicBlock {
 // Nodes that are 'dead' remain in the vector with refCount 0.
 class Graph : public Vector<Node, 64> {
 public:
+    Graph()
+        : m_callRegisterOffset(0)
+    {
+    }
+
     // Mark a node as being referenced.
     void ref(NodeIndex nodeIndex)
     {
@@ -99,6 +139,22 @@ public:
         return static_cast<BlockIndex>(block - begin);
     }
 
+    // The register offset of the frame set up for calls made from this function;
+    // arguments are stored immediately below the callee's call frame header.
+    unsigned m_callRegisterOffset;
+
+#if DFG_OSR_EXIT
+    Vector<InstructionState> m_instructionStates;
+    Vector<TemporaryState> m_temporaryStates;
+
+    InstructionState& instructionStateForBytecodeIndex(unsigned bytecodeIndex)
+    {
+        InstructionState* state = binarySearch<InstructionState, unsigned, InstructionState::getBytecodeIndex>(m_instructionStates.begin(), m_instructionStates.size(), bytecodeIndex);
+        ASSERT(state->bytecodeIndex == bytecodeIndex);
+        return *state;
+    }
+#endif
+
 private:
     // When a node's refCount goes from 0 to 1, it must (logically) recursively ref all of its children, and vice versa.
     void refChildren(NodeIndex);
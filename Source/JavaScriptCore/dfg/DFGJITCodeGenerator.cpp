@@ -30,6 +30,7 @@
 
 #include "DFGNonSpeculativeJIT.h"
 #include "DFGSpeculativeJIT.h"
+#include "JSFunction.h"
 #include "LinkBuffer.h"
 
 namespace JSC { namespace DFG {
@@ -334,6 +335,94 @@ void JITCodeGenerator::useChildren(Node& node)
     use(child3);
 }
 
+void JITCodeGenerator::emitCall(Node& node)
+{
+    ASSERT(node.isCall());
+    bool isConstruct = node.op == Construct;
+
+    JSValueOperand callee(this, node.child1);
+    GPRReg calleeGPR = callee.gpr();
+    flushRegisters();
+
+    // The arguments have already been stored by SetCallArgument nodes; the callee's
+    // frame is placed after all registers used by this function.
+    int callOffset = m_jit.graph().m_callRegisterOffset;
+    int argCount = node.numberOfArguments();
+    JITCompiler::RegisterID calleeReg = JITCompiler::regT0;
+    m_jit.move(JITCompiler::gprToRegisterID(calleeGPR), calleeReg);
+
+    // This plants a check for a cached JSFunction value, so we can plant a fast link to the callee.
+    JITCompiler::DataLabelPtr targetToCheck;
+    JITCompiler::Jump slowPath = m_jit.branchPtrWithPatch(MacroAssembler::NotEqual, calleeReg, targetToCheck, JITCompiler::TrustedImmPtr(JSValue::encode(JSValue())));
+
+    // The fast path initializes the callee's frame, other than the CodeBlock, which is set in the callee.
+    m_jit.loadPtr(MacroAssembler::Address(calleeReg, JSFunction::offsetOfScopeChain()), JITCompiler::regT1);
+    m_jit.storePtr(JITCompiler::TrustedImmPtr(JSValue::encode(jsNumber(argCount))), JITCompiler::addressFor(static_cast<VirtualRegister>(callOffset + RegisterFile::ArgumentCount)));
+    m_jit.storePtr(JITCompiler::callFrameRegister, JITCompiler::addressFor(static_cast<VirtualRegister>(callOffset + RegisterFile::CallerFrame)));
+    m_jit.storePtr(calleeReg, JITCompiler::addressFor(static_cast<VirtualRegister>(callOffset + RegisterFile::Callee)));
+    m_jit.storePtr(JITCompiler::regT1, JITCompiler::addressFor(static_cast<VirtualRegister>(callOffset + RegisterFile::ScopeChain)));
+    m_jit.addPtr(Imm32(callOffset * sizeof(Register)), JITCompiler::callFrameRegister);
+    JITCompiler::Call fastCall = m_jit.nearCall();
+    JITCompiler::Jump fastCallDone = m_jit.jump();
+
+    // The slow path links the call, if the callee is a JSFunction.
+    slowPath.link(&m_jit);
+    JITCompiler::Jump notCell = m_jit.branchTestPtr(MacroAssembler::NonZero, calleeReg, JITCompiler::tagMaskRegister);
+    JITCompiler::Jump notJSFunction = m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(calleeReg), JITCompiler::TrustedImmPtr(m_jit.globalData()->jsFunctionVPtr));
+    m_jit.storePtr(JITCompiler::callFrameRegister, JITCompiler::addressFor(static_cast<VirtualRegister>(callOffset + RegisterFile::CallerFrame)));
+    m_jit.addPtr(Imm32(callOffset * sizeof(Register)), JITCompiler::callFrameRegister);
+    m_jit.move(Imm32(argCount), JITCompiler::regT1);
+    JITCompiler::Call slowCall = m_jit.nearCall();
+    JITCompiler::Jump slowCallDone = m_jit.jump();
+
+    // Anything else is called through an operation. The ReturnPC of the callee's frame
+    // is set to the return address of this call, to be seen by the host function.
+    notCell.link(&m_jit);
+    notJSFunction.link(&m_jit);
+    JITCompiler::DataLabelPtr hostReturnPC = m_jit.storePtrWithPatch(JITCompiler::TrustedImmPtr(0), JITCompiler::addressFor(static_cast<VirtualRegister>(callOffset + RegisterFile::ReturnPC)));
+    m_jit.move(calleeReg, JITCompiler::argumentRegister1);
+    m_jit.move(Imm32(callOffset), JITCompiler::argumentRegister2);
+    m_jit.move(Imm32(argCount), JITCompiler::argumentRegister3);
+    m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
+    JITCompiler::Call hostCall = appendCallWithExceptionCheck(isConstruct ? operationConstructNotJSConstruct : operationCallNotJSFunction);
+
+    fastCallDone.link(&m_jit);
+    slowCallDone.link(&m_jit);
+    m_jit.addJSCall(JSCallRecord(targetToCheck, fastCall, slowCall, hostReturnPC, hostCall, node.callLinkInfoIndex(), isConstruct, node.exceptionInfo));
+
+    // All three paths leave the result in the returnValueRegister.
+    GPRResult result(this);
+    jsValueResult(result.gpr(), m_compileIndex);
+}
+
+void JITCodeGenerator::emitResolveGlobal(Node& node)
+{
+    flushRegisters();
+    GPRResult result(this);
+
+    GlobalResolveInfo* resolveInfo = &m_jit.codeBlock()->globalResolveInfo(node.resolveInfoIndex());
+    JITCompiler::RegisterID resultReg = result.registerID();
+    JITCompiler::RegisterID offsetReg = JITCompiler::argumentRegister1;
+    ASSERT(resultReg != offsetReg);
+
+    // Check Structure of global object.
+    m_jit.move(JITCompiler::TrustedImmPtr(m_jit.codeBlock()->globalObject()), resultReg);
+    m_jit.loadPtr(&resolveInfo->structure, offsetReg);
+    JITCompiler::Jump structuresNotMatch = m_jit.branchPtr(MacroAssembler::NotEqual, offsetReg, MacroAssembler::Address(resultReg, JSCell::structureOffset()));
+
+    // Load cached property; the global object always uses external storage.
+    m_jit.loadPtr(MacroAssembler::Address(resultReg, JSObject::offsetOfPropertyStorage()), resultReg);
+    m_jit.load32(&resolveInfo->offset, offsetReg);
+    m_jit.loadPtr(MacroAssembler::BaseIndex(resultReg, offsetReg, MacroAssembler::ScalePtr), resultReg);
+    JITCompiler::Jump wasFast = m_jit.jump();
+
+    structuresNotMatch.link(&m_jit);
+    callOperation((J_DFGOperation_EPP)operationResolveGlobal, result.gpr(), resolveInfo, identifier(node.identifierNumber()));
+
+    wasFast.link(&m_jit);
+    jsValueResult(result.gpr(), m_compileIndex);
+}
+
 #ifndef NDEBUG
 static const char* dataFormatString(DataFormat format)
 {
@@ -145,6 +145,9 @@ public:
         return info.registerFormat() == DataFormatDouble;
     }
 
+    // The labels at the head of each basic block, once generated.
+    const Vector<MacroAssembler::Label>& blockHeads() const { return m_blockHeads; }
+
 protected:
     JITCodeGenerator(JITCompiler& jit, bool isSpeculative)
         : m_jit(jit)
@@ -473,7 +476,7 @@ protected:
             m_jit.move(JITCompiler::gprToRegisterID(srcB), JITCompiler::gprToRegisterID(destB));
             m_jit.move(JITCompiler::gprToRegisterID(srcA), JITCompiler::gprToRegisterID(destA));
         } else
-            m_jit.swap(JITCompiler::gprToRegisterID(destB), JITCompiler::gprToRegisterID(destB));
+            m_jit.swap(JITCompiler::gprToRegisterID(destA), JITCompiler::gprToRegisterID(destB));
     }
     template<FPRReg destA, FPRReg destB>
     void setupTwoStubArgs(FPRReg srcA, FPRReg srcB)
@@ -509,12 +512,12 @@ protected:
         ASSERT(srcB == destA && srcA == destB);
         // Need to swap; pick a temporary register.
         FPRReg temp;
-        if (destA != JITCompiler::argumentFPR3 && destA != JITCompiler::argumentFPR3)
+        if (destA != JITCompiler::argumentFPR3 && destB != JITCompiler::argumentFPR3)
             temp = JITCompiler::argumentFPR3;
-        else if (destA != JITCompiler::argumentFPR2 && destA != JITCompiler::argumentFPR2)
+        else if (destA != JITCompiler::argumentFPR2 && destB != JITCompiler::argumentFPR2)
             temp = JITCompiler::argumentFPR2;
         else {
-            ASSERT(destA != JITCompiler::argumentFPR1 && destA != JITCompiler::argumentFPR1);
+            ASSERT(destA != JITCompiler::argumentFPR1 && destB != JITCompiler::argumentFPR1);
             temp = JITCompiler::argumentFPR1;
         }
         m_jit.moveDouble(JITCompiler::fprToRegisterID(destA), JITCompiler::fprToRegisterID(temp));
@@ -593,6 +596,27 @@ protected:
     {
         callOperation((J_DFGOperation_EJP)operation, result, arg1, identifier);
     }
+    void callOperation(J_DFGOperation_EP operation, GPRReg result, void* pointer)
+    {
+        ASSERT(isFlushed());
+
+        m_jit.move(JITCompiler::TrustedImmPtr(pointer), JITCompiler::argumentRegister1);
+        m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
+
+        appendCallWithExceptionCheck(operation);
+        m_jit.move(JITCompiler::returnValueRegister, JITCompiler::gprToRegisterID(result));
+    }
+    void callOperation(J_DFGOperation_EPP operation, GPRReg result, void* pointer1, void* pointer2)
+    {
+        ASSERT(isFlushed());
+
+        m_jit.move(JITCompiler::TrustedImmPtr(pointer1), JITCompiler::argumentRegister1);
+        m_jit.move(JITCompiler::TrustedImmPtr(pointer2), JITCompiler::argumentRegister2);
+        m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
+
+        appendCallWithExceptionCheck(operation);
+        m_jit.move(JITCompiler::returnValueRegister, JITCompiler::gprToRegisterID(result));
+    }
     void callOperation(J_DFGOperation_EJ operation, GPRReg result, GPRReg arg1)
     {
         ASSERT(isFlushed());
@@ -611,7 +635,8 @@ protected:
         m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
 
         appendCallWithExceptionCheck(operation);
-        m_jit.move(JITCompiler::returnValueRegister, JITCompiler::gprToRegisterID(result));
+        // A bool is returned in the low byte of the return value register only.
+        m_jit.and32(TrustedImm32(1), JITCompiler::returnValueRegister, JITCompiler::gprToRegisterID(result));
     }
     void callOperation(Z_DFGOperation_EJJ operation, GPRReg result, GPRReg arg1, GPRReg arg2)
     {
@@ -621,7 +646,8 @@ protected:
         m_jit.move(JITCompiler::callFrameRegister, JITCompiler::argumentRegister0);
 
         appendCallWithExceptionCheck(operation);
-        m_jit.move(JITCompiler::returnValueRegister, JITCompiler::gprToRegisterID(result));
+        // A bool is returned in the low byte of the return value register only.
+        m_jit.and32(TrustedImm32(1), JITCompiler::returnValueRegister, JITCompiler::gprToRegisterID(result));
     }
     void callOperation(J_DFGOperation_EJJ operation, GPRReg result, GPRReg arg1, GPRReg arg2)
     {
@@ -666,11 +692,16 @@ protected:
         m_jit.moveDouble(JITCompiler::fpReturnValueRegister, JITCompiler::fprToRegisterID(result));
     }
 
-    void appendCallWithExceptionCheck(const FunctionPtr& function)
+    MacroAssembler::Call appendCallWithExceptionCheck(const FunctionPtr& function)
     {
-        m_jit.appendCallWithExceptionCheck(function, m_jit.graph()[m_compileIndex].exceptionInfo);
+        return m_jit.appendCallWithExceptionCheck(function, m_jit.graph()[m_compileIndex].exceptionInfo);
     }
 
+    // These methods generate code shared by the speculative & non-speculative JITs,
+    // for nodes that make no speculative assumptions about their operands.
+    void emitCall(Node&);
+    void emitResolveGlobal(Node&);
+
     void addBranch(const MacroAssembler::Jump& jump, BlockIndex destination)
     {
         m_branches.append(BranchRecord(jump, destination));
@@ -36,9 +36,113 @@
 #include "DFGSpeculativeJIT.h"
 #include "JSGlobalData.h"
 #include "LinkBuffer.h"
+#include "SamplingTool.h"
+#include <algorithm>
 
 namespace JSC { namespace DFG {
 
+static bool compareCallReturnOffsets(const CallReturnOffsetToBytecodeOffset& a, const CallReturnOffsetToBytecodeOffset& b)
+{
+    return a.callReturnOffset < b.callReturnOffset;
+}
+
+void JITCompiler::spillSpeculationCheckRegisters(const SpeculationCheck& check, SpeculationRecovery* recovery)
+{
+    // Link the jump from the Speculative path to here.
+    check.m_check.link(this);
+
+    // Does this speculation check require any additional recovery to be performed,
+    // to restore any state that has been overwritten before we enter back in to the
+    // non-speculative path.
+    if (recovery) {
+        // The only additional recovery we currently support is for integer add operation
+        ASSERT(recovery->type() == SpeculativeAdd);
+        // Revert the add.
+        sub32(gprToRegisterID(recovery->src()), gprToRegisterID(recovery->dest()));
+    }
+
+    // FIXME: - This is hideously inefficient!
+    // Where a value is live in a register in the speculative path, and is required in a register
+    // on the non-speculative path, we should not need to be spilling it and reloading (we may
+    // need to spill anyway, if the value is marked as spilled on the non-speculative path).
+    // This may also be spilling values that don't need spilling, e.g. are already spilled,
+    // are constants, or are arguments.
+
+    // Spill all GPRs in use by the speculative path.
+    for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
+        NodeIndex nodeIndex = check.m_gprInfo[gpr].nodeIndex;
+        if (nodeIndex == NoNode)
+            continue;
+
+        DataFormat dataFormat = check.m_gprInfo[gpr].format;
+        VirtualRegister virtualRegister = graph()[nodeIndex].virtualRegister;
+
+        ASSERT(dataFormat == DataFormatInteger || dataFormat == DataFormatCell || dataFormat & DataFormatJS);
+        if (dataFormat == DataFormatInteger)
+            orPtr(tagTypeNumberRegister, gprToRegisterID(gpr));
+        storePtr(gprToRegisterID(gpr), addressFor(virtualRegister));
+    }
+
+    // Spill all FPRs in use by the speculative path.
+    for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
+        NodeIndex nodeIndex = check.m_fprInfo[fpr];
+        if (nodeIndex == NoNode)
+            continue;
+
+        VirtualRegister virtualRegister = graph()[nodeIndex].virtualRegister;
+
+        moveDoubleToPtr(fprToRegisterID(fpr), regT0);
+        subPtr(tagTypeNumberRegister, regT0);
+        storePtr(regT0, addressFor(virtualRegister));
+    }
+}
+
+#if DFG_OSR_EXIT
+void JITCompiler::exitSpeculativeWithOSR(const SpeculationCheck& check, SpeculationRecovery* recovery)
+{
+    spillSpeculationCheckRegisters(check, recovery);
+
+    // Record the values of the bytecode temporaries live at the start of the
+    // instruction that failed; the baseline JIT will reexecute this instruction.
+    // Temporaries whose nodes were never generated cannot be read by the baseline
+    // JIT, and are skipped.
+    Node& node = graph()[check.m_nodeIndex];
+    InstructionState& state = graph().instructionStateForBytecodeIndex(node.exceptionInfo);
+    Vector<OSRExitValue>& values = m_codeBlock->osrExitValues();
+    unsigned firstValue = values.size();
+    for (unsigned i = state.begin; i < state.end; ++i) {
+        TemporaryState& temporary = graph().m_temporaryStates[i];
+        Node& temporaryNode = graph()[temporary.nodeIndex];
+        if (!temporaryNode.refCount)
+            continue;
+
+        if (isInt32Constant(temporary.nodeIndex))
+            values.append(OSRExitValue(temporary.operand, JSValue::encode(jsNumber(valueOfInt32Constant(temporary.nodeIndex)))));
+        else if (isDoubleConstant(temporary.nodeIndex))
+            values.append(OSRExitValue(temporary.operand, JSValue::encode(JSValue(JSValue::EncodeAsDouble, valueOfDoubleConstant(temporary.nodeIndex)))));
+        else if (isJSConstant(temporary.nodeIndex))
+            values.append(OSRExitValue(temporary.operand, JSValue::encode(valueOfJSConstant(temporary.nodeIndex))));
+        else
+            values.append(OSRExitValue(temporary.operand, temporaryNode.virtualRegister));
+    }
+    unsigned exitIndex = m_codeBlock->addOSRExit(node.exceptionInfo, firstValue, values.size() - firstValue);
+
+    // operationOSRExit returns the address in the baseline JIT code to continue execution at.
+    move(callFrameRegister, argumentRegister0);
+    move(TrustedImm32(exitIndex), argumentRegister1);
+    m_calls.append(CallRecord(call(), operationOSRExit));
+    jump(returnValueRegister);
+}
+
+void JITCompiler::linkOSRExits(SpeculativeJIT& speculative)
+{
+    SpeculationCheckVector& checks = speculative.speculationChecks();
+    for (SpeculationCheckVector::Iterator iter = checks.begin(); iter != checks.end(); ++iter) {
+        const SpeculationCheck& check = *iter;
+        exitSpeculativeWithOSR(check, speculative.speculationRecovery(check.m_recoveryIndex));
+    }
+}
+#else
 // This method used to fill a numeric value to a FPR when linking speculative -> non-speculative.
 void JITCompiler::fillNumericToDouble(NodeIndex nodeIndex, FPRReg fpr, GPRReg temporary)
 {
@@ -107,53 +211,7 @@ void JITCompiler::jumpFromSpeculativeToNonSpeculative(const SpeculationCheck& ch
 {
     ASSERT(check.m_nodeIndex == entry.m_nodeIndex);
 
-    // Link the jump from the Speculative path to here.
-    check.m_check.link(this);
-
-    // Does this speculation check require any additional recovery to be performed,
-    // to restore any state that has been overwritten before we enter back in to the
-    // non-speculative path.
-    if (recovery) {
-        // The only additional recovery we currently support is for integer add operation
-        ASSERT(recovery->type() == SpeculativeAdd);
-        // Revert the add.
-        sub32(gprToRegisterID(recovery->src()), gprToRegisterID(recovery->dest()));
-    }
-
-    // FIXME: - This is hideously inefficient!
-    // Where a value is live in a register in the speculative path, and is required in a register
-    // on the non-speculative path, we should not need to be spilling it and reloading (we may
-    // need to spill anyway, if the value is marked as spilled on the non-speculative path).
-    // This may also be spilling values that don't need spilling, e.g. are already spilled,
-    // are constants, or are arguments.
-
-    // Spill all GPRs in use by the speculative path.
-    for (GPRReg gpr = gpr0; gpr < numberOfGPRs; next(gpr)) {
-        NodeIndex nodeIndex = check.m_gprInfo[gpr].nodeIndex;
-        if (nodeIndex == NoNode)
-            continue;
-
-        DataFormat dataFormat = check.m_gprInfo[gpr].format;
-        VirtualRegister virtualRegister = graph()[nodeIndex].virtualRegister;
-
-        ASSERT(dataFormat == DataFormatInteger || DataFormatCell || dataFormat & DataFormatJS);
-        if (dataFormat == DataFormatInteger)
-            orPtr(tagTypeNumberRegister, gprToRegisterID(gpr));
-        storePtr(gprToRegisterID(gpr), addressFor(virtualRegister));
-    }
-
-    // Spill all FPRs in use by the speculative path.
-    for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
-        NodeIndex nodeIndex = check.m_fprInfo[fpr];
-        if (nodeIndex == NoNode)
-            continue;
-
-        VirtualRegister virtualRegister = graph()[nodeIndex].virtualRegister;
-
-        moveDoubleToPtr(fprToRegisterID(fpr), regT0);
-        subPtr(tagTypeNumberRegister, regT0);
-        storePtr(regT0, addressFor(virtualRegister));
-    }
+    spillSpeculationCheckRegisters(check, recovery);
 
     // Fill all FPRs in use by the non-speculative path.
     for (FPRReg fpr = fpr0; fpr < numberOfFPRs; next(fpr)) {
@@ -216,6 +274,7 @@ void JITCompiler::linkSpeculationChecks(SpeculativeJIT& speculative, NonSpeculat
     ASSERT(!(checksIter != checksEnd));
     ASSERT(!(entriesIter != entriesEnd));
 }
+#endif
 
 void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
 {
@@ -238,6 +297,7 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
 
     // Setup a pointer to the codeblock in the CallFrameHeader.
     emitPutImmediateToCallFrameHeader(m_codeBlock, RegisterFile::CodeBlock);
+    store32(TrustedImm32(1), m_codeBlock->addressOfWasExecuted());
 
     // Plant a check that sufficient space is available in the RegisterFile.
     // FIXME: https://bugs.webkit.org/show_bug.cgi?id=56291
@@ -246,6 +306,21 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // Return here after register file check.
     Label fromRegisterFileCheck = label();
 
+    // If the code is being compiled while the SamplingProfiler is running, plant a
+    // safepoint at which it can take a sample.
+    // This call is linked separately, as m_calls is discarded if speculative
+    // compilation fails.
+    SamplingProfiler* samplingProfiler = m_globalData->samplingProfiler();
+    bool hasSampleCheck = samplingProfiler && samplingProfiler->isRunning();
+    Call callTakeSample;
+    if (hasSampleCheck) {
+        load32(samplingProfiler->addressOfSampleRequested(), regT0);
+        Jump skipSample = branchTest32(Zero, regT0);
+        move(callFrameRegister, argumentRegister0);
+        callTakeSample = call();
+        skipSample.link(this);
+    }
+
 
     // === Stage 2 - Function body code generation ===
     //
@@ -255,6 +330,11 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     // the non-speculative one (and generating any code necessary to juggle
     // register values around, rebox values, and ensure spilled, to match the
     // non-speculative path's requirements).
+    //
+    // With DFG_OSR_EXIT enabled no non-speculative path is generated unless
+    // speculative compilation fails; instead bail-outs write the state of the
+    // bytecode registers back to the RegisterFile, and continue execution in
+    // code generated by the baseline JIT.
 
 #if DFG_JIT_BREAK_ON_EVERY_FUNCTION
     // Handy debug tool!
@@ -265,26 +345,34 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     Label speculativePathBegin = label();
     SpeculativeJIT speculative(*this);
     bool compiledSpeculative = speculative.compile();
+    Vector<Label> blockHeads;
 
     // Next, generate the non-speculative path. We pass this a SpeculationCheckIndexIterator
     // to allow it to check which nodes in the graph may bail out, and may need to reenter the
     // non-speculative path.
     if (compiledSpeculative) {
+        blockHeads = speculative.blockHeads();
+#if DFG_OSR_EXIT
+        linkOSRExits(speculative);
+#else
         SpeculationCheckIndexIterator checkIterator(speculative.speculationChecks());
         NonSpeculativeJIT nonSpeculative(*this);
         nonSpeculative.compile(checkIterator);
 
         // Link the bail-outs from the speculative path to the corresponding entry points into the non-speculative one.
         linkSpeculationChecks(speculative, nonSpeculative);
+#endif
     } else {
         // If compilation through the SpeculativeJIT failed, throw away the code we generated.
         m_calls.clear();
+        m_jsCalls.clear();
         rewindToLabel(speculativePathBegin);
 
         SpeculationCheckVector noChecks;
         SpeculationCheckIndexIterator checkIterator(noChecks);
         NonSpeculativeJIT nonSpeculative(*this);
         nonSpeculative.compile(checkIterator);
+        blockHeads = nonSpeculative.blockHeads();
     }
 
     // === Stage 3 - Function footer code generation ===
@@ -357,23 +445,55 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     for (unsigned i = 0; i < m_calls.size(); ++i)
         linkBuffer.link(m_calls[i].m_call, m_calls[i].m_function);
 
+    // Link the slow paths of calls to JavaScript functions to the trampolines that
+    // link the fast paths, and record the locations for linking in the CallLinkInfos.
+    // The fast calls are left unlinked; they cannot be reached until linked.
+    for (unsigned i = 0; i < m_jsCalls.size(); ++i) {
+        JSCallRecord& record = m_jsCalls[i];
+        MacroAssemblerCodePtr trampoline = record.m_isConstruct ? m_globalData->jitStubs->ctiVirtualConstructLink() : m_globalData->jitStubs->ctiVirtualCallLink();
+        linkBuffer.link(record.m_slowCall, FunctionPtr(trampoline.executableAddress()));
+        linkBuffer.patch(record.m_hostReturnPC, linkBuffer.locationOf(record.m_hostCall).executableAddress());
+
+        CallLinkInfo& info = m_codeBlock->callLinkInfo(record.m_callLinkInfoIndex);
+        info.callReturnLocation = linkBuffer.locationOfNearCall(record.m_slowCall);
+        info.hotPathBegin = linkBuffer.locationOf(record.m_targetToCheck);
+        info.hotPathOther = linkBuffer.locationOfNearCall(record.m_fastCall);
+    }
+
     if (m_codeBlock->needsCallReturnIndices()) {
-        m_codeBlock->callReturnIndexVector().reserveCapacity(exceptionCheckCount);
+        Vector<CallReturnOffsetToBytecodeOffset>& callReturnIndexVector = m_codeBlock->callReturnIndexVector();
+        callReturnIndexVector.reserveCapacity(exceptionCheckCount + 2 * m_jsCalls.size());
         for (unsigned i = 0; i < m_calls.size(); ++i) {
             if (m_calls[i].m_exceptionCheck.isSet()) {
                 unsigned returnAddressOffset = linkBuffer.returnAddressOffset(m_calls[i].m_call);
                 unsigned exceptionInfo = m_calls[i].m_exceptionInfo;
-                m_codeBlock->callReturnIndexVector().append(CallReturnOffsetToBytecodeOffset(returnAddressOffset, exceptionInfo));
+                callReturnIndexVector.append(CallReturnOffsetToBytecodeOffset(returnAddressOffset, exceptionInfo));
             }
         }
+        // Exceptions thrown by the callee of a JavaScript call are unwound through the return address.
+        for (unsigned i = 0; i < m_jsCalls.size(); ++i) {
+            callReturnIndexVector.append(CallReturnOffsetToBytecodeOffset(linkBuffer.returnAddressOffset(m_jsCalls[i].m_fastCall), m_jsCalls[i].m_exceptionInfo));
+            callReturnIndexVector.append(CallReturnOffsetToBytecodeOffset(linkBuffer.returnAddressOffset(m_jsCalls[i].m_slowCall), m_jsCalls[i].m_exceptionInfo));
+        }
+        if (m_jsCalls.size())
+            std::sort(callReturnIndexVector.begin(), callReturnIndexVector.end(), compareCallReturnOffsets);
     }
 
     // FIXME: switch the register file check & arity check over to DFGOpertaion style calls, not JIT stubs.
     linkBuffer.link(callRegisterFileCheck, cti_register_file_check);
+    if (hasSampleCheck)
+        linkBuffer.link(callTakeSample, operationTakeSample);
     linkBuffer.link(callArityCheck, m_codeBlock->m_isConstructor ? cti_op_construct_arityCheck : cti_op_call_arityCheck);
 
     entryWithArityCheck = linkBuffer.locationOf(arityCheck);
     entry = linkBuffer.finalizeCode();
+    m_codeBlock->setJITCode(entry);
+
+    // Execution may enter at the head of any basic block from a loop in the
+    // baseline JIT code, since no values are held in registers across blocks.
+    Vector<BasicBlock>& blocks = m_graph.m_blocks;
+    for (unsigned i = 0; i < blocks.size(); ++i)
+        m_codeBlock->osrEntries().append(BytecodeOffsetToMachineCodeOffset(blocks[i].bytecodeBegin, entry.offsetOf(linkBuffer.locationOf(blockHeads[i]).executableAddress())));
 }
 
 #if DFG_JIT_ASSERT
@@ -96,6 +96,38 @@ struct CallRecord {
     ExceptionInfo m_exceptionInfo;
 };
 
+// === JSCallRecord ===
+//
+// A record of a call from JIT code to a JavaScript function, used to fill in
+// the corresponding CallLinkInfo. The fast path compares the callee against
+// a patchable pointer, and on a match performs a near call directly to the
+// linked function. The slow path calls a trampoline that links the call.
+// Calls to host functions that are not JSFunctions are made through an
+// operation; the ReturnPC of the callee's frame is patched to the return
+// address of this call.
+struct JSCallRecord {
+    JSCallRecord(MacroAssembler::DataLabelPtr targetToCheck, MacroAssembler::Call fastCall, MacroAssembler::Call slowCall, MacroAssembler::DataLabelPtr hostReturnPC, MacroAssembler::Call hostCall, unsigned callLinkInfoIndex, bool isConstruct, ExceptionInfo exceptionInfo)
+        : m_targetToCheck(targetToCheck)
+        , m_fastCall(fastCall)
+        , m_slowCall(slowCall)
+        , m_hostReturnPC(hostReturnPC)
+        , m_hostCall(hostCall)
+        , m_callLinkInfoIndex(callLinkInfoIndex)
+        , m_isConstruct(isConstruct)
+        , m_exceptionInfo(exceptionInfo)
+    {
+    }
+
+    MacroAssembler::DataLabelPtr m_targetToCheck;
+    MacroAssembler::Call m_fastCall;
+    MacroAssembler::Call m_slowCall;
+    MacroAssembler::DataLabelPtr m_hostReturnPC;
+    MacroAssembler::Call m_hostCall;
+    unsigned m_callLinkInfoIndex;
+    bool m_isConstruct;
+    ExceptionInfo m_exceptionInfo;
+};
+
 // === JITCompiler ===
 //
 // DFG::JITCompiler is responsible for generating JIT code from the dataflow graph.
@@ -240,11 +272,18 @@ public:
     }
 
     // Add a call out from JIT code, with an exception check.
-    void appendCallWithExceptionCheck(const FunctionPtr& function, unsigned exceptionInfo)
+    Call appendCallWithExceptionCheck(const FunctionPtr& function, unsigned exceptionInfo)
     {
         Call functionCall = call();
         Jump exceptionCheck = branchTestPtr(NonZero, AbsoluteAddress(&globalData()->exception));
         m_calls.append(CallRecord(functionCall, function, exceptionCheck, exceptionInfo));
+        return functionCall;
+    }
+
+    // Add a call from JIT code to a JavaScript function.
+    void addJSCall(const JSCallRecord& record)
+    {
+        m_jsCalls.append(record);
     }
 
     // Helper methods to check nodes for constants.
@@ -302,12 +341,20 @@ public:
 #endif
 
 private:
+    // Restores the state of all values held in registers on a failed speculation check to the RegisterFile.
+    void spillSpeculationCheckRegisters(const SpeculationCheck&, SpeculationRecovery*);
+#if DFG_OSR_EXIT
+    // These methods used in linking speculation failures to exits to the baseline JIT.
+    void exitSpeculativeWithOSR(const SpeculationCheck&, SpeculationRecovery*);
+    void linkOSRExits(SpeculativeJIT&);
+#else
     // These methods used in linking the speculative & non-speculative paths together.
     void fillNumericToDouble(NodeIndex, FPRReg, GPRReg temporary);
     void fillInt32ToInteger(NodeIndex, GPRReg);
     void fillToJS(NodeIndex, GPRReg);
     void jumpFromSpeculativeToNonSpeculative(const SpeculationCheck&, const EntryLocation&, SpeculationRecovery*);
     void linkSpeculationChecks(SpeculativeJIT&, NonSpeculativeJIT&);
+#endif
 
     // The globalData, used to access constants such as the vPtrs.
     JSGlobalData* m_globalData;
@@ -320,6 +367,8 @@ private:
 
     // Vector of calls out from JIT code, including exception handler information.
     Vector<CallRecord> m_calls;
+    // Vector of calls to JavaScript functions.
+    Vector<JSCallRecord> m_jsCalls;
 };
 
 } } // namespace JSC::DFG
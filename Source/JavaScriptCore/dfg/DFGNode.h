@@ -42,10 +42,13 @@
 #define DFG_DEBUG_LOCAL_DISBALE 0
 // Generate stats on how successful we were in making use of the DFG jit, and remaining on the hot path.
 #define DFG_SUCCESS_STATS 0
+// Exit to the baseline JIT on speculation failure, rather than to a non-speculative DFG code path.
+#define DFG_OSR_EXIT 1
 
 
 #if ENABLE(DFG_JIT)
 
+#include <bytecode/CodeBlock.h>
 #include <wtf/Vector.h>
 
 namespace JSC { namespace DFG {
@@ -88,6 +91,8 @@ typedef uint32_t ExceptionInfo;
     /* Nodes for local variable access. */\
     macro(GetLocal, NodeResultJS) \
     macro(SetLocal, NodeMustGenerate) \
+    /* Used to keep the value of a bytecode temporary alive until the end of its instruction. */\
+    macro(Phantom, NodeMustGenerate) \
     \
     /* Nodes for bitwise operations. */\
     macro(BitAnd, NodeResultInt32) \
@@ -127,6 +132,17 @@ typedef uint32_t ExceptionInfo;
     macro(PutByIdDirect, NodeMustGenerate) \
     macro(GetGlobalVar, NodeResultJS | NodeMustGenerate) \
     macro(PutGlobalVar, NodeMustGenerate) \
+    macro(GetScopedVar, NodeResultJS | NodeMustGenerate) \
+    macro(PutScopedVar, NodeMustGenerate) \
+    macro(ResolveGlobal, NodeResultJS | NodeMustGenerate) \
+    \
+    /* Calls. SetCallArgument stores an argument into the frame of the next call. */\
+    macro(SetCallArgument, NodeMustGenerate) \
+    macro(Call, NodeResultJS | NodeMustGenerate) \
+    macro(Construct, NodeResultJS | NodeMustGenerate) \
+    \
+    /* Closures. */\
+    macro(NewFunctionExpression, NodeResultJS | NodeMustGenerate) \
     \
     /* Nodes for comparison operations. */\
     macro(CompareLess, NodeResultJS | NodeMustGenerate) \
@@ -179,6 +195,7 @@ struct Node {
         , child3(child3)
         , virtualRegister(InvalidVirtualRegister)
         , refCount(0)
+        , prediction(PredictNone)
     {
     }
 
@@ -191,6 +208,7 @@ struct Node {
         , child3(child3)
         , virtualRegister(InvalidVirtualRegister)
         , refCount(0)
+        , prediction(PredictNone)
         , m_opInfo(imm.m_value)
     {
     }
@@ -204,6 +222,7 @@ struct Node {
         , child3(child3)
         , virtualRegister(InvalidVirtualRegister)
         , refCount(0)
+        , prediction(PredictNone)
         , m_opInfo(imm1.m_value)
     {
         m_constantValue.opInfo2 = imm2.m_value;
@@ -238,7 +257,7 @@ struct Node {
 
     bool hasIdentifier()
     {
-        return op == GetById || op == PutById || op == PutByIdDirect;
+        return op == GetById || op == PutById || op == PutByIdDirect || op == ResolveGlobal;
     }
 
     unsigned identifierNumber()
@@ -247,9 +266,15 @@ struct Node {
         return m_opInfo;
     }
 
+    unsigned resolveInfoIndex()
+    {
+        ASSERT(op == ResolveGlobal);
+        return m_constantValue.opInfo2;
+    }
+
     bool hasVarNumber()
     {
-        return op == GetGlobalVar || op == PutGlobalVar;
+        return op == GetGlobalVar || op == PutGlobalVar || op == GetScopedVar || op == PutScopedVar;
     }
 
     unsigned varNumber()
@@ -258,6 +283,43 @@ struct Node {
         return m_opInfo;
     }
 
+    unsigned scopeChainDepth()
+    {
+        ASSERT(op == GetScopedVar || op == PutScopedVar);
+        return m_constantValue.opInfo2;
+    }
+
+    bool isCall()
+    {
+        return op == Call || op == Construct;
+    }
+
+    // The number of arguments passed to a call, including 'this'.
+    unsigned numberOfArguments()
+    {
+        ASSERT(isCall());
+        return m_opInfo;
+    }
+
+    unsigned callLinkInfoIndex()
+    {
+        ASSERT(isCall());
+        return m_constantValue.opInfo2;
+    }
+
+    // The register that a call argument is stored to, relative to the callee's frame.
+    int callArgumentOffset()
+    {
+        ASSERT(op == SetCallArgument);
+        return static_cast<int>(m_opInfo);
+    }
+
+    unsigned functionExpressionIndex()
+    {
+        ASSERT(op == NewFunctionExpression);
+        return m_opInfo;
+    }
+
     bool hasInt32Result()
     {
         return (op & NodeResultMask) == NodeResultInt32;
@@ -337,6 +399,8 @@ struct Node {
     VirtualRegister virtualRegister;
     // The number of uses of the result of this operation (+1 for 'must generate' nodes, which have side-effects).
     unsigned refCount;
+    // The types of value the baseline JIT observed this operation to produce (PredictNone if unknown).
+    PredictedType prediction;
 
 private:
     // An immediate value, accesses type-checked via accessors above.
@@ -508,9 +508,33 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         GPRReg arg2GPR = arg2.gpr();
         flushRegisters();
 
+        // Place the operands in the argument registers for the call to operationGetByVal
+        // first, so that the fast path for JSArray accesses can share them.
+        setupStubArguments(arg1GPR, arg2GPR);
+        MacroAssembler::RegisterID baseReg = JITCompiler::argumentRegister1;
+        MacroAssembler::RegisterID propertyReg = JITCompiler::argumentRegister2;
+        MacroAssembler::RegisterID storageReg = JITCompiler::argumentRegister3;
+
         GPRResult result(this);
-        callOperation(operationGetByVal, result.gpr(), arg1GPR, arg2GPR);
+        MacroAssembler::RegisterID resultReg = result.registerID();
+
+        // Check that base is an array, and that property is an integer contained within m_vector (< m_vectorLength).
+        MacroAssembler::JumpList slowCases;
+        slowCases.append(m_jit.branchPtr(MacroAssembler::Below, propertyReg, JITCompiler::tagTypeNumberRegister));
+        slowCases.append(m_jit.branchTestPtr(MacroAssembler::NonZero, baseReg, JITCompiler::tagMaskRegister));
+        slowCases.append(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseReg), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr)));
+        m_jit.zeroExtend32ToPtr(propertyReg, resultReg);
+        slowCases.append(m_jit.branch32(MacroAssembler::AboveOrEqual, resultReg, MacroAssembler::Address(baseReg, JSArray::vectorLengthOffset())));
+
+        // Load the value, taking the slow case for holes.
+        m_jit.loadPtr(MacroAssembler::Address(baseReg, JSArray::storageOffset()), storageReg);
+        m_jit.loadPtr(MacroAssembler::BaseIndex(storageReg, resultReg, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])), resultReg);
+        MacroAssembler::Jump notHole = m_jit.branchTestPtr(MacroAssembler::NonZero, resultReg);
 
+        slowCases.link(&m_jit);
+        callOperation(operationGetByVal, result.gpr(), JITCompiler::argumentGPR1, JITCompiler::argumentGPR2);
+
+        notHole.link(&m_jit);
         jsValueResult(result.gpr(), m_compileIndex);
         break;
     }
@@ -533,6 +557,8 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
     }
 
     case GetById: {
+        // FIXME: get_by_id and put_by_id are not inline cached by the DFG yet;
+        // they always call out to C++.
         JSValueOperand base(this, node.child1);
         GPRReg baseGPR = base.gpr();
         flushRegisters();
@@ -590,6 +616,69 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         break;
     }
 
+    case GetScopedVar: {
+        GPRTemporary result(this);
+        MacroAssembler::RegisterID resultReg = result.registerID();
+
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, resultReg);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(MacroAssembler::Address(resultReg, OBJECT_OFFSETOF(ScopeChainNode, next)), resultReg);
+        m_jit.loadPtr(MacroAssembler::Address(resultReg, OBJECT_OFFSETOF(ScopeChainNode, object)), resultReg);
+        m_jit.loadPtr(MacroAssembler::Address(resultReg, JSVariableObject::offsetOfRegisters()), resultReg);
+        m_jit.loadPtr(JITCompiler::addressForGlobalVar(resultReg, node.varNumber()), resultReg);
+
+        jsValueResult(result.gpr(), m_compileIndex);
+        break;
+    }
+
+    case PutScopedVar: {
+        JSValueOperand value(this, node.child1);
+        GPRTemporary temp(this);
+        MacroAssembler::RegisterID tempReg = temp.registerID();
+
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, tempReg);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(MacroAssembler::Address(tempReg, OBJECT_OFFSETOF(ScopeChainNode, next)), tempReg);
+        m_jit.loadPtr(MacroAssembler::Address(tempReg, OBJECT_OFFSETOF(ScopeChainNode, object)), tempReg);
+        m_jit.loadPtr(MacroAssembler::Address(tempReg, JSVariableObject::offsetOfRegisters()), tempReg);
+        m_jit.storePtr(value.registerID(), JITCompiler::addressForGlobalVar(tempReg, node.varNumber()));
+
+        noResult(m_compileIndex);
+        break;
+    }
+
+    case ResolveGlobal: {
+        emitResolveGlobal(node);
+        break;
+    }
+
+    case NewFunctionExpression: {
+        flushRegisters();
+
+        GPRResult result(this);
+        callOperation((J_DFGOperation_EP)operationNewFunctionExpression, result.gpr(), m_jit.codeBlock()->functionExpr(node.functionExpressionIndex()));
+        jsValueResult(result.gpr(), m_compileIndex);
+        break;
+    }
+
+    case SetCallArgument: {
+        JSValueOperand value(this, node.child1);
+        m_jit.storePtr(value.registerID(), JITCompiler::addressFor(static_cast<VirtualRegister>(m_jit.graph().m_callRegisterOffset + node.callArgumentOffset())));
+        noResult(m_compileIndex);
+        break;
+    }
+
+    case Call:
+    case Construct: {
+        emitCall(node);
+        break;
+    }
+
+    case Phantom:
+        // Phantom nodes only keep their child alive; they generate no code.
+        noResult(m_compileIndex);
+        break;
+
     case DFG::Jump: {
         BlockIndex taken = m_jit.graph().blockIndexForBytecodeOffset(node.takenBytecodeOffset());
         if (taken != (m_block + 1))
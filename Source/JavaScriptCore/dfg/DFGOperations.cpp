@@ -29,10 +29,13 @@
 #if ENABLE(DFG_JIT)
 
 #include "CodeBlock.h"
+#include "ExceptionHelpers.h"
 #include "Interpreter.h"
 #include "JSByteArray.h"
 #include "JSGlobalData.h"
+#include "JSStaticScopeObject.h"
 #include "Operations.h"
+#include "SamplingTool.h"
 
 namespace JSC { namespace DFG {
 
@@ -212,6 +215,116 @@ bool operationCompareStrictEq(ExecState* exec, EncodedJSValue encodedOp1, Encode
     return JSValue::strictEqual(exec, JSValue::decode(encodedOp1), JSValue::decode(encodedOp2));
 }
 
+EncodedJSValue operationResolveGlobal(ExecState* exec, GlobalResolveInfo* resolveInfo, Identifier* propertyName)
+{
+    CodeBlock* codeBlock = exec->codeBlock();
+    JSGlobalObject* globalObject = codeBlock->globalObject();
+    ASSERT(globalObject->isGlobalObject());
+
+    PropertySlot slot(globalObject);
+    if (globalObject->getPropertySlot(exec, *propertyName, slot)) {
+        JSValue result = slot.getValue(exec, *propertyName);
+        if (slot.isCacheableValue() && !globalObject->structure()->isUncacheableDictionary() && slot.slotBase() == globalObject) {
+            resolveInfo->structure.set(exec->globalData(), codeBlock->ownerExecutable(), globalObject->structure());
+            resolveInfo->offset = slot.cachedOffset();
+        }
+        return JSValue::encode(result);
+    }
+
+    exec->globalData().exception = createUndefinedVariableError(exec, *propertyName);
+    return JSValue::encode(JSValue());
+}
+
+EncodedJSValue operationNewFunctionExpression(ExecState* exec, FunctionExecutable* function)
+{
+    JSFunction* func = function->make(exec, exec->scopeChain());
+
+    // The Identifier in a FunctionExpression may be referenced from within its
+    // FunctionBody (to allow recursion), but does not affect the enclosing scope.
+    if (!function->name().isNull()) {
+        JSStaticScopeObject* functionScopeObject = new (exec) JSStaticScopeObject(exec, function->name(), func, ReadOnly | DontDelete);
+        func->setScope(exec->globalData(), func->scope()->push(functionScopeObject));
+    }
+
+    return JSValue::encode(func);
+}
+
+static EncodedJSValue callHostFunction(ExecState* exec, NativeFunction function, JSValue callee, int32_t registerOffset, int32_t argCount)
+{
+    ExecState* calleeFrame = CallFrame::create(exec->registers() + registerOffset);
+    if (!exec->globalData().interpreter->registerFile().grow(calleeFrame->registers())) {
+        exec->globalData().exception = createStackOverflowError(exec);
+        return JSValue::encode(JSValue());
+    }
+
+    calleeFrame->init(0, static_cast<Instruction*>(calleeFrame->returnPC().value()), exec->scopeChain(), exec, argCount, asObject(callee));
+    return function(calleeFrame);
+}
+
+EncodedJSValue operationCallNotJSFunction(ExecState* exec, EncodedJSValue encodedCallee, int32_t registerOffset, int32_t argCount)
+{
+    JSValue callee = JSValue::decode(encodedCallee);
+
+    CallData callData;
+    CallType callType = getCallData(callee, callData);
+    ASSERT(callType != CallTypeJS);
+
+    if (callType == CallTypeHost)
+        return callHostFunction(exec, callData.native.function, callee, registerOffset, argCount);
+
+    ASSERT(callType == CallTypeNone);
+    exec->globalData().exception = createNotAFunctionError(exec, callee);
+    return JSValue::encode(JSValue());
+}
+
+EncodedJSValue operationConstructNotJSConstruct(ExecState* exec, EncodedJSValue encodedCallee, int32_t registerOffset, int32_t argCount)
+{
+    JSValue callee = JSValue::decode(encodedCallee);
+
+    ConstructData constructData;
+    ConstructType constructType = getConstructData(callee, constructData);
+    ASSERT(constructType != ConstructTypeJS);
+
+    if (constructType == ConstructTypeHost)
+        return callHostFunction(exec, constructData.native.function, callee, registerOffset, argCount);
+
+    ASSERT(constructType == ConstructTypeNone);
+    exec->globalData().exception = createNotAConstructorError(exec, callee);
+    return JSValue::encode(JSValue());
+}
+
+void operationTakeSample(ExecState* exec)
+{
+    exec->globalData().samplingProfiler()->takeSample(exec, 0);
+}
+
+#if DFG_OSR_EXIT
+void* operationOSRExit(ExecState* exec, uint32_t exitIndex)
+{
+    CodeBlock* codeBlock = exec->codeBlock();
+    CodeBlock* alternative = codeBlock->alternative();
+    ASSERT(alternative && alternative->isOSRExitTarget());
+
+    OSRExit& exit = codeBlock->osrExit(exitIndex);
+    OSRExitValue* values = codeBlock->osrExitValues().begin() + exit.firstValue;
+
+    // The registers used by the DFG JIT to hold values overlap those used by the
+    // baseline JIT for temporaries, so read all of the values before writing any.
+    Vector<JSValue, 32> recovered(exit.numberOfValues);
+    for (unsigned i = 0; i < exit.numberOfValues; ++i)
+        recovered[i] = values[i].isConstant ? JSValue::decode(values[i].constant) : exec->registers()[values[i].virtualRegister].jsValue();
+    for (unsigned i = 0; i < exit.numberOfValues; ++i)
+        exec->registers()[values[i].operand] = recovered[i];
+
+    // Whatever speculation failed here would most likely fail again, so don't
+    // have the loops of the baseline code enter the optimized code again.
+    alternative->dontOptimizeAnytimeSoon();
+
+    exec->setCodeBlock(alternative);
+    return static_cast<char*>(alternative->getJITCode().start()) + alternative->machineCodeOffsetForBytecodeOffset(exit.bytecodeOffset);
+}
+#endif
+
 DFGHandler lookupExceptionHandler(ExecState* exec, ReturnAddressPtr faultLocation)
 {
     JSValue exceptionValue = exec->exception();
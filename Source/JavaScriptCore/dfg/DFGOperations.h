@@ -42,6 +42,8 @@ typedef EncodedJSValue (*J_DFGOperation_EJJ)(ExecState*, EncodedJSValue, Encoded
 typedef EncodedJSValue (*J_DFGOperation_EJ)(ExecState*, EncodedJSValue);
 typedef EncodedJSValue (*J_DFGOperation_EJP)(ExecState*, EncodedJSValue, void*);
 typedef EncodedJSValue (*J_DFGOperation_EJI)(ExecState*, EncodedJSValue, Identifier*);
+typedef EncodedJSValue (*J_DFGOperation_EP)(ExecState*, void*);
+typedef EncodedJSValue (*J_DFGOperation_EPP)(ExecState*, void*, void*);
 typedef bool (*Z_DFGOperation_EJ)(ExecState*, EncodedJSValue);
 typedef bool (*Z_DFGOperation_EJJ)(ExecState*, EncodedJSValue, EncodedJSValue);
 typedef void (*V_DFGOperation_EJJJ)(ExecState*, EncodedJSValue, EncodedJSValue, EncodedJSValue);
@@ -64,6 +66,22 @@ bool operationCompareLess(ExecState*, EncodedJSValue encodedOp1, EncodedJSValue
 bool operationCompareLessEq(ExecState*, EncodedJSValue encodedOp1, EncodedJSValue encodedOp2);
 bool operationCompareEq(ExecState*, EncodedJSValue encodedOp1, EncodedJSValue encodedOp2);
 bool operationCompareStrictEq(ExecState*, EncodedJSValue encodedOp1, EncodedJSValue encodedOp2);
+EncodedJSValue operationResolveGlobal(ExecState*, GlobalResolveInfo*, Identifier*);
+EncodedJSValue operationNewFunctionExpression(ExecState*, FunctionExecutable*);
+
+// These operations are used to call and construct objects that are not JSFunctions. The callee's
+// call frame is at registerOffset from the caller's, and its ReturnPC has already been set up.
+EncodedJSValue operationCallNotJSFunction(ExecState*, EncodedJSValue encodedCallee, int32_t registerOffset, int32_t argCount);
+EncodedJSValue operationConstructNotJSConstruct(ExecState*, EncodedJSValue encodedCallee, int32_t registerOffset, int32_t argCount);
+
+// Called on entry to a function compiled while the SamplingProfiler was running, when it has asked for a sample.
+void operationTakeSample(ExecState*);
+
+#if DFG_OSR_EXIT
+// This method is called on speculation failure; it writes the live bytecode temporaries back
+// to the register file, and returns the address in the baseline JIT code at which to continue.
+void* operationOSRExit(ExecState*, uint32_t exitIndex);
+#endif
 
 // This method is used to lookup an exception hander, keyed by faultLocation, which is
 // the return location from one of the calls out to one of the helper operations above.
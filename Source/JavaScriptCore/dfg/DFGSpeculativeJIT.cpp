@@ -37,6 +37,14 @@ GPRReg SpeculativeJIT::fillSpeculateIntInternal(NodeIndex nodeIndex, DataFormat&
     VirtualRegister virtualRegister = node.virtualRegister;
     GenerationInfo& info = m_generationInfo[virtualRegister];
 
+    // If the baseline JIT has seen this value be something other than an integer,
+    // the speculation check would fail; don't bother generating it.
+    if (node.prediction & ~PredictInt32) {
+        terminateSpeculativeExecution();
+        returnFormat = DataFormatInteger;
+        return allocate();
+    }
+
     switch (info.registerFormat()) {
     case DataFormatNone: {
         GPRReg gpr = allocate();
@@ -239,11 +247,37 @@ GPRReg SpeculativeJIT::fillSpeculateCell(NodeIndex nodeIndex)
     return InvalidGPRReg;
 }
 
+void SpeculativeJIT::widenArrayElementKind(MacroAssembler::RegisterID valueReg, MacroAssembler::RegisterID storageReg)
+{
+    MacroAssembler::Address elementKind(storageReg, OBJECT_OFFSETOF(ArrayStorage, m_elementKind));
+
+    MacroAssembler::Jump isInt32 = m_jit.branchPtr(MacroAssembler::AboveOrEqual, valueReg, JITCompiler::tagTypeNumberRegister);
+    MacroAssembler::Jump isNotNumber = m_jit.branchTestPtr(MacroAssembler::Zero, valueReg, JITCompiler::tagTypeNumberRegister);
+
+    MacroAssembler::Jump alreadyWider = m_jit.branch32(MacroAssembler::NotEqual, elementKind, TrustedImm32(Int32Elements));
+    m_jit.store32(TrustedImm32(DoubleElements), elementKind);
+    MacroAssembler::Jump done = m_jit.jump();
+
+    isNotNumber.link(&m_jit);
+    m_jit.store32(TrustedImm32(ContiguousElements), elementKind);
+
+    isInt32.link(&m_jit);
+    alreadyWider.link(&m_jit);
+    done.link(&m_jit);
+}
+
 bool SpeculativeJIT::compile(Node& node)
 {
     checkConsistency();
     NodeType op = node.op;
 
+    // Arithmetic is only speculated on integers; if the baseline JIT has seen this
+    // operation produce anything else, fall back to the non-speculative path.
+    if ((op == ValueAdd || op == ArithAdd || op == ArithSub || op == ArithMul) && (node.prediction & ~PredictInt32)) {
+        terminateSpeculativeExecution();
+        return false;
+    }
+
     switch (op) {
     case Int32Constant:
     case DoubleConstant:
@@ -611,6 +645,7 @@ bool SpeculativeJIT::compile(Node& node)
         notHoleValue.link(&m_jit);
 
         // Store the value to the array.
+        widenArrayElementKind(valueReg, storageReg);
         m_jit.storePtr(valueReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
 
         noResult(m_compileIndex);
@@ -632,6 +667,7 @@ bool SpeculativeJIT::compile(Node& node)
         MacroAssembler::RegisterID valueReg = value.registerID();
 
         // Store the value to the array.
+        widenArrayElementKind(valueReg, storageReg);
         m_jit.storePtr(valueReg, MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
 
         noResult(m_compileIndex);
@@ -710,6 +746,8 @@ bool SpeculativeJIT::compile(Node& node)
     }
 
     case GetById: {
+        // FIXME: get_by_id and put_by_id are not inline cached by the DFG yet;
+        // they always call out to C++.
         JSValueOperand base(this, node.child1);
         GPRReg baseGPR = base.gpr();
         flushRegisters();
@@ -766,6 +804,69 @@ bool SpeculativeJIT::compile(Node& node)
         noResult(m_compileIndex);
         break;
     }
+
+    case GetScopedVar: {
+        GPRTemporary result(this);
+        MacroAssembler::RegisterID resultReg = result.registerID();
+
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, resultReg);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(MacroAssembler::Address(resultReg, OBJECT_OFFSETOF(ScopeChainNode, next)), resultReg);
+        m_jit.loadPtr(MacroAssembler::Address(resultReg, OBJECT_OFFSETOF(ScopeChainNode, object)), resultReg);
+        m_jit.loadPtr(MacroAssembler::Address(resultReg, JSVariableObject::offsetOfRegisters()), resultReg);
+        m_jit.loadPtr(JITCompiler::addressForGlobalVar(resultReg, node.varNumber()), resultReg);
+
+        jsValueResult(result.gpr(), m_compileIndex);
+        break;
+    }
+
+    case PutScopedVar: {
+        JSValueOperand value(this, node.child1);
+        GPRTemporary temp(this);
+        MacroAssembler::RegisterID tempReg = temp.registerID();
+
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, tempReg);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(MacroAssembler::Address(tempReg, OBJECT_OFFSETOF(ScopeChainNode, next)), tempReg);
+        m_jit.loadPtr(MacroAssembler::Address(tempReg, OBJECT_OFFSETOF(ScopeChainNode, object)), tempReg);
+        m_jit.loadPtr(MacroAssembler::Address(tempReg, JSVariableObject::offsetOfRegisters()), tempReg);
+        m_jit.storePtr(value.registerID(), JITCompiler::addressForGlobalVar(tempReg, node.varNumber()));
+
+        noResult(m_compileIndex);
+        break;
+    }
+
+    case ResolveGlobal: {
+        emitResolveGlobal(node);
+        break;
+    }
+
+    case NewFunctionExpression: {
+        flushRegisters();
+
+        GPRResult result(this);
+        callOperation((J_DFGOperation_EP)operationNewFunctionExpression, result.gpr(), m_jit.codeBlock()->functionExpr(node.functionExpressionIndex()));
+        jsValueResult(result.gpr(), m_compileIndex);
+        break;
+    }
+
+    case SetCallArgument: {
+        JSValueOperand value(this, node.child1);
+        m_jit.storePtr(value.registerID(), JITCompiler::addressFor(static_cast<VirtualRegister>(m_jit.graph().m_callRegisterOffset + node.callArgumentOffset())));
+        noResult(m_compileIndex);
+        break;
+    }
+
+    case Call:
+    case Construct: {
+        emitCall(node);
+        break;
+    }
+
+    case Phantom:
+        // Phantom nodes only keep their child alive; they generate no code.
+        noResult(m_compileIndex);
+        break;
     }
 
     // Check if generation for the speculative path has failed catastrophically. :-)
@@ -175,6 +175,9 @@ private:
     template<bool strict>
     GPRReg fillSpeculateIntInternal(NodeIndex, DataFormat& returnFormat);
 
+    // Widen the element kind of an array's storage to cover a value about to be stored into its vector.
+    void widenArrayElementKind(MacroAssembler::RegisterID valueReg, MacroAssembler::RegisterID storageReg);
+
     // It is possible, during speculative generation, to reach a situation in which we
     // can statically determine a speculation will fail (for example, when two nodes
     // will make conflicting speculations about the same operand). In such cases this
@@ -31,6 +31,7 @@
 #include "JSONObject.h"
 #include "Tracing.h"
 #include <algorithm>
+#include <wtf/CurrentTime.h>
 
 #define COLLECT_ON_EVERY_SLOW_ALLOCATION 0
 
@@ -47,9 +48,14 @@ Heap::Heap(JSGlobalData* globalData)
     , m_activityCallback(DefaultGCActivityCallback::create(this))
     , m_globalData(globalData)
     , m_machineThreads(this)
-    , m_markStack(globalData->jsArrayVPtr)
+    , m_sharedData(globalData->jsArrayVPtr)
+    , m_markStack(m_sharedData)
     , m_handleHeap(globalData)
     , m_extraCost(0)
+#if ENABLE(GGC)
+    , m_nextCollectionIsFull(false)
+    , m_fullCollectionThreshold(minBytesPerCycle)
+#endif
 {
     m_markedSpace.setHighWaterMark(minBytesPerCycle);
     (*m_activityCallback)();
@@ -190,7 +196,28 @@ inline RegisterFile& Heap::registerFile()
     return m_globalData->interpreter->registerFile();
 }
 
-void Heap::markRoots()
+#if ENABLE(GGC)
+class RememberedSetMarker {
+public:
+    RememberedSetMarker(MarkStack&);
+    void operator()(JSCell*);
+
+private:
+    MarkStack& m_markStack;
+};
+
+inline RememberedSetMarker::RememberedSetMarker(MarkStack& markStack)
+    : m_markStack(markStack)
+{
+}
+
+inline void RememberedSetMarker::operator()(JSCell* cell)
+{
+    m_markStack.rescan(cell);
+}
+#endif
+
+void Heap::markRoots(CollectionType collectionType)
 {
 #ifndef NDEBUG
     if (m_globalData->isSharedInstance()) {
@@ -210,6 +237,10 @@ void Heap::markRoots()
     MarkStack& markStack = m_markStack;
     HeapRootMarker heapRootMarker(markStack);
     
+    // Unused free list cells are marked; unmark them before anything
+    // consults the mark bits.
+    m_markedSpace.clearFreeLists();
+
     // We gather conservative roots before clearing mark bits because
     // conservative gathering uses the mark bits from our last mark pass to
     // determine whether a reference is valid.
@@ -219,7 +250,26 @@ void Heap::markRoots()
     ConservativeRoots registerFileRoots(this);
     registerFile().gatherConservativeRoots(registerFileRoots);
 
+#if ENABLE(GGC)
+    // A nursery collection treats every old cell as already marked, so tracing
+    // stops at the old generation. Old cells written to since the last
+    // collection may point at young cells, so they are traced again.
+    if (collectionType == NurseryCollection) {
+        m_markedSpace.resetMarksToOld();
+        RememberedSetMarker rememberedSetMarker(markStack);
+        m_markedSpace.forEachOldCellInDirtyCards(rememberedSetMarker);
+        // Global code stores global variables straight into the register file,
+        // bypassing the write barrier.
+        JSGlobalObject* globalObject = registerFile().globalObject();
+        if (globalObject && isMarked(globalObject))
+            markStack.rescan(globalObject);
+        markStack.drain();
+    } else
+        m_markedSpace.clearMarks();
+#else
+    ASSERT_UNUSED(collectionType, collectionType == FullCollection);
     m_markedSpace.clearMarks();
+#endif
 
     markStack.append(machineThreadRoots);
     markStack.drain();
@@ -262,6 +312,7 @@ void Heap::markRoots()
     } while (lastOpaqueRootCount != markStack.opaqueRootCount());
 
     markStack.reset();
+    m_sharedData.reset();
 
     m_operationInProgress = NoOperation;
 }
@@ -381,6 +432,19 @@ bool Heap::isBusy()
     return m_operationInProgress != NoOperation;
 }
 
+GCEvent::GCEvent()
+    : isFullCollection(true)
+    , didShrink(false)
+    , startTime(0)
+    , markTime(0)
+    , sweepTime(0)
+    , sizeBefore(0)
+    , sizeAfter(0)
+    , capacityBefore(0)
+    , capacityAfter(0)
+{
+}
+
 void Heap::collectAllGarbage()
 {
     reset(DoSweep);
@@ -391,21 +455,56 @@ void Heap::reset(SweepToggle sweepToggle)
     ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
     JAVASCRIPTCORE_GC_BEGIN();
 
-    markRoots();
+    CollectionType collectionType = FullCollection;
+#if ENABLE(GGC)
+    if (sweepToggle == DoNotSweep && !m_nextCollectionIsFull)
+        collectionType = NurseryCollection;
+#endif
+
+    GCEvent event;
+    if (m_gcObserver) {
+        // Free list cells count as allocated until they are returned.
+        m_markedSpace.clearFreeLists();
+        event.isFullCollection = collectionType == FullCollection;
+        event.startTime = currentTime();
+        event.sizeBefore = m_markedSpace.size();
+        event.capacityBefore = m_markedSpace.capacity();
+    }
+
+    markRoots(collectionType);
     m_handleHeap.finalizeWeakHandles();
 
+#if ENABLE(JIT)
+    // Structures that died may be reallocated at the same address.
+    m_globalData->jitStubs->megamorphicGetByIdCache().clear();
+#endif
+
+#if ENABLE(GGC)
+    // Everything that survived is now old.
+    m_markedSpace.promote();
+#endif
+
     JAVASCRIPTCORE_GC_MARKED();
 
+    double sweepStartTime = m_gcObserver ? currentTime() : 0;
+
     m_markedSpace.reset();
     m_extraCost = 0;
 
 #if ENABLE(JSC_ZOMBIES)
+    // Zombies are created by sweeping, so they cannot wait for the allocator.
+    m_markedSpace.sweep();
     sweepToggle = DoSweep;
 #endif
 
+    // The allocator sweeps each block it allocates from, so allocation-triggered
+    // collections leave all sweeping to it. collectAllGarbage() is how embedders
+    // respond to memory pressure, so it also releases empty blocks now, and
+    // queues the survivors so that allocation pays off their sweeping even in
+    // size classes it does not allocate from.
     if (sweepToggle == DoSweep) {
-        m_markedSpace.sweep();
         m_markedSpace.shrink();
+        m_markedSpace.sweepLazily();
     }
 
     // To avoid pathological GC churn in large heaps, we set the allocation high
@@ -415,6 +514,27 @@ void Heap::reset(SweepToggle sweepToggle)
     size_t proportionalBytes = 2 * m_markedSpace.size();
     m_markedSpace.setHighWaterMark(max(proportionalBytes, minBytesPerCycle));
 
+#if ENABLE(GGC)
+    // Nursery collections never free old cells, so once the old generation
+    // has doubled since the last full collection, do a full one.
+    if (collectionType == FullCollection)
+        m_fullCollectionThreshold = max(proportionalBytes, minBytesPerCycle);
+    m_nextCollectionIsFull = m_markedSpace.size() >= m_fullCollectionThreshold;
+#endif
+
+    if (m_gcObserver) {
+        double endTime = currentTime();
+        event.markTime = sweepStartTime - event.startTime;
+        event.sweepTime = endTime - sweepStartTime;
+        event.didShrink = sweepToggle == DoSweep;
+        event.sizeAfter = m_markedSpace.size();
+        event.capacityAfter = m_markedSpace.capacity();
+        m_markedSpace.gatherSizeClassStatistics(event.sizeClasses);
+        if (m_gcObserver->wantsObjectTypeCounts())
+            event.objectTypeCounts = objectTypeCounts();
+        m_gcObserver->didCollect(event);
+    }
+
     JAVASCRIPTCORE_GC_END();
 
     (*m_activityCallback)();
@@ -430,4 +550,9 @@ GCActivityCallback* Heap::activityCallback()
     return m_activityCallback.get();
 }
 
+void Heap::setGCObserver(PassOwnPtr<GCObserver> gcObserver)
+{
+    m_gcObserver = gcObserver;
+}
+
 } // namespace JSC
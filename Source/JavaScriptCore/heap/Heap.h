@@ -29,6 +29,7 @@
 #include <wtf/Forward.h>
 #include <wtf/HashCountedSet.h>
 #include <wtf/HashSet.h>
+#include <wtf/OwnPtr.h>
 
 namespace JSC {
 
@@ -51,6 +52,36 @@ namespace JSC {
 
     enum OperationInProgress { NoOperation, Allocation, Collection };
 
+    // A record of one garbage collection, handed to the heap's GCObserver.
+    struct GCEvent {
+        GCEvent();
+
+        size_t bytesFreed() const { return sizeBefore - sizeAfter; }
+
+        bool isFullCollection;
+        bool didShrink; // True if empty blocks were returned to the block pool.
+        double startTime; // As returned by currentTime().
+        double markTime; // Seconds spent marking and finalizing weak handles.
+        double sweepTime; // Seconds spent shrinking and scheduling the lazy sweep.
+        size_t sizeBefore; // Bytes in cells that were allocated before the collection.
+        size_t sizeAfter;
+        size_t capacityBefore;
+        size_t capacityAfter;
+        Vector<MarkedSpace::SizeClassStatistics> sizeClasses; // Nonempty size classes after the collection.
+        OwnPtr<TypeCountSet> objectTypeCounts; // Surviving cells by class name, if the observer asked for them.
+    };
+
+    class GCObserver {
+    public:
+        virtual ~GCObserver() { }
+
+        // Taking a census walks the whole heap, so it is opt-in.
+        virtual bool wantsObjectTypeCounts() { return false; }
+
+        // Called at the end of every collection. Must not allocate JS objects.
+        virtual void didCollect(const GCEvent&) = 0;
+    };
+
     class Heap {
         WTF_MAKE_NONCOPYABLE(Heap);
     public:
@@ -72,6 +103,9 @@ namespace JSC {
         GCActivityCallback* activityCallback();
         void setActivityCallback(PassOwnPtr<GCActivityCallback>);
 
+        GCObserver* gcObserver() { return m_gcObserver.get(); }
+        void setGCObserver(PassOwnPtr<GCObserver>);
+
         bool isBusy(); // true if an allocation or collection is in progress
         void* allocate(size_t);
         void collectAllGarbage();
@@ -113,7 +147,8 @@ namespace JSC {
         void* allocateSlowCase(size_t);
         void reportExtraMemoryCostSlowCase(size_t);
 
-        void markRoots();
+        enum CollectionType { FullCollection, NurseryCollection };
+        void markRoots(CollectionType);
         void markProtectedObjects(HeapRootMarker&);
         void markTempSortVectors(HeapRootMarker&);
 
@@ -131,15 +166,22 @@ namespace JSC {
         HashSet<MarkedArgumentBuffer*>* m_markListSet;
 
         OwnPtr<GCActivityCallback> m_activityCallback;
+        OwnPtr<GCObserver> m_gcObserver;
 
         JSGlobalData* m_globalData;
         
         MachineThreads m_machineThreads;
+        MarkStackThreadSharedData m_sharedData;
         MarkStack m_markStack;
         HandleHeap m_handleHeap;
         HandleStack m_handleStack;
 
         size_t m_extraCost;
+
+#if ENABLE(GGC)
+        bool m_nextCollectionIsFull;
+        size_t m_fullCollectionThreshold; // Heap size after a nursery collection that triggers a full collection.
+#endif
     };
 
     inline bool Heap::isMarked(const JSCell* cell)
@@ -33,11 +33,106 @@
 #include "JSObject.h"
 #include "ScopeChain.h"
 #include "Structure.h"
+#include <wtf/Atomics.h>
 
 namespace JSC {
 
 size_t MarkStack::s_pageSize = 0;
 
+#if ENABLE(PARALLEL_GC)
+// The most marking threads one heap will start, including the main thread.
+static const unsigned maximumNumberOfMarkers = 4;
+
+// Helper marking threads currently alive across every heap in the process.
+// Each heap reserves its helpers from this budget, which is sized by the
+// number of online cores, so that many JSGlobalData instances do not each
+// spin up their own full set of threads.
+static int volatile s_numberOfHelperMarkingThreads;
+
+static bool reserveHelperMarkingThread()
+{
+    int limit = static_cast<int>(MarkStack::numberOfProcessorCores()) - 1;
+    if (atomicIncrement(&s_numberOfHelperMarkingThreads) <= limit)
+        return true;
+    atomicDecrement(&s_numberOfHelperMarkingThreads);
+    return false;
+}
+
+static void releaseHelperMarkingThreads(unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        atomicDecrement(&s_numberOfHelperMarkingThreads);
+}
+
+// A marker only shares its work when it has at least this many cells or
+// values queued, and never gives away more than half of it.
+static const size_t minimumNumberOfCellsToDonate = 16;
+static const size_t minimumNumberOfValuesToDonate = 256;
+
+// How many cells a marker tries to take from the shared stack at a time.
+static const size_t maximumNumberOfCellsToSteal = 512;
+
+// How often (in cells or value ranges visited) a marker checks whether its
+// peers are starved.
+static const unsigned donationCheckInterval = 64;
+
+void* MarkStackThreadSharedData::markingThreadStartFunc(void* sharedData)
+{
+    static_cast<MarkStackThreadSharedData*>(sharedData)->markingThreadMain();
+    return 0;
+}
+
+void MarkStackThreadSharedData::markingThreadMain()
+{
+    MarkStack markStack(*this);
+    markStack.drainFromShared(MarkStack::SlaveDrain);
+}
+#endif
+
+MarkStackThreadSharedData::MarkStackThreadSharedData(void* jsArrayVPtr)
+    : m_jsArrayVPtr(jsArrayVPtr)
+    , m_numberOfActiveParallelMarkers(0)
+    , m_parallelMarkersShouldExit(false)
+{
+#if ENABLE(PARALLEL_GC)
+    unsigned numberOfMarkers = std::min(MarkStack::numberOfProcessorCores(), maximumNumberOfMarkers);
+    for (unsigned i = 1; i < numberOfMarkers; ++i) {
+        if (!reserveHelperMarkingThread())
+            break;
+        ThreadIdentifier thread = createThread(markingThreadStartFunc, this, "JavaScriptCore::Marking");
+        if (!thread) {
+            releaseHelperMarkingThreads(1);
+            break;
+        }
+        m_markingThreads.append(thread);
+    }
+#endif
+}
+
+MarkStackThreadSharedData::~MarkStackThreadSharedData()
+{
+#if ENABLE(PARALLEL_GC)
+    // Destroy our marking threads.
+    {
+        MutexLocker locker(m_markingLock);
+        m_parallelMarkersShouldExit = true;
+        m_markingCondition.broadcast();
+    }
+    for (unsigned i = 0; i < m_markingThreads.size(); ++i)
+        waitForThreadCompletion(m_markingThreads[i], 0);
+    releaseHelperMarkingThreads(m_markingThreads.size());
+#endif
+}
+
+void MarkStackThreadSharedData::reset()
+{
+    ASSERT(!m_numberOfActiveParallelMarkers);
+    ASSERT(sharedStacksAreEmpty());
+    m_sharedMarkStack.shrinkAllocation(MarkStack::pageSize());
+    m_sharedMarkSets.shrinkAllocation(MarkStack::pageSize());
+    m_opaqueRoots.clear();
+}
+
 void MarkStack::reset()
 {
     ASSERT(s_pageSize);
@@ -83,13 +178,36 @@ inline void MarkStack::markChildren(JSCell* cell)
 }
 
 void MarkStack::drain()
+{
+    drainLocal();
+
+#if ENABLE(PARALLEL_GC)
+    // Help the other markers finish whatever we donated to them, and wait for
+    // them to go idle, so that the heap is fully marked when we return.
+    if (!m_shared.m_markingThreads.isEmpty())
+        drainFromShared(MasterDrain);
+    else
+        mergeOpaqueRoots();
+#endif
+}
+
+void MarkStack::drainLocal()
 {
 #if !ASSERT_DISABLED
     ASSERT(!m_isDraining);
     m_isDraining = true;
+#endif
+#if ENABLE(PARALLEL_GC)
+    unsigned countdown = donationCheckInterval;
 #endif
     while (!m_markSets.isEmpty() || !m_values.isEmpty()) {
         while (!m_markSets.isEmpty() && m_values.size() < 50) {
+#if ENABLE(PARALLEL_GC)
+            if (!--countdown) {
+                countdown = donationCheckInterval;
+                donateKnownParallel();
+            }
+#endif
             ASSERT(!m_markSets.isEmpty());
             MarkSet& current = m_markSets.last();
             ASSERT(current.m_values);
@@ -124,12 +242,127 @@ void MarkStack::drain()
 
             markChildren(cell);
         }
-        while (!m_values.isEmpty())
+        while (!m_values.isEmpty()) {
             markChildren(m_values.removeLast());
+#if ENABLE(PARALLEL_GC)
+            if (!--countdown) {
+                countdown = donationCheckInterval;
+                donateKnownParallel();
+            }
+#endif
+        }
     }
 #if !ASSERT_DISABLED
     m_isDraining = false;
 #endif
 }
 
+#if ENABLE(PARALLEL_GC)
+void MarkStack::donateKnownParallel()
+{
+    if (m_shared.m_markingThreads.isEmpty())
+        return;
+
+    // Only donate when the shared stacks have run dry and we have plenty of
+    // work; otherwise the locking costs more than it saves.
+    if (!m_shared.sharedStacksAreEmpty())
+        return;
+
+    bool hasCellsToDonate = m_values.size() >= minimumNumberOfCellsToDonate;
+    bool hasMarkSetsToDonate = m_markSets.size() > 1
+        || (!m_markSets.isEmpty() && static_cast<size_t>(m_markSets.last().m_end - m_markSets.last().m_values) >= minimumNumberOfValuesToDonate);
+    if (!hasCellsToDonate && !hasMarkSetsToDonate)
+        return;
+
+    if (!m_shared.m_markingLock.tryLock())
+        return;
+
+    if (m_shared.sharedStacksAreEmpty()) {
+        if (hasCellsToDonate)
+            m_values.donateTo(m_shared.m_sharedMarkStack, m_values.size() / 2);
+
+        if (m_markSets.size() > 1)
+            m_markSets.donateTo(m_shared.m_sharedMarkSets, m_markSets.size() / 2);
+        else if (hasMarkSetsToDonate) {
+            // A single large range, such as the storage of a big array: give away its back half.
+            MarkSet& current = m_markSets.last();
+            JSValue* middle = current.m_values + (current.m_end - current.m_values) / 2;
+            m_shared.m_sharedMarkSets.append(MarkSet(middle, current.m_end, current.m_properties));
+            current.m_end = middle;
+        }
+
+        m_shared.m_markingCondition.broadcast();
+    }
+
+    m_shared.m_markingLock.unlock();
+}
+
+void MarkStack::stealSomeWork()
+{
+    if (!m_shared.m_sharedMarkSets.isEmpty())
+        m_markSets.append(m_shared.m_sharedMarkSets.removeLast());
+
+    // Leave a share of the remaining cells for each of the other markers.
+    MarkStackArray<JSCell*>& sharedMarkStack = m_shared.m_sharedMarkStack;
+    if (sharedMarkStack.isEmpty())
+        return;
+    size_t count = std::min(sharedMarkStack.size() / m_shared.numberOfMarkers() + 1, maximumNumberOfCellsToSteal);
+    for (size_t i = 0; i < count; ++i)
+        m_values.append(sharedMarkStack.removeLast());
+}
+
+void MarkStack::mergeOpaqueRoots()
+{
+    if (m_opaqueRoots.isEmpty())
+        return;
+    HashSet<void*>::iterator end = m_opaqueRoots.end();
+    for (HashSet<void*>::iterator it = m_opaqueRoots.begin(); it != end; ++it)
+        m_shared.m_opaqueRoots.add(*it);
+    m_opaqueRoots.clear();
+}
+
+void MarkStack::drainFromShared(SharedDrainMode sharedDrainMode)
+{
+    {
+        MutexLocker locker(m_shared.m_markingLock);
+        m_shared.m_numberOfActiveParallelMarkers++;
+    }
+    while (true) {
+        {
+            MutexLocker locker(m_shared.m_markingLock);
+            mergeOpaqueRoots();
+            m_shared.m_numberOfActiveParallelMarkers--;
+
+            if (sharedDrainMode == MasterDrain) {
+                // Wait until either marking has terminated or there is work for us to do.
+                while (true) {
+                    if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.sharedStacksAreEmpty())
+                        return;
+                    if (!m_shared.sharedStacksAreEmpty())
+                        break;
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+                }
+            } else {
+                ASSERT(sharedDrainMode == SlaveDrain);
+
+                // If we were the last marker to go idle, marking has terminated; let the master know.
+                if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.sharedStacksAreEmpty())
+                    m_shared.m_markingCondition.broadcast();
+
+                while (m_shared.sharedStacksAreEmpty() && !m_shared.m_parallelMarkersShouldExit)
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+
+                if (m_shared.m_parallelMarkersShouldExit)
+                    return;
+            }
+
+            stealSomeWork();
+            m_shared.m_numberOfActiveParallelMarkers++;
+        }
+
+        drainLocal();
+    }
+}
+#endif
+
 } // namespace JSC
@@ -33,32 +33,97 @@
 #include <wtf/Vector.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/OSAllocator.h>
+#include <wtf/Threading.h>
 
 namespace JSC {
 
     class ConservativeRoots;
     class JSGlobalData;
+    class MarkStack;
     class Register;
     
     enum MarkSetProperties { MayContainNullValues, NoNullValues };
+
+    struct MarkSet {
+        MarkSet(JSValue* values, JSValue* end, MarkSetProperties properties)
+            : m_values(values)
+            , m_end(end)
+            , m_properties(properties)
+        {
+            ASSERT(values);
+        }
+        JSValue* m_values;
+        JSValue* m_end;
+        MarkSetProperties m_properties;
+    };
+
+    template <typename T> class MarkStackArray {
+        WTF_MAKE_NONCOPYABLE(MarkStackArray);
+    public:
+        MarkStackArray();
+        ~MarkStackArray();
+
+        void expand();
+        void append(const T&);
+        T removeLast();
+        T& last();
+        bool isEmpty();
+        size_t size();
+        void shrinkAllocation(size_t);
+
+        // Moves count entries from the bottom of this stack, where the oldest and
+        // typically largest units of outstanding work live, onto other.
+        void donateTo(MarkStackArray<T>& other, size_t count);
+
+    private:
+        size_t m_top;
+        size_t m_allocated;
+        size_t m_capacity;
+        T* m_data;
+    };
+
+    // State shared by all the MarkStacks that take part in one collection. With
+    // ENABLE(PARALLEL_GC), this owns the helper marking threads and the shared
+    // stacks of cells and value ranges that they steal work from.
+    class MarkStackThreadSharedData {
+        WTF_MAKE_NONCOPYABLE(MarkStackThreadSharedData);
+    public:
+        MarkStackThreadSharedData(void* jsArrayVPtr);
+        ~MarkStackThreadSharedData();
+
+        void reset();
+
+        size_t numberOfMarkers() const { return m_markingThreads.size() + 1; }
+
+    private:
+        friend class MarkStack;
+
+#if ENABLE(PARALLEL_GC)
+        static void* markingThreadStartFunc(void* sharedData);
+        void markingThreadMain();
+#endif
+
+        bool sharedStacksAreEmpty() { return m_sharedMarkStack.isEmpty() && m_sharedMarkSets.isEmpty(); }
+
+        void* m_jsArrayVPtr;
+
+        Vector<ThreadIdentifier> m_markingThreads;
+
+        Mutex m_markingLock;
+        ThreadCondition m_markingCondition;
+        MarkStackArray<JSCell*> m_sharedMarkStack;
+        MarkStackArray<MarkSet> m_sharedMarkSets;
+        unsigned m_numberOfActiveParallelMarkers;
+        bool m_parallelMarkersShouldExit;
+
+        HashSet<void*> m_opaqueRoots; // Guarded by m_markingLock while markers are running.
+    };
     
     class MarkStack {
         WTF_MAKE_NONCOPYABLE(MarkStack);
     public:
-        MarkStack(void* jsArrayVPtr)
-            : m_jsArrayVPtr(jsArrayVPtr)
-#if !ASSERT_DISABLED
-            , m_isCheckingForDefaultMarkViolation(false)
-            , m_isDraining(false)
-#endif
-        {
-        }
-
-        ~MarkStack()
-        {
-            ASSERT(m_markSets.isEmpty());
-            ASSERT(m_values.isEmpty());
-        }
+        MarkStack(MarkStackThreadSharedData&);
+        ~MarkStack();
 
         void deprecatedAppend(JSCell**);
         template <typename T> void append(WriteBarrierBase<T>*);
@@ -72,15 +137,25 @@ namespace JSC {
         
         void append(ConservativeRoots&);
 
+#if ENABLE(GGC)
+        // Visits the children of a cell that is already marked.
+        void rescan(JSCell* cell) { m_values.append(cell); }
+#endif
+
         bool addOpaqueRoot(void* root) { return m_opaqueRoots.add(root).second; }
-        bool containsOpaqueRoot(void* root) { return m_opaqueRoots.contains(root); }
-        int opaqueRootCount() { return m_opaqueRoots.size(); }
+        bool containsOpaqueRoot(void* root);
+        int opaqueRootCount();
 
         void drain();
         void reset();
 
+        static unsigned numberOfProcessorCores();
+
     private:
         friend class HeapRootMarker; // Allowed to mark a JSValue* or JSCell** directly.
+        friend class MarkStackThreadSharedData;
+        template <typename T> friend class MarkStackArray;
+
         void append(JSValue*);
         void append(JSValue*, size_t count);
         void append(JSCell**);
@@ -89,18 +164,15 @@ namespace JSC {
         void internalAppend(JSValue);
         void markChildren(JSCell*);
 
-        struct MarkSet {
-            MarkSet(JSValue* values, JSValue* end, MarkSetProperties properties)
-                : m_values(values)
-                , m_end(end)
-                , m_properties(properties)
-            {
-                ASSERT(values);
-            }
-            JSValue* m_values;
-            JSValue* m_end;
-            MarkSetProperties m_properties;
-        };
+        void drainLocal();
+
+#if ENABLE(PARALLEL_GC)
+        enum SharedDrainMode { SlaveDrain, MasterDrain };
+        void drainFromShared(SharedDrainMode);
+        void donateKnownParallel();
+        void stealSomeWork();
+        void mergeOpaqueRoots();
+#endif
 
         static void* allocateStack(size_t size) { return OSAllocator::reserveAndCommit(size); }
         static void releaseStack(void* addr, size_t size) { OSAllocator::decommitAndRelease(addr, size); }
@@ -113,82 +185,7 @@ namespace JSC {
             return s_pageSize;
         }
 
-        template <typename T> struct MarkStackArray {
-            MarkStackArray()
-                : m_top(0)
-                , m_allocated(MarkStack::pageSize())
-                , m_capacity(m_allocated / sizeof(T))
-            {
-                m_data = reinterpret_cast<T*>(allocateStack(m_allocated));
-            }
-
-            ~MarkStackArray()
-            {
-                releaseStack(m_data, m_allocated);
-            }
-
-            void expand()
-            {
-                size_t oldAllocation = m_allocated;
-                m_allocated *= 2;
-                m_capacity = m_allocated / sizeof(T);
-                void* newData = allocateStack(m_allocated);
-                memcpy(newData, m_data, oldAllocation);
-                releaseStack(m_data, oldAllocation);
-                m_data = reinterpret_cast<T*>(newData);
-            }
-
-            inline void append(const T& v)
-            {
-                if (m_top == m_capacity)
-                    expand();
-                m_data[m_top++] = v;
-            }
-
-            inline T removeLast()
-            {
-                ASSERT(m_top);
-                return m_data[--m_top];
-            }
-            
-            inline T& last()
-            {
-                ASSERT(m_top);
-                return m_data[m_top - 1];
-            }
-
-            inline bool isEmpty()
-            {
-                return m_top == 0;
-            }
-
-            inline size_t size() { return m_top; }
-
-            inline void shrinkAllocation(size_t size)
-            {
-                ASSERT(size <= m_allocated);
-                ASSERT(0 == (size % MarkStack::pageSize()));
-                if (size == m_allocated)
-                    return;
-#if OS(WINDOWS) || OS(SYMBIAN) || PLATFORM(BREWMP)
-                // We cannot release a part of a region with VirtualFree.  To get around this,
-                // we'll release the entire region and reallocate the size that we want.
-                releaseStack(m_data, m_allocated);
-                m_data = reinterpret_cast<T*>(allocateStack(size));
-#else
-                releaseStack(reinterpret_cast<char*>(m_data) + size, m_allocated - size);
-#endif
-                m_allocated = size;
-                m_capacity = m_allocated / sizeof(T);
-            }
-
-        private:
-            size_t m_top;
-            size_t m_allocated;
-            size_t m_capacity;
-            T* m_data;
-        };
-
+        MarkStackThreadSharedData& m_shared;
         void* m_jsArrayVPtr;
         MarkStackArray<MarkSet> m_markSets;
         MarkStackArray<JSCell*> m_values;
@@ -202,6 +199,122 @@ namespace JSC {
 #endif
     };
 
+    template <typename T> inline MarkStackArray<T>::MarkStackArray()
+        : m_top(0)
+        , m_allocated(MarkStack::pageSize())
+        , m_capacity(m_allocated / sizeof(T))
+    {
+        m_data = reinterpret_cast<T*>(MarkStack::allocateStack(m_allocated));
+    }
+
+    template <typename T> inline MarkStackArray<T>::~MarkStackArray()
+    {
+        MarkStack::releaseStack(m_data, m_allocated);
+    }
+
+    template <typename T> inline void MarkStackArray<T>::expand()
+    {
+        size_t oldAllocation = m_allocated;
+        m_allocated *= 2;
+        m_capacity = m_allocated / sizeof(T);
+        void* newData = MarkStack::allocateStack(m_allocated);
+        memcpy(newData, m_data, oldAllocation);
+        MarkStack::releaseStack(m_data, oldAllocation);
+        m_data = reinterpret_cast<T*>(newData);
+    }
+
+    template <typename T> inline void MarkStackArray<T>::append(const T& v)
+    {
+        if (m_top == m_capacity)
+            expand();
+        m_data[m_top++] = v;
+    }
+
+    template <typename T> inline T MarkStackArray<T>::removeLast()
+    {
+        ASSERT(m_top);
+        return m_data[--m_top];
+    }
+    
+    template <typename T> inline T& MarkStackArray<T>::last()
+    {
+        ASSERT(m_top);
+        return m_data[m_top - 1];
+    }
+
+    template <typename T> inline bool MarkStackArray<T>::isEmpty()
+    {
+        return m_top == 0;
+    }
+
+    template <typename T> inline size_t MarkStackArray<T>::size()
+    {
+        return m_top;
+    }
+
+    template <typename T> inline void MarkStackArray<T>::shrinkAllocation(size_t size)
+    {
+        ASSERT(size <= m_allocated);
+        ASSERT(0 == (size % MarkStack::pageSize()));
+        if (size == m_allocated)
+            return;
+#if OS(WINDOWS) || OS(SYMBIAN) || PLATFORM(BREWMP)
+        // We cannot release a part of a region with VirtualFree.  To get around this,
+        // we'll release the entire region and reallocate the size that we want.
+        MarkStack::releaseStack(m_data, m_allocated);
+        m_data = reinterpret_cast<T*>(MarkStack::allocateStack(size));
+#else
+        MarkStack::releaseStack(reinterpret_cast<char*>(m_data) + size, m_allocated - size);
+#endif
+        m_allocated = size;
+        m_capacity = m_allocated / sizeof(T);
+    }
+
+    template <typename T> inline void MarkStackArray<T>::donateTo(MarkStackArray<T>& other, size_t count)
+    {
+        ASSERT(count <= m_top);
+        for (size_t i = 0; i < count; ++i)
+            other.append(m_data[i]);
+        memmove(m_data, m_data + count, (m_top - count) * sizeof(T));
+        m_top -= count;
+    }
+
+    inline MarkStack::MarkStack(MarkStackThreadSharedData& shared)
+        : m_shared(shared)
+        , m_jsArrayVPtr(shared.m_jsArrayVPtr)
+#if !ASSERT_DISABLED
+        , m_isCheckingForDefaultMarkViolation(false)
+        , m_isDraining(false)
+#endif
+    {
+    }
+
+    inline MarkStack::~MarkStack()
+    {
+        ASSERT(m_markSets.isEmpty());
+        ASSERT(m_values.isEmpty());
+    }
+
+    inline bool MarkStack::containsOpaqueRoot(void* root)
+    {
+#if ENABLE(PARALLEL_GC)
+        ASSERT(m_opaqueRoots.isEmpty());
+        return m_shared.m_opaqueRoots.contains(root);
+#else
+        return m_opaqueRoots.contains(root);
+#endif
+    }
+
+    inline int MarkStack::opaqueRootCount()
+    {
+#if ENABLE(PARALLEL_GC)
+        ASSERT(m_opaqueRoots.isEmpty());
+        return m_shared.m_opaqueRoots.size();
+#else
+        return m_opaqueRoots.size();
+#endif
+    }
+
     inline void MarkStack::append(JSValue* slot, size_t count)
     {
         if (!count)
@@ -33,6 +33,11 @@ void MarkStack::initializePagesize()
     MarkStack::s_pageSize = page_size;
 }
 
+unsigned MarkStack::numberOfProcessorCores()
+{
+    return 1;
+}
+
 }
 
 #endif
@@ -39,6 +39,13 @@ void MarkStack::initializePagesize()
     MarkStack::s_pageSize = system_info.dwPageSize;
 }
 
+unsigned MarkStack::numberOfProcessorCores()
+{
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    return system_info.dwNumberOfProcessors;
+}
+
 }
 
 #endif
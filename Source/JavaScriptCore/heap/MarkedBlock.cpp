@@ -41,28 +41,76 @@ MarkedBlock* MarkedBlock::create(JSGlobalData* globalData, size_t cellSize)
     return new (allocation.base()) MarkedBlock(allocation, globalData, cellSize);
 }
 
+MarkedBlock* MarkedBlock::recycle(MarkedBlock* block, JSGlobalData* globalData, size_t cellSize)
+{
+    PageAllocationAligned allocation = block->m_allocation;
+    return new (allocation.base()) MarkedBlock(allocation, globalData, cellSize);
+}
+
 void MarkedBlock::destroy(MarkedBlock* block)
 {
-    for (size_t i = block->firstAtom(); i < block->m_endAtom; i += block->m_atomsPerCell)
-        reinterpret_cast<JSCell*>(&block->atoms()[i])->~JSCell();
-    block->m_allocation.deallocate();
+    block->destroyCells();
+    release(block);
+}
+
+void MarkedBlock::release(MarkedBlock* block)
+{
+    PageAllocationAligned allocation = block->m_allocation;
+    allocation.deallocate();
+}
+
+void MarkedBlock::destroyCells()
+{
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell)
+        reinterpret_cast<JSCell*>(&atoms()[i])->~JSCell();
 }
 
 MarkedBlock::MarkedBlock(const PageAllocationAligned& allocation, JSGlobalData* globalData, size_t cellSize)
-    : m_nextAtom(firstAtom())
-    , m_allocation(allocation)
+    : m_allocation(allocation)
     , m_heap(&globalData->heap)
     , m_prev(0)
     , m_next(0)
+    , m_needsSweep(false)
 {
     m_atomsPerCell = (cellSize + atomSize - 1) / atomSize;
     m_endAtom = atomsPerBlock - m_atomsPerCell + 1;
+#if ENABLE(GGC)
+    memset(m_cards, 0, sizeof(m_cards));
+#endif
 
     Structure* dummyMarkableCellStructure = globalData->dummyMarkableCellStructure.get();
     for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell)
         new (&atoms()[i]) JSCell(*globalData, dummyMarkableCellStructure);
 }
 
+MarkedBlock::FreeCell* MarkedBlock::sweepToFreeList()
+{
+    FreeCell* head = 0;
+    FreeCell** tail = &head;
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+        // Free cells are marked up front, so allocating one is just a pop.
+        if (m_marks.testAndSet(i))
+            continue;
+
+        JSCell* cell = reinterpret_cast<JSCell*>(&atoms()[i]);
+        // After sweep(), unmarked cells are already placeholders.
+        if (m_needsSweep)
+            cell->~JSCell();
+        FreeCell* freeCell = reinterpret_cast<FreeCell*>(cell);
+        *tail = freeCell;
+        tail = &freeCell->next;
+    }
+    *tail = 0;
+    m_needsSweep = false;
+    return head;
+}
+
+void MarkedBlock::reclaimFreeCell(FreeCell* freeCell)
+{
+    m_marks.clear(atomNumber(freeCell));
+    new (freeCell) JSCell(*m_heap->globalData(), m_heap->globalData()->dummyMarkableCellStructure.get());
+}
+
 void MarkedBlock::sweep()
 {
     Structure* dummyMarkableCellStructure = m_heap->globalData()->dummyMarkableCellStructure.get();
@@ -84,6 +132,7 @@ void MarkedBlock::sweep()
         new (cell) JSCell(*m_heap->globalData(), dummyMarkableCellStructure);
 #endif
     }
+    m_needsSweep = false;
 }
 
 } // namespace JSC
@@ -40,8 +40,17 @@ namespace JSC {
     public:
         static const size_t atomSize = sizeof(double); // Ensures natural alignment for all built-in types.
 
+        // A dead cell handed out by the allocator. Free cells are marked, so
+        // nothing else will touch them, but they are not constructed JSCells;
+        // MarkedSpace::clearFreeLists() must run before the heap is inspected.
+        struct FreeCell {
+            FreeCell* next;
+        };
+
         static MarkedBlock* create(JSGlobalData*, size_t cellSize);
+        static MarkedBlock* recycle(MarkedBlock*, JSGlobalData*, size_t cellSize);
         static void destroy(MarkedBlock*);
+        static void release(MarkedBlock*); // Frees the block's memory without running cell destructors; safe on any thread.
 
         static bool isAtomAligned(const void*);
         static MarkedBlock* blockFor(const void*);
@@ -54,9 +63,11 @@ namespace JSC {
         MarkedBlock* prev() const;
         MarkedBlock* next() const;
         
-        void* allocate();
-        void reset();
+        FreeCell* sweepToFreeList();
+        void reclaimFreeCell(FreeCell*);
         void sweep();
+        bool needsSweep();
+        void destroyCells();
         
         bool isEmpty();
 
@@ -76,10 +87,32 @@ namespace JSC {
         
         template <typename Functor> void forEach(Functor&);
 
-    private:
         static const size_t blockSize = 16 * KB;
         static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
 
+#if ENABLE(GGC)
+        // Cells that survived a collection are old. Storing into an old cell
+        // dirties the card holding its header, so nursery collections can find
+        // old-to-young pointers without scanning the old generation.
+        static const size_t cardShift = 7;
+        static const size_t bytesPerCard = 1 << cardShift;
+        static const size_t cardsPerBlock = blockSize / bytesPerCard;
+        typedef uint32_t Card; // Word-sized so JIT code can dirty a card with a plain 32-bit store.
+
+        static ptrdiff_t offsetOfCards() { return OBJECT_OFFSETOF(MarkedBlock, m_cards); }
+
+        bool isOld(const void*);
+        Card* cardFor(const void*);
+        void setCardDirty(const void*);
+        bool hasDirtyCards();
+
+        void resetMarksToOld();
+        void promote();
+
+        template <typename Functor> void forEachOldCellInDirtyCards(Functor&);
+#endif
+
+    private:
         static const size_t atomMask = ~(atomSize - 1); // atomSize must be a power of two.
         
         static const size_t atomsPerBlock = blockSize / atomSize;
@@ -89,14 +122,18 @@ namespace JSC {
         MarkedBlock(const PageAllocationAligned&, JSGlobalData*, size_t cellSize);
         Atom* atoms();
 
-        size_t m_nextAtom;
         size_t m_endAtom; // This is a fuzzy end. Always test for < m_endAtom.
         size_t m_atomsPerCell;
         WTF::Bitmap<blockSize / atomSize> m_marks;
+#if ENABLE(GGC)
+        WTF::Bitmap<blockSize / atomSize> m_oldMarks;
+        Card m_cards[cardsPerBlock];
+#endif
         PageAllocationAligned m_allocation;
         Heap* m_heap;
         MarkedBlock* m_prev;
         MarkedBlock* m_next;
+        bool m_needsSweep; // True if unmarked cells may still need their destructors run.
     };
 
     inline size_t MarkedBlock::firstAtom()
@@ -144,19 +181,20 @@ namespace JSC {
         return m_next;
     }
 
-    inline void MarkedBlock::reset()
+    inline bool MarkedBlock::isEmpty()
     {
-        m_nextAtom = firstAtom();
+        return m_marks.isEmpty();
     }
 
-    inline bool MarkedBlock::isEmpty()
+    inline bool MarkedBlock::needsSweep()
     {
-        return m_marks.isEmpty();
+        return m_needsSweep;
     }
 
     inline void MarkedBlock::clearMarks()
     {
         m_marks.clearAll();
+        m_needsSweep = true;
     }
     
     inline size_t MarkedBlock::markCount()
@@ -202,7 +240,12 @@ namespace JSC {
 
     inline bool MarkedBlock::testAndSetMarked(const void* p)
     {
+#if ENABLE(PARALLEL_GC)
+        // Several marking threads may race to mark cells in the same block.
+        return m_marks.concurrentTestAndSet(atomNumber(p));
+#else
         return m_marks.testAndSet(atomNumber(p));
+#endif
     }
 
     inline void MarkedBlock::setMarked(const void* p)
@@ -219,6 +262,56 @@ namespace JSC {
         }
     }
 
+#if ENABLE(GGC)
+    inline bool MarkedBlock::isOld(const void* p)
+    {
+        return m_oldMarks.get(atomNumber(p));
+    }
+
+    inline MarkedBlock::Card* MarkedBlock::cardFor(const void* p)
+    {
+        return &m_cards[(reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(this)) >> cardShift];
+    }
+
+    inline void MarkedBlock::setCardDirty(const void* p)
+    {
+        *cardFor(p) = 1;
+    }
+
+    inline bool MarkedBlock::hasDirtyCards()
+    {
+        for (size_t i = 0; i < cardsPerBlock; ++i) {
+            if (m_cards[i])
+                return true;
+        }
+        return false;
+    }
+
+    inline void MarkedBlock::resetMarksToOld()
+    {
+        m_marks = m_oldMarks;
+        m_needsSweep = true;
+    }
+
+    inline void MarkedBlock::promote()
+    {
+        m_oldMarks = m_marks;
+        memset(m_cards, 0, sizeof(m_cards));
+    }
+
+    template <typename Functor> inline void MarkedBlock::forEachOldCellInDirtyCards(Functor& functor)
+    {
+        if (!hasDirtyCards())
+            return;
+
+        for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
+            if (!m_oldMarks.get(i) || !*cardFor(&atoms()[i]))
+                continue;
+            functor(reinterpret_cast<JSCell*>(&atoms()[i]));
+        }
+    }
+#endif
+
 } // namespace JSC
 
 #endif // MarkedSpace_h
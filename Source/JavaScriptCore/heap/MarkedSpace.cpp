@@ -26,33 +26,112 @@
 #include "JSLock.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
+#include <wtf/CurrentTime.h>
 
 namespace JSC {
 
 class Structure;
 
+// How often the block freeing thread wakes up, while there are free blocks,
+// to return half of them to the OS. Blocks freed in bursts by shrink() are
+// thus usually reused by the allocator rather than released and re-mapped.
+// With no free blocks the thread sleeps until shrink() hands it some.
+static const double blockFreeingThreadInterval = 1.0; // seconds
+
 MarkedSpace::MarkedSpace(JSGlobalData* globalData)
     : m_waterMark(0)
     , m_highWaterMark(0)
     , m_globalData(globalData)
+    , m_numberOfFreeBlocks(0)
+    , m_blockFreeingThreadShouldQuit(false)
 {
     for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
         sizeClassFor(cellSize).cellSize = cellSize;
 
     for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
         sizeClassFor(cellSize).cellSize = cellSize;
+
+    m_blockFreeingThread = createThread(blockFreeingThreadStartFunc, this, "JavaScriptCore::BlockFree");
 }
 
 void MarkedSpace::destroy()
 {
+    clearFreeLists();
     clearMarks();
     shrink();
     ASSERT(!size());
+
+    if (m_blockFreeingThread) {
+        {
+            MutexLocker locker(m_freeBlockLock);
+            m_blockFreeingThreadShouldQuit = true;
+            m_freeBlockCondition.signal();
+        }
+        waitForThreadCompletion(m_blockFreeingThread, 0);
+    }
+
+    releaseFreeBlocks(0);
+}
+
+void* MarkedSpace::blockFreeingThreadStartFunc(void* markedSpace)
+{
+    static_cast<MarkedSpace*>(markedSpace)->blockFreeingThreadMain();
+    return 0;
+}
+
+void MarkedSpace::blockFreeingThreadMain()
+{
+    while (true) {
+        size_t numberOfBlocksToKeep;
+        {
+            MutexLocker locker(m_freeBlockLock);
+            while (!m_numberOfFreeBlocks && !m_blockFreeingThreadShouldQuit)
+                m_freeBlockCondition.wait(m_freeBlockLock);
+            if (!m_blockFreeingThreadShouldQuit)
+                m_freeBlockCondition.timedWait(m_freeBlockLock, currentTime() + blockFreeingThreadInterval);
+            if (m_blockFreeingThreadShouldQuit)
+                return;
+            numberOfBlocksToKeep = m_numberOfFreeBlocks / 2;
+        }
+
+        // Free blocks hold no live cells, so releasing them needs neither the
+        // JSLock nor the mutator's cooperation.
+        releaseFreeBlocks(numberOfBlocksToKeep);
+    }
+}
+
+void MarkedSpace::releaseFreeBlocks(size_t numberOfBlocksToKeep)
+{
+    while (true) {
+        MarkedBlock* block;
+        {
+            MutexLocker locker(m_freeBlockLock);
+            if (m_numberOfFreeBlocks <= numberOfBlocksToKeep)
+                return;
+            block = m_freeBlocks.head();
+            m_freeBlocks.remove(block);
+            --m_numberOfFreeBlocks;
+        }
+        MarkedBlock::release(block);
+    }
 }
 
 MarkedBlock* MarkedSpace::allocateBlock(SizeClass& sizeClass)
 {
-    MarkedBlock* block = MarkedBlock::create(globalData(), sizeClass.cellSize);
+    MarkedBlock* block = 0;
+    {
+        MutexLocker locker(m_freeBlockLock);
+        if (m_numberOfFreeBlocks) {
+            block = m_freeBlocks.head();
+            m_freeBlocks.remove(block);
+            --m_numberOfFreeBlocks;
+        }
+    }
+
+    if (block)
+        block = MarkedBlock::recycle(block, globalData(), sizeClass.cellSize);
+    else
+        block = MarkedBlock::create(globalData(), sizeClass.cellSize);
     sizeClass.blockList.append(block);
     sizeClass.nextBlock = block;
     m_blocks.add(block);
@@ -68,27 +147,62 @@ void MarkedSpace::freeBlocks(DoublyLinkedList<MarkedBlock>& blocks)
 
         blocks.remove(block);
         m_blocks.remove(block);
-        MarkedBlock::destroy(block);
+
+        // Cell destructors may touch the heap, so they run here on the
+        // mutator. Returning the memory to the OS is left to the block
+        // freeing thread.
+        block->destroyCells();
+        if (!m_blockFreeingThread) {
+            MarkedBlock::release(block);
+            continue;
+        }
+
+        MutexLocker locker(m_freeBlockLock);
+        m_freeBlocks.append(block);
+        if (!m_numberOfFreeBlocks++)
+            m_freeBlockCondition.signal();
     }
 }
 
 void* MarkedSpace::allocateFromSizeClass(SizeClass& sizeClass)
 {
-    for (MarkedBlock*& block = sizeClass.nextBlock ; block; block = block->next()) {
-        if (void* result = block->allocate())
-            return result;
+    ASSERT(!sizeClass.firstFreeCell);
+
+    while (true) {
+        MarkedBlock* block = sizeClass.nextBlock;
+        if (!block) {
+            if (m_waterMark >= m_highWaterMark)
+                return 0;
+            block = allocateBlock(sizeClass);
+        }
+        sizeClass.nextBlock = block->next();
 
         m_waterMark += block->capacity();
-    }
 
-    if (m_waterMark < m_highWaterMark)
-        return allocateBlock(sizeClass)->allocate();
+        // Pay off some of the sweeping deferred by collectAllGarbage(), one
+        // block for every block we start allocating from. Blocks the allocator
+        // has already swept to a free list are skipped rather than swept twice.
+        while (!m_blocksToSweep.isEmpty()) {
+            MarkedBlock* blockToSweep = m_blocksToSweep.last();
+            m_blocksToSweep.removeLast();
+            if (blockToSweep->needsSweep()) {
+                blockToSweep->sweep();
+                break;
+            }
+        }
 
-    return 0;
+        if (MarkedBlock::FreeCell* firstFreeCell = block->sweepToFreeList()) {
+            sizeClass.firstFreeCell = firstFreeCell->next;
+            return firstFreeCell;
+        }
+    }
 }
 
 void MarkedSpace::shrink()
 {
+    // Blocks queued for sweeping may be about to be freed.
+    m_blocksToSweep.clear();
+
     // We record a temporary list of empties to avoid modifying m_blocks while iterating it.
     DoublyLinkedList<MarkedBlock> empties;
 
@@ -107,6 +221,28 @@ void MarkedSpace::shrink()
     ASSERT(empties.isEmpty());
 }
 
+static void clearFreeList(MarkedSpace::SizeClass& sizeClass)
+{
+    MarkedBlock::FreeCell* next;
+    for (MarkedBlock::FreeCell* freeCell = sizeClass.firstFreeCell; freeCell; freeCell = next) {
+        next = freeCell->next;
+        MarkedBlock::blockFor(freeCell)->reclaimFreeCell(freeCell);
+    }
+    sizeClass.firstFreeCell = 0;
+}
+
+void MarkedSpace::clearFreeLists()
+{
+    // Cells left on a free list were marked when the list was built. Turn them
+    // back into unmarked placeholder cells so the collector can tell them from
+    // live ones, and so the heap can be iterated.
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+        clearFreeList(sizeClassFor(cellSize));
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+        clearFreeList(sizeClassFor(cellSize));
+}
+
 void MarkedSpace::clearMarks()
 {
     BlockIterator end = m_blocks.end();
@@ -114,6 +250,22 @@ void MarkedSpace::clearMarks()
         (*it)->clearMarks();
 }
 
+#if ENABLE(GGC)
+void MarkedSpace::resetMarksToOld()
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->resetMarksToOld();
+}
+
+void MarkedSpace::promote()
+{
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        (*it)->promote();
+}
+#endif
+
 void MarkedSpace::sweep()
 {
     BlockIterator end = m_blocks.end();
@@ -121,6 +273,16 @@ void MarkedSpace::sweep()
         (*it)->sweep();
 }
 
+void MarkedSpace::sweepLazily()
+{
+    m_blocksToSweep.clear();
+    m_blocksToSweep.reserveCapacity(m_blocks.size());
+
+    BlockIterator end = m_blocks.end();
+    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+        m_blocksToSweep.append(*it);
+}
+
 size_t MarkedSpace::objectCount() const
 {
     size_t result = 0;
@@ -148,19 +310,42 @@ size_t MarkedSpace::capacity() const
     return result;
 }
 
+static void appendSizeClassStatistics(Vector<MarkedSpace::SizeClassStatistics>& statistics, MarkedSpace::SizeClass& sizeClass)
+{
+    MarkedSpace::SizeClassStatistics sizeClassStatistics;
+    sizeClassStatistics.cellSize = sizeClass.cellSize;
+    sizeClassStatistics.blockCount = 0;
+    sizeClassStatistics.cellCount = 0;
+    for (MarkedBlock* block = sizeClass.blockList.head(); block; block = block->next()) {
+        ++sizeClassStatistics.blockCount;
+        sizeClassStatistics.cellCount += block->markCount();
+    }
+    if (sizeClassStatistics.blockCount)
+        statistics.append(sizeClassStatistics);
+}
+
+void MarkedSpace::gatherSizeClassStatistics(Vector<SizeClassStatistics>& statistics)
+{
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+        appendSizeClassStatistics(statistics, sizeClassFor(cellSize));
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+        appendSizeClassStatistics(statistics, sizeClassFor(cellSize));
+}
+
 void MarkedSpace::reset()
 {
     m_waterMark = 0;
 
+    // Unswept dead cells stay unmarked across collections, so the allocator
+    // will still reclaim them; there is no need to finish the lazy sweep.
+    m_blocksToSweep.clear();
+
     for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
         sizeClassFor(cellSize).reset();
 
     for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
         sizeClassFor(cellSize).reset();
-
-    BlockIterator end = m_blocks.end();
-    for (BlockIterator it = m_blocks.begin(); it != end; ++it)
-        (*it)->reset();
 }
 
 } // namespace JSC
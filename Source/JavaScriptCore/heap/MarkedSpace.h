@@ -30,6 +30,7 @@
 #include <wtf/FixedArray.h>
 #include <wtf/HashSet.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/Threading.h>
 #include <wtf/Vector.h>
 
 #define ASSERT_CLASS_FITS_IN_CELL(class) COMPILE_ASSERT(sizeof(class) < MarkedSpace::maxCellSize, class_fits_in_cell)
@@ -49,6 +50,22 @@ namespace JSC {
         // Currently public for use in assertions.
         static const size_t maxCellSize = 1024;
 
+        struct SizeClass {
+            SizeClass();
+            void reset();
+
+            MarkedBlock::FreeCell* firstFreeCell; // Inline JIT allocation pops cells straight off this list.
+            MarkedBlock* nextBlock;
+            DoublyLinkedList<MarkedBlock> blockList;
+            size_t cellSize;
+        };
+
+        struct SizeClassStatistics {
+            size_t cellSize;
+            size_t blockCount;
+            size_t cellCount; // Cells that are marked, i.e. live or not yet collected.
+        };
+
         static Heap* heap(JSCell*);
 
         static bool isMarked(const JSCell*);
@@ -63,17 +80,26 @@ namespace JSC {
         size_t highWaterMark() { return m_highWaterMark; }
         void setHighWaterMark(size_t highWaterMark) { m_highWaterMark = highWaterMark; }
 
+        SizeClass& sizeClassFor(size_t);
         void* allocate(size_t);
 
+        void clearFreeLists();
         void clearMarks();
+#if ENABLE(GGC)
+        void resetMarksToOld();
+        void promote();
+        template<typename Functor> void forEachOldCellInDirtyCards(Functor&);
+#endif
         void markRoots();
         void reset();
         void sweep();
+        void sweepLazily();
         void shrink();
 
         size_t size() const;
         size_t capacity() const;
         size_t objectCount() const;
+        void gatherSizeClassStatistics(Vector<SizeClassStatistics>&);
 
         bool contains(const void*);
 
@@ -92,19 +118,13 @@ namespace JSC {
 
         typedef HashSet<MarkedBlock*>::iterator BlockIterator;
 
-        struct SizeClass {
-            SizeClass();
-            void reset();
-
-            MarkedBlock* nextBlock;
-            DoublyLinkedList<MarkedBlock> blockList;
-            size_t cellSize;
-        };
-
         MarkedBlock* allocateBlock(SizeClass&);
         void freeBlocks(DoublyLinkedList<MarkedBlock>&);
+        void releaseFreeBlocks(size_t numberOfBlocksToKeep);
+
+        static void* blockFreeingThreadStartFunc(void*);
+        void blockFreeingThreadMain();
 
-        SizeClass& sizeClassFor(size_t);
         void* allocateFromSizeClass(SizeClass&);
 
         void clearMarks(MarkedBlock*);
@@ -112,9 +132,19 @@ namespace JSC {
         SizeClass m_preciseSizeClasses[preciseCount];
         SizeClass m_impreciseSizeClasses[impreciseCount];
         HashSet<MarkedBlock*> m_blocks;
+        Vector<MarkedBlock*> m_blocksToSweep; // Survivors of the last collectAllGarbage() that may have yet to be swept.
         size_t m_waterMark;
         size_t m_highWaterMark;
         JSGlobalData* m_globalData;
+
+        // Empty blocks whose cells have been destroyed. The allocator reuses
+        // them; the block freeing thread gradually returns the rest to the OS.
+        DoublyLinkedList<MarkedBlock> m_freeBlocks; // Guarded by m_freeBlockLock.
+        size_t m_numberOfFreeBlocks; // Guarded by m_freeBlockLock.
+        Mutex m_freeBlockLock;
+        ThreadCondition m_freeBlockCondition;
+        ThreadIdentifier m_blockFreeingThread;
+        bool m_blockFreeingThreadShouldQuit; // Guarded by m_freeBlockLock.
     };
 
     inline Heap* MarkedSpace::heap(JSCell* cell)
@@ -151,19 +181,32 @@ namespace JSC {
 
     template <typename Functor> inline void MarkedSpace::forEach(Functor& functor)
     {
+        clearFreeLists();
+
         BlockIterator end = m_blocks.end();
         for (BlockIterator it = m_blocks.begin(); it != end; ++it)
             (*it)->forEach(functor);
     }
     
+#if ENABLE(GGC)
+    template <typename Functor> inline void MarkedSpace::forEachOldCellInDirtyCards(Functor& functor)
+    {
+        BlockIterator end = m_blocks.end();
+        for (BlockIterator it = m_blocks.begin(); it != end; ++it)
+            (*it)->forEachOldCellInDirtyCards(functor);
+    }
+#endif
+
     inline MarkedSpace::SizeClass::SizeClass()
-        : nextBlock(0)
+        : firstFreeCell(0)
+        , nextBlock(0)
         , cellSize(0)
     {
     }
 
     inline void MarkedSpace::SizeClass::reset()
     {
+        ASSERT(!firstFreeCell);
         nextBlock = blockList.head();
     }
 
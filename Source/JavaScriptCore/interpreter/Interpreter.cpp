@@ -1451,6 +1451,7 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
     Instruction* vPC = codeBlock->instructions().begin();
     Profiler** enabledProfilerReference = Profiler::enabledProfilerReference();
     unsigned tickCount = globalData->timeoutChecker.ticksUntilNextCheck();
+    SamplingProfiler* samplingProfiler = globalData->samplingProfiler();
     JSValue functionReturnValue;
 
 #define CHECK_FOR_EXCEPTION() \
@@ -1472,7 +1473,14 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
             goto vm_throw; \
         } \
         tickCount = globalData->timeoutChecker.ticksUntilNextCheck(); \
-    }
+    } \
+    CHECK_FOR_SAMPLE()
+
+#define CHECK_FOR_SAMPLE() \
+    do { \
+        if (UNLIKELY(samplingProfiler && samplingProfiler->sampleRequested())) \
+            samplingProfiler->takeSample(callFrame, vPC - codeBlock->instructions().begin()); \
+    } while (0)
     
 #if ENABLE(OPCODE_SAMPLING)
     #define SAMPLE(codeBlock, vPC) m_sampler->sample(codeBlock, vPC)
@@ -3697,6 +3705,108 @@ skip_id_custom_self:
         vPC += OPCODE_LENGTH(op_jlesseq);
         NEXT_INSTRUCTION();
     }
+    DEFINE_OPCODE(op_jeq) {
+        /* jeq src1(r) src2(r) target(offset)
+
+           Checks whether register src1 and register src2 are equal, as
+           with the ECMAScript '==' operator, and then jumps to offset
+           target from the current instruction, if and only if the
+           result of the comparison is true.
+        */
+        JSValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        JSValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        bool result;
+        if (src1.isInt32() && src2.isInt32())
+            result = src1.asInt32() == src2.asInt32();
+        else {
+            result = JSValue::equalSlowCase(callFrame, src1, src2);
+            CHECK_FOR_EXCEPTION();
+        }
+
+        if (result) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jeq);
+        NEXT_INSTRUCTION();
+    }
+    DEFINE_OPCODE(op_jneq) {
+        /* jneq src1(r) src2(r) target(offset)
+
+           Checks whether register src1 and register src2 are equal, as
+           with the ECMAScript '==' operator, and then jumps to offset
+           target from the current instruction, if and only if the
+           result of the comparison is false.
+        */
+        JSValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        JSValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        bool result;
+        if (src1.isInt32() && src2.isInt32())
+            result = src1.asInt32() == src2.asInt32();
+        else {
+            result = JSValue::equalSlowCase(callFrame, src1, src2);
+            CHECK_FOR_EXCEPTION();
+        }
+
+        if (!result) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jneq);
+        NEXT_INSTRUCTION();
+    }
+    DEFINE_OPCODE(op_jstricteq) {
+        /* jstricteq src1(r) src2(r) target(offset)
+
+           Checks whether register src1 and register src2 are strictly
+           equal, as with the ECMAScript '===' operator, and then jumps
+           to offset target from the current instruction, if and only if
+           the result of the comparison is true.
+        */
+        JSValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        JSValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        bool result = JSValue::strictEqual(callFrame, src1, src2);
+        CHECK_FOR_EXCEPTION();
+
+        if (result) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jstricteq);
+        NEXT_INSTRUCTION();
+    }
+    DEFINE_OPCODE(op_jnstricteq) {
+        /* jnstricteq src1(r) src2(r) target(offset)
+
+           Checks whether register src1 and register src2 are strictly
+           equal, as with the ECMAScript '===' operator, and then jumps
+           to offset target from the current instruction, if and only if
+           the result of the comparison is false.
+        */
+        JSValue src1 = callFrame->r(vPC[1].u.operand).jsValue();
+        JSValue src2 = callFrame->r(vPC[2].u.operand).jsValue();
+        int target = vPC[3].u.operand;
+
+        bool result = JSValue::strictEqual(callFrame, src1, src2);
+        CHECK_FOR_EXCEPTION();
+
+        if (!result) {
+            vPC += target;
+            NEXT_INSTRUCTION();
+        }
+
+        vPC += OPCODE_LENGTH(op_jnstricteq);
+        NEXT_INSTRUCTION();
+    }
     DEFINE_OPCODE(op_switch_imm) {
         /* switch_imm tableIndex(n) defaultOffset(offset) scrutinee(r)
 
@@ -4217,6 +4327,7 @@ skip_id_custom_self:
         for (size_t count = codeBlock->m_numVars; i < count; ++i)
             callFrame->uncheckedR(i) = jsUndefined();
 
+        CHECK_FOR_SAMPLE();
         vPC += OPCODE_LENGTH(op_enter);
         NEXT_INSTRUCTION();
     }
@@ -133,6 +133,8 @@ public:
         // word sized quantities, then all subsequent allocations will be aligned.
         n = roundUpAllocationSize(n, sizeof(void*));
 
+        m_allocatedBytes += n;
+
         if (static_cast<ptrdiff_t>(n) < (m_end - m_freePtr)) {
             void* result = m_freePtr;
             m_freePtr += n;
@@ -148,7 +150,9 @@ public:
     {
         if (static_cast<char*>(allocation) + oldSize != m_freePtr)
             return;
-        m_freePtr = static_cast<char*>(allocation) + roundUpAllocationSize(newSize, sizeof(void*));
+        char* newFreePtr = static_cast<char*>(allocation) + roundUpAllocationSize(newSize, sizeof(void*));
+        m_allocatedBytes -= m_freePtr - newFreePtr;
+        m_freePtr = newFreePtr;
     }
 
     ~ExecutablePool()
@@ -160,6 +164,14 @@ public:
 
     size_t available() const { return (m_pools.size() > 1) ? 0 : m_end - m_freePtr; }
 
+    // Fragmentation statistics. Memory is only returned to the system when the
+    // whole pool dies, so reservedBytes() - allocatedBytes() is the space this
+    // pool holds on to that no code can use any more (or, for the current
+    // allocation, has not used yet).
+    size_t reservedBytes() const { return m_reservedBytes; }
+    size_t allocatedBytes() const { return m_allocatedBytes; }
+    size_t wastedBytes() const { return m_reservedBytes - m_allocatedBytes; }
+
 private:
     static Allocation systemAlloc(size_t n);
     static void systemRelease(Allocation& alloc);
@@ -171,6 +183,8 @@ private:
     char* m_freePtr;
     char* m_end;
     AllocationList m_pools;
+    size_t m_reservedBytes;
+    size_t m_allocatedBytes;
 };
 
 class ExecutableAllocator {
@@ -342,6 +356,7 @@ private:
 };
 
 inline ExecutablePool::ExecutablePool(size_t n)
+    : m_allocatedBytes(0)
 {
     size_t allocSize = roundUpAllocationSize(n, JIT_ALLOCATOR_PAGE_SIZE);
     Allocation mem = systemAlloc(allocSize);
@@ -350,6 +365,7 @@ inline ExecutablePool::ExecutablePool(size_t n)
     if (!m_freePtr)
         CRASH(); // Failed to allocate
     m_end = m_freePtr + allocSize;
+    m_reservedBytes = allocSize;
 }
 
 inline void* ExecutablePool::poolAllocate(size_t n)
@@ -368,6 +384,7 @@ inline void* ExecutablePool::poolAllocate(size_t n)
     }
 
     m_pools.append(result);
+    m_reservedBytes += allocSize;
     return result.base();
 }
 
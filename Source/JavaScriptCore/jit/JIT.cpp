@@ -99,6 +99,23 @@ void JIT::emitTimeoutCheck()
     stubCall.call(timeoutCheckRegister);
     stubCall.getArgument(0, regT1, regT0); // reload last result registers.
     skipTimeout.link(this);
+
+    emitSampleCheck();
+}
+
+void JIT::emitSampleCheck()
+{
+    SamplingProfiler* samplingProfiler = m_globalData->samplingProfiler();
+    if (!samplingProfiler || !samplingProfiler->isRunning())
+        return;
+
+    load32(samplingProfiler->addressOfSampleRequested(), regT2);
+    Jump skipSample = branchTest32(Zero, regT2);
+    JITStubCall stubCall(this, cti_take_sample);
+    stubCall.addArgument(regT1, regT0); // save last result registers.
+    stubCall.call();
+    stubCall.getArgument(0, regT1, regT0); // reload last result registers.
+    skipSample.link(this);
 }
 #else
 void JIT::emitTimeoutCheck()
@@ -107,8 +124,124 @@ void JIT::emitTimeoutCheck()
     JITStubCall(this, cti_timeout_check).call(timeoutCheckRegister);
     skipTimeout.link(this);
 
+    emitSampleCheck();
+    killLastResultRegister();
+}
+
+void JIT::emitSampleCheck()
+{
+    SamplingProfiler* samplingProfiler = m_globalData->samplingProfiler();
+    if (!samplingProfiler || !samplingProfiler->isRunning())
+        return;
+
+    load32(samplingProfiler->addressOfSampleRequested(), regT2);
+    Jump skipSample = branchTest32(Zero, regT2);
+    JITStubCall(this, cti_take_sample).call();
+    skipSample.link(this);
+
+    killLastResultRegister();
+}
+#endif
+
+#if ENABLE(DFG_JIT)
+void JIT::emitOptimizationCheck(OptimizationCheckKind kind)
+{
+    // Only baseline code that the DFG JIT can fall back to is a candidate for optimization.
+    if (!m_codeBlock->isOSRExitTarget())
+        return;
+
+    Jump skipOptimize = branchAdd32(Signed, TrustedImm32(1), AbsoluteAddress(m_codeBlock->addressOfExecuteCounter()));
+    if (kind == EnterOptimizationCheck)
+        JITStubCall(this, cti_optimize_from_entry).call();
+    else {
+        // At a loop header, the stub returns the address at which to continue in
+        // the DFG JIT code, if it is able to transfer execution there.
+        JITStubCall stubCall(this, cti_optimize_from_loop);
+        stubCall.addArgument(TrustedImm32(m_bytecodeOffset));
+        stubCall.call(regT0);
+        Jump noOSREntry = branchTestPtr(Zero, regT0);
+        jump(regT0);
+        noOSREntry.link(this);
+    }
+    skipOptimize.link(this);
+
     killLastResultRegister();
 }
+
+// Loop headers are the targets of the backward jumps made by the op_loop family of
+// instructions. Counting executions there, rather than at the jumps, means that
+// a loop can be entered in DFG JIT code at the point it has been counted.
+void JIT::findLoopHeaders(Vector<bool>& isLoopHeader)
+{
+    Instruction* instructionsBegin = m_codeBlock->instructions().begin();
+    unsigned instructionCount = m_codeBlock->instructions().size();
+    isLoopHeader.fill(false, instructionCount);
+
+    for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; ) {
+        Instruction* currentInstruction = instructionsBegin + bytecodeOffset;
+        OpcodeID opcodeID = m_interpreter->getOpcodeID(currentInstruction->u.opcode);
+        switch (opcodeID) {
+        case op_loop:
+            isLoopHeader[bytecodeOffset + currentInstruction[1].u.operand] = true;
+            break;
+        case op_loop_if_true:
+        case op_loop_if_false:
+            isLoopHeader[bytecodeOffset + currentInstruction[2].u.operand] = true;
+            break;
+        case op_loop_if_less:
+        case op_loop_if_lesseq:
+            isLoopHeader[bytecodeOffset + currentInstruction[3].u.operand] = true;
+            break;
+        default:
+            break;
+        }
+        bytecodeOffset += opcodeLengths[opcodeID];
+    }
+}
+#endif
+
+#if ENABLE(VALUE_PROFILER)
+void JIT::emitValueProfilingSite()
+{
+    // Only function code has value profiles; see BytecodeGenerator::emitProfiledOpcode().
+    if (m_codeBlock->codeType() != FunctionCode)
+        return;
+
+    // Classify the value just produced into regT0, and record its type in the profile.
+    ValueProfile* valueProfile = m_codeBlock->valueProfileForBytecodeOffset(m_bytecodeOffset);
+    PredictedType* observedTypes = &valueProfile->observedTypes;
+    JumpList done;
+
+    Jump notInt32 = branchPtr(Below, regT0, tagTypeNumberRegister);
+    or32(TrustedImm32(PredictInt32), AbsoluteAddress(observedTypes));
+    done.append(jump());
+
+    notInt32.link(this);
+    Jump notNumber = branchTestPtr(Zero, regT0, tagTypeNumberRegister);
+    or32(TrustedImm32(PredictDouble), AbsoluteAddress(observedTypes));
+    done.append(jump());
+
+    notNumber.link(this);
+    Jump notCell = branchTestPtr(NonZero, regT0, tagMaskRegister);
+    or32(TrustedImm32(PredictCell), AbsoluteAddress(observedTypes));
+    done.append(jump());
+
+    notCell.link(this);
+    or32(TrustedImm32(PredictOther), AbsoluteAddress(observedTypes));
+
+    done.link(this);
+}
+
+void JIT::emitInt32ValueProfilingSite()
+{
+    if (m_codeBlock->codeType() != FunctionCode)
+        return;
+
+    // The integer fast paths of arithmetic only produce int32s, so there is
+    // nothing to classify.
+    ValueProfile* valueProfile = m_codeBlock->valueProfileForBytecodeOffset(m_bytecodeOffset);
+    or32(TrustedImm32(PredictInt32), AbsoluteAddress(&valueProfile->observedTypes));
+}
 #endif
 
 #define NEXT_OPCODE(name) \
@@ -174,6 +307,12 @@ void JIT::privateCompileMainPass()
     m_globalResolveInfoIndex = 0;
     m_callLinkInfoIndex = 0;
 
+#if ENABLE(DFG_JIT)
+    Vector<bool> isLoopHeader;
+    if (m_codeBlock->isOSRExitTarget())
+        findLoopHeaders(isLoopHeader);
+#endif
+
     for (m_bytecodeOffset = 0; m_bytecodeOffset < instructionCount; ) {
         Instruction* currentInstruction = instructionsBegin + m_bytecodeOffset;
         ASSERT_WITH_MESSAGE(m_interpreter->isOpcode(currentInstruction->u.opcode), "privateCompileMainPass gone bad @ %d", m_bytecodeOffset);
@@ -186,10 +325,20 @@ void JIT::privateCompileMainPass()
 #if USE(JSVALUE64)
         if (m_labels[m_bytecodeOffset].isUsed())
             killLastResultRegister();
+#if ENABLE(DFG_JIT)
+        // Execution may enter at any instruction when exiting from DFG JIT code.
+        if (m_codeBlock->isOSRExitTarget())
+            killLastResultRegister();
+#endif
 #endif
 
         m_labels[m_bytecodeOffset] = label();
 
+#if ENABLE(DFG_JIT)
+        if (!isLoopHeader.isEmpty() && isLoopHeader[m_bytecodeOffset])
+            emitOptimizationCheck(LoopOptimizationCheck);
+#endif
+
         switch (m_interpreter->getOpcodeID(currentInstruction->u.opcode)) {
         DEFINE_BINARY_OP(op_del_by_val)
         DEFINE_BINARY_OP(op_in)
@@ -319,6 +468,10 @@ void JIT::privateCompileMainPass()
         DEFINE_OP(op_to_primitive)
 
         case op_get_array_length:
+        case op_jeq:
+        case op_jneq:
+        case op_jstricteq:
+        case op_jnstricteq:
         case op_get_by_id_chain:
         case op_get_by_id_generic:
         case op_get_by_id_proto:
@@ -420,6 +573,7 @@ void JIT::privateCompileSlowCases()
         DEFINE_SLOWCASE_OP(op_negate)
 #endif
         DEFINE_SLOWCASE_OP(op_neq)
+        DEFINE_SLOWCASE_OP(op_new_object)
         DEFINE_SLOWCASE_OP(op_not)
         DEFINE_SLOWCASE_OP(op_nstricteq)
         DEFINE_SLOWCASE_OP(op_post_dec)
@@ -479,6 +633,7 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 
         // In the case of a fast linked call, we do not set this up in the caller.
         emitPutImmediateToCallFrameHeader(m_codeBlock, RegisterFile::CodeBlock);
+        store32(TrustedImm32(1), m_codeBlock->addressOfWasExecuted());
 
         addPtr(Imm32(m_codeBlock->m_numCalleeRegisters * sizeof(Register)), callFrameRegister, regT1);
         registerFileCheck = branchPtr(Below, AbsoluteAddress(m_globalData->interpreter->registerFile().addressOfEnd()), regT1);
@@ -486,6 +641,15 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 
     Label functionBody = label();
 
+    if (m_codeBlock->codeType() == FunctionCode) {
+        m_bytecodeOffset = 0;
+        emitSampleCheck();
+        emitOptimizationCheck(EnterOptimizationCheck);
+#ifndef NDEBUG
+        m_bytecodeOffset = (unsigned)-1; // Reset this, in order to guard its use with ASSERTs.
+#endif
+    }
+
     privateCompileMainPass();
     privateCompileLinkPass();
     privateCompileSlowCases();
@@ -589,7 +753,20 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
     if (m_codeBlock->codeType() == FunctionCode && functionEntryArityCheck)
         *functionEntryArityCheck = patchBuffer.locationOf(arityCheck);
 
-    return patchBuffer.finalizeCode();
+    JITCode jitCode = patchBuffer.finalizeCode();
+    m_codeBlock->setJITCode(jitCode);
+
+#if ENABLE(DFG_JIT)
+    if (m_codeBlock->isOSRExitTarget()) {
+        unsigned instructionCount = m_codeBlock->instructions().size();
+        for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; ++bytecodeOffset) {
+            if (m_labels[bytecodeOffset].isSet())
+                m_codeBlock->jitCodeMap().append(BytecodeOffsetToMachineCodeOffset(bytecodeOffset, jitCode.offsetOf(patchBuffer.locationOf(m_labels[bytecodeOffset]).executableAddress())));
+        }
+    }
+#endif
+
+    return jitCode;
 }
 
 #if ENABLE(JIT_OPTIMIZE_CALL)
@@ -210,6 +210,12 @@ namespace JSC {
             JIT jit(globalData, codeBlock);
             jit.privateCompileGetByIdChain(stubInfo, structure, chain, count, ident, slot, cachedOffset, returnAddress, callFrame);
         }
+
+        static void compileGetByIdMegamorphic(JSGlobalData* globalData, CodeBlock* codeBlock, StructureStubInfo* stubInfo, const Identifier& ident)
+        {
+            JIT jit(globalData, codeBlock);
+            jit.privateCompileGetByIdMegamorphic(stubInfo, ident);
+        }
         
         static void compilePutByIdTransition(JSGlobalData* globalData, CodeBlock* codeBlock, StructureStubInfo* stubInfo, Structure* oldStructure, Structure* newStructure, size_t cachedOffset, StructureChain* chain, ReturnAddressPtr returnAddress, bool direct)
         {
@@ -269,6 +275,7 @@ namespace JSC {
         void privateCompileGetByIdProtoList(StructureStubInfo*, PolymorphicAccessStructureList*, int, Structure*, Structure* prototypeStructure, const Identifier&, const PropertySlot&, size_t cachedOffset, CallFrame* callFrame);
         void privateCompileGetByIdChainList(StructureStubInfo*, PolymorphicAccessStructureList*, int, Structure*, StructureChain* chain, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, CallFrame* callFrame);
         void privateCompileGetByIdChain(StructureStubInfo*, Structure*, StructureChain*, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, ReturnAddressPtr returnAddress, CallFrame* callFrame);
+        void privateCompileGetByIdMegamorphic(StructureStubInfo*, const Identifier&);
         void privateCompilePutByIdTransition(StructureStubInfo*, Structure*, Structure*, size_t cachedOffset, StructureChain*, ReturnAddressPtr returnAddress, bool direct);
 
         void privateCompileCTIMachineTrampolines(RefPtr<ExecutablePool>* executablePool, JSGlobalData* data, TrampolineStructure *trampolines);
@@ -296,6 +303,12 @@ namespace JSC {
 
         void testPrototype(JSValue, JumpList& failureCases);
 
+        void emitAllocateJSFinalObject(TrustedImmPtr structure, RegisterID result, RegisterID scratch);
+
+        void emitWriteBarrier(RegisterID owner, RegisterID scratch1, RegisterID scratch2);
+        void emitWriteBarrier(JSCell* owner);
+        void emitWidenArrayElementKind(RegisterID value, RegisterID storage);
+
 #if USE(JSVALUE32_64)
         bool getOperandConstantImmediateInt(unsigned op1, unsigned op2, unsigned& op, int32_t& constant);
 
@@ -870,6 +883,7 @@ namespace JSC {
         void emitSlow_op_mul(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_negate(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_neq(Instruction*, Vector<SlowCaseEntry>::iterator&);
+        void emitSlow_op_new_object(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_not(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_nstricteq(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_post_dec(Instruction*, Vector<SlowCaseEntry>::iterator&);
@@ -933,6 +947,23 @@ namespace JSC {
         void emitLoadCharacterString(RegisterID src, RegisterID dst, JumpList& failures);
         
         void emitTimeoutCheck();
+        void emitSampleCheck();
+
+        enum OptimizationCheckKind { LoopOptimizationCheck, EnterOptimizationCheck };
+#if ENABLE(DFG_JIT)
+        void emitOptimizationCheck(OptimizationCheckKind);
+        void findLoopHeaders(Vector<bool>& isLoopHeader);
+#else
+        void emitOptimizationCheck(OptimizationCheckKind) { }
+#endif
+
+#if ENABLE(VALUE_PROFILER)
+        void emitValueProfilingSite();
+        void emitInt32ValueProfilingSite();
+#else
+        void emitValueProfilingSite() { }
+        void emitInt32ValueProfilingSite() { }
+#endif
 #ifndef NDEBUG
         void printBytecodeOperandTypes(unsigned src1, unsigned src2);
 #endif
@@ -992,7 +992,7 @@ void JIT::compileBinaryArithOpSlowCase(OpcodeID opcodeID, Vector<SlowCaseEntry>:
     }
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT1);
-    stubCall.call(result);
+    stubCall.callWithValueProfiling(result);
     Jump end = jump();
 
     if (op1HasImmediateIntFastCase) {
@@ -1048,6 +1048,7 @@ void JIT::compileBinaryArithOpSlowCase(OpcodeID opcodeID, Vector<SlowCaseEntry>:
     moveDoubleToPtr(fpRegT1, regT0);
     subPtr(tagTypeNumberRegister, regT0);
     emitPutVirtualRegister(result, regT0);
+    emitValueProfilingSite();
 
     end.link(this);
 }
@@ -1063,7 +1064,7 @@ void JIT::emit_op_add(Instruction* currentInstruction)
         JITStubCall stubCall(this, cti_op_add);
         stubCall.addArgument(op1, regT2);
         stubCall.addArgument(op2, regT2);
-        stubCall.call(result);
+        stubCall.callWithValueProfiling(result);
         return;
     }
 
@@ -1081,6 +1082,7 @@ void JIT::emit_op_add(Instruction* currentInstruction)
         compileBinaryArithOp(op_add, result, op1, op2, types);
 
     emitPutVirtualRegister(result);
+    emitInt32ValueProfilingSite();
 }
 
 void JIT::emitSlow_op_add(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
@@ -1121,6 +1123,7 @@ void JIT::emit_op_mul(Instruction* currentInstruction)
         compileBinaryArithOp(op_mul, result, op1, op2, types);
 
     emitPutVirtualRegister(result);
+    emitInt32ValueProfilingSite();
 }
 
 void JIT::emitSlow_op_mul(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
@@ -1224,6 +1227,7 @@ void JIT::emit_op_sub(Instruction* currentInstruction)
 
     compileBinaryArithOp(op_sub, result, op1, op2, types);
     emitPutVirtualRegister(result);
+    emitInt32ValueProfilingSite();
 }
 
 void JIT::emitSlow_op_sub(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
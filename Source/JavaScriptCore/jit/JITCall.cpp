@@ -59,6 +59,7 @@ void JIT::emit_op_call_put_result(Instruction* instruction)
 {
     int dst = instruction[1].u.operand;
     emitPutVirtualRegister(dst);
+    emitValueProfilingSite();
 }
 
 void JIT::compileOpCallVarargs(Instruction* instruction)
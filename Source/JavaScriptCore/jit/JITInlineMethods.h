@@ -88,8 +88,15 @@ ALWAYS_INLINE void JIT::emitLoadCharacterString(RegisterID src, RegisterID dst,
     failures.append(branchTest32(NonZero, Address(src, OBJECT_OFFSETOF(JSString, m_fiberCount))));
     failures.append(branch32(NotEqual, MacroAssembler::Address(src, ThunkHelpers::jsStringLengthOffset()), TrustedImm32(1)));
     loadPtr(MacroAssembler::Address(src, ThunkHelpers::jsStringValueOffset()), dst);
+
+    Jump is16Bit = branchTest8(Zero, MacroAssembler::Address(dst, ThunkHelpers::stringImplIs8BitOffset()));
+    loadPtr(MacroAssembler::Address(dst, ThunkHelpers::stringImplDataOffset()), dst);
+    load8(MacroAssembler::Address(dst, 0), dst);
+    Jump loadedCharacter = jump();
+    is16Bit.link(this);
     loadPtr(MacroAssembler::Address(dst, ThunkHelpers::stringImplDataOffset()), dst);
     load16(MacroAssembler::Address(dst, 0), dst);
+    loadedCharacter.link(this);
 }
 
 ALWAYS_INLINE void JIT::emitGetFromCallFrameHeader32(RegisterFile::CallFrameHeaderEntry entry, RegisterID to, RegisterID from)
@@ -261,6 +268,53 @@ ALWAYS_INLINE JIT::Jump JIT::checkStructure(RegisterID reg, Structure* structure
     return branchPtr(NotEqual, Address(reg, JSCell::structureOffset()), TrustedImmPtr(structure));
 }
 
+// Pops a cell off the JSFinalObject size class's free list and initializes it
+// as an empty object. Falls through to the slow case when the list is empty.
+ALWAYS_INLINE void JIT::emitAllocateJSFinalObject(TrustedImmPtr structure, RegisterID result, RegisterID scratch)
+{
+    MarkedSpace::SizeClass* sizeClass = &m_globalData->heap.markedSpace().sizeClassFor(sizeof(JSFinalObject));
+    loadPtr(&sizeClass->firstFreeCell, result);
+    addSlowCase(branchTestPtr(Zero, result));
+
+    loadPtr(Address(result, OBJECT_OFFSETOF(MarkedBlock::FreeCell, next)), scratch);
+    storePtr(scratch, &sizeClass->firstFreeCell);
+
+    storePtr(TrustedImmPtr(m_globalData->jsFinalObjectVPtr), Address(result));
+    storePtr(structure, Address(result, JSCell::structureOffset()));
+    storePtr(TrustedImmPtr(0), Address(result, OBJECT_OFFSETOF(JSObject, m_inheritorID)));
+    addPtr(TrustedImm32(JSObject::offsetOfInlineStorage()), result, scratch);
+    storePtr(scratch, Address(result, OBJECT_OFFSETOF(JSObject, m_propertyStorage)));
+}
+
+// Dirties the card holding owner's header; see WriteBarrier.h. The owner need
+// not be old, since nursery collections only rescan old cells.
+ALWAYS_INLINE void JIT::emitWriteBarrier(RegisterID owner, RegisterID scratch1, RegisterID scratch2)
+{
+#if ENABLE(GGC)
+    COMPILE_ASSERT(sizeof(MarkedBlock::Card) == 4, MarkedBlock_Card_is_four_bytes);
+    move(owner, scratch1);
+    andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch1);
+    move(owner, scratch2);
+    urshift32(TrustedImm32(MarkedBlock::cardShift - 2), scratch2);
+    and32(TrustedImm32((MarkedBlock::cardsPerBlock - 1) * sizeof(MarkedBlock::Card)), scratch2);
+    addPtr(scratch1, scratch2);
+    store32(TrustedImm32(1), Address(scratch2, MarkedBlock::offsetOfCards()));
+#else
+    UNUSED_PARAM(owner);
+    UNUSED_PARAM(scratch1);
+    UNUSED_PARAM(scratch2);
+#endif
+}
+
+ALWAYS_INLINE void JIT::emitWriteBarrier(JSCell* owner)
+{
+#if ENABLE(GGC)
+    store32(TrustedImm32(1), MarkedBlock::blockFor(owner)->cardFor(owner));
+#else
+    UNUSED_PARAM(owner);
+#endif
+}
+
 ALWAYS_INLINE void JIT::linkSlowCaseIfNotJSCell(Vector<SlowCaseEntry>::iterator& iter, int vReg)
 {
     if (!m_codeBlock->isKnownNotImmediate(vReg))
@@ -60,13 +60,19 @@ JIT::CodePtr JIT::stringGetByValStubGenerator(JSGlobalData* globalData, Executab
     // Load string length to regT1, and start the process of loading the data pointer into regT0
     jit.load32(Address(regT0, ThunkHelpers::jsStringLengthOffset()), regT2);
     jit.loadPtr(Address(regT0, ThunkHelpers::jsStringValueOffset()), regT0);
-    jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
     
     // Do an unsigned compare to simultaneously filter negative indices as well as indices that are too large
     failures.append(jit.branch32(AboveOrEqual, regT1, regT2));
     
-    // Load the character
+    // Load the character, which may be stored as Latin-1 or UTF-16
+    Jump is16Bit = jit.branchTest8(Zero, Address(regT0, ThunkHelpers::stringImplIs8BitOffset()));
+    jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
+    jit.load8(BaseIndex(regT0, regT1, TimesOne, 0), regT0);
+    Jump loadedCharacter = jit.jump();
+    is16Bit.link(&jit);
+    jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
     jit.load16(BaseIndex(regT0, regT1, TimesTwo, 0), regT0);
+    loadedCharacter.link(&jit);
     
     failures.append(jit.branch32(AboveOrEqual, regT0, TrustedImm32(0x100)));
     jit.move(TrustedImmPtr(globalData->smallStrings.singleCharacterStrings()), regT1);
@@ -108,6 +114,7 @@ void JIT::emit_op_get_by_val(Instruction* currentInstruction)
     addSlowCase(branchTestPtr(Zero, regT0));
 
     emitPutVirtualRegister(dst);
+    emitValueProfilingSite();
 }
 
 void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
@@ -124,6 +131,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     emitNakedCall(m_globalData->getCTIStub(stringGetByValStubGenerator));
     Jump failed = branchTestPtr(Zero, regT0);
     emitPutVirtualRegister(dst, regT0);
+    emitValueProfilingSite();
     emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
     failed.link(this);
     notString.link(this);
@@ -135,7 +143,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     JITStubCall stubCall(this, cti_op_get_by_val);
     stubCall.addArgument(base, regT2);
     stubCall.addArgument(property, regT2);
-    stubCall.call(dst);
+    stubCall.callWithValueProfiling(dst);
 }
 
 void JIT::compileGetDirectOffset(RegisterID base, RegisterID result, RegisterID offset, RegisterID scratch)
@@ -186,6 +194,27 @@ void JIT::emitSlow_op_get_by_pname(Instruction* currentInstruction, Vector<SlowC
     stubCall.call(dst);
 }
 
+// Widens the element kind of the ArrayStorage in storage to cover value, which is
+// about to be stored into its vector.
+void JIT::emitWidenArrayElementKind(RegisterID value, RegisterID storage)
+{
+    Address elementKind(storage, OBJECT_OFFSETOF(ArrayStorage, m_elementKind));
+
+    Jump isInt32 = branchPtr(AboveOrEqual, value, tagTypeNumberRegister);
+    Jump isNotNumber = branchTestPtr(Zero, value, tagTypeNumberRegister);
+
+    Jump alreadyWider = branch32(NotEqual, elementKind, TrustedImm32(Int32Elements));
+    store32(TrustedImm32(DoubleElements), elementKind);
+    Jump done = jump();
+
+    isNotNumber.link(this);
+    store32(TrustedImm32(ContiguousElements), elementKind);
+
+    isInt32.link(this);
+    alreadyWider.link(this);
+    done.link(this);
+}
+
 void JIT::emit_op_put_by_val(Instruction* currentInstruction)
 {
     unsigned base = currentInstruction[1].u.operand;
@@ -200,11 +229,14 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     addSlowCase(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsArrayVPtr)));
     addSlowCase(branch32(AboveOrEqual, regT1, Address(regT0, JSArray::vectorLengthOffset())));
 
+    emitWriteBarrier(regT0, regT2, regT3);
+
     loadPtr(Address(regT0, JSArray::storageOffset()), regT2);
     Jump empty = branchTestPtr(Zero, BaseIndex(regT2, regT1, ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
 
     Label storeResult(this);
     emitGetVirtualRegister(value, regT0);
+    emitWidenArrayElementKind(regT0, regT2);
     storePtr(regT0, BaseIndex(regT2, regT1, ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])));
     Jump end = jump();
     
@@ -277,7 +309,7 @@ void JIT::emit_op_get_by_id(Instruction* currentInstruction)
     JITStubCall stubCall(this, cti_op_get_by_id_generic);
     stubCall.addArgument(regT0);
     stubCall.addArgument(TrustedImmPtr(ident));
-    stubCall.call(resultVReg);
+    stubCall.callWithValueProfiling(resultVReg);
 
     m_propertyAccessInstructionIndex++;
 }
@@ -397,6 +429,7 @@ void JIT::emit_op_get_by_id(Instruction* currentInstruction)
     emitGetVirtualRegister(baseVReg, regT0);
     compileGetByIdHotPath(resultVReg, baseVReg, ident, m_propertyAccessInstructionIndex++);
     emitPutVirtualRegister(resultVReg);
+    emitValueProfilingSite();
 }
 
 void JIT::compileGetByIdHotPath(int, int baseVReg, Identifier*, unsigned propertyAccessInstructionIndex)
@@ -462,6 +495,9 @@ void JIT::compileGetByIdSlowCase(int resultVReg, int baseVReg, Identifier* ident
 
     END_UNINTERRUPTED_SEQUENCE(sequenceGetByIdSlowCase);
 
+    if (!isMethodCheck)
+        emitValueProfilingSite();
+
     ASSERT_JIT_OFFSET(differenceBetween(coldPathBegin, call), patchOffsetGetByIdSlowCaseCall);
 
     // Track the location of the call; this will be used to recover patch information.
@@ -485,6 +521,8 @@ void JIT::emit_op_put_by_id(Instruction* currentInstruction)
     // Jump to a slow case if either the base object is an immediate, or if the Structure does not match.
     emitJumpSlowCaseIfNotJSCell(regT0, baseVReg);
 
+    emitWriteBarrier(regT0, regT2, regT3);
+
     BEGIN_UNINTERRUPTED_SEQUENCE(sequencePutById);
 
     Label hotPathBegin(this);
@@ -606,6 +644,7 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
         restoreReturnAddressBeforeReturn(regT3);
     }
 
+    emitWriteBarrier(regT0, regT2, regT3);
     storePtrWithWriteBarrier(TrustedImmPtr(newStructure), regT0, Address(regT0, JSCell::structureOffset()));
 
     // write the value
@@ -1044,6 +1083,58 @@ void JIT::privateCompileGetByIdChain(StructureStubInfo* stubInfo, Structure* str
     repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_get_by_id_proto_list));
 }
 
+void JIT::privateCompileGetByIdMegamorphic(StructureStubInfo* stubInfo, const Identifier& ident)
+{
+    typedef MegamorphicGetByIdCache::Entry Entry;
+    StringImpl* uid = ident.impl();
+
+    // regT0 holds a JSCell*, and must survive to the slow case. Find the cache
+    // entry for its Structure and this property name; see MegamorphicGetByIdCache::index().
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT1);
+    move(regT1, regT2);
+    urshift32(TrustedImm32(MegamorphicGetByIdCache::structureShift), regT2);
+    xor32(TrustedImm32(uid->existingHash()), regT2);
+    and32(TrustedImm32(MegamorphicGetByIdCache::size - 1), regT2);
+    lshift32(TrustedImm32(MegamorphicGetByIdCache::entrySizeShift), regT2);
+    addPtr(TrustedImmPtr(m_globalData->jitStubs->megamorphicGetByIdCache().entries()), regT2);
+
+    JumpList failureCases;
+    failureCases.append(branchPtr(NotEqual, Address(regT2, OBJECT_OFFSETOF(Entry, structure)), regT1));
+    failureCases.append(branchPtr(NotEqual, Address(regT2, OBJECT_OFFSETOF(Entry, uid)), TrustedImmPtr(uid)));
+
+    // A property found on the prototype is only still there if the prototype's Structure is unchanged.
+    Jump isOwnProperty = branchTestPtr(Zero, Address(regT2, OBJECT_OFFSETOF(Entry, prototypeStructure)));
+    loadPtr(Address(regT1, Structure::prototypeOffset()), regT3);
+    loadPtr(Address(regT2, OBJECT_OFFSETOF(Entry, prototypeStructure)), regT1);
+    failureCases.append(branchPtr(NotEqual, Address(regT3, JSCell::structureOffset()), regT1));
+    Jump haveSlotBase = jump();
+    isOwnProperty.link(this);
+    move(regT0, regT3);
+    haveSlotBase.link(this);
+
+    add32(TrustedImm32(1), AbsoluteAddress(&stubInfo->u.getByIdMegamorphic.hits));
+    loadPtr(Address(regT2, OBJECT_OFFSETOF(Entry, offset)), regT2);
+    compileGetDirectOffset(regT3, regT0, regT2, regT1);
+    Jump success = jump();
+
+    LinkBuffer patchBuffer(this, m_codeBlock->executablePool(), 0);
+
+    // Use the patch information to link the failure cases back to the original slow case routine.
+    patchBuffer.link(failureCases, stubInfo->callReturnLocation.labelAtOffset(-patchOffsetGetByIdSlowCaseCall));
+
+    // On success return back to the hot patch code, at a point it will perform the store to dest for us.
+    patchBuffer.link(success, stubInfo->hotPathBegin.labelAtOffset(patchOffsetGetByIdPutResult));
+
+    // Track the stub we have created so that it will be deleted later.
+    CodeLocationLabel entryLabel = patchBuffer.finalizeCodeAddendum();
+    stubInfo->stubRoutine = entryLabel;
+
+    // Finally patch the jump to slow case back in the hot path to jump here instead.
+    CodeLocationJump jumpLocation = stubInfo->hotPathBegin.jumpAtOffset(patchOffsetGetByIdBranchToSlowCase);
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relink(jumpLocation, entryLabel);
+}
+
 /* ------------------------------ END: !ENABLE / ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS) ------------------------------ */
 
 #endif // !ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS)
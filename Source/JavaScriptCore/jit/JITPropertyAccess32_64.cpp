@@ -277,13 +277,19 @@ JIT::CodePtr JIT::stringGetByValStubGenerator(JSGlobalData* globalData, Executab
     // Load string length to regT1, and start the process of loading the data pointer into regT0
     jit.load32(Address(regT0, ThunkHelpers::jsStringLengthOffset()), regT1);
     jit.loadPtr(Address(regT0, ThunkHelpers::jsStringValueOffset()), regT0);
-    jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
     
     // Do an unsigned compare to simultaneously filter negative indices as well as indices that are too large
     failures.append(jit.branch32(AboveOrEqual, regT2, regT1));
     
-    // Load the character
+    // Load the character, which may be stored as Latin-1 or UTF-16
+    Jump is16Bit = jit.branchTest8(Zero, Address(regT0, ThunkHelpers::stringImplIs8BitOffset()));
+    jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
+    jit.load8(BaseIndex(regT0, regT2, TimesOne, 0), regT0);
+    Jump loadedCharacter = jit.jump();
+    is16Bit.link(&jit);
+    jit.loadPtr(Address(regT0, ThunkHelpers::stringImplDataOffset()), regT0);
     jit.load16(BaseIndex(regT0, regT2, TimesTwo, 0), regT0);
+    loadedCharacter.link(&jit);
     
     failures.append(jit.branch32(AboveOrEqual, regT0, TrustedImm32(0x100)));
     jit.move(TrustedImmPtr(globalData->smallStrings.singleCharacterStrings()), regT1);
@@ -351,6 +357,27 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     stubCall.call(dst);
 }
 
+// Widens the element kind of the ArrayStorage in storage to cover the value whose tag
+// is in tag, which is about to be stored into its vector.
+void JIT::emitWidenArrayElementKind(RegisterID tag, RegisterID storage)
+{
+    Address elementKind(storage, OBJECT_OFFSETOF(ArrayStorage, m_elementKind));
+
+    Jump isInt32 = branch32(Equal, tag, TrustedImm32(JSValue::Int32Tag));
+    Jump isNotNumber = branch32(AboveOrEqual, tag, TrustedImm32(JSValue::LowestTag));
+
+    Jump alreadyWider = branch32(NotEqual, elementKind, TrustedImm32(Int32Elements));
+    store32(TrustedImm32(DoubleElements), elementKind);
+    Jump done = jump();
+
+    isNotNumber.link(this);
+    store32(TrustedImm32(ContiguousElements), elementKind);
+
+    isInt32.link(this);
+    alreadyWider.link(this);
+    done.link(this);
+}
+
 void JIT::emit_op_put_by_val(Instruction* currentInstruction)
 {
     unsigned base = currentInstruction[1].u.operand;
@@ -370,6 +397,7 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     
     Label storeResult(this);
     emitLoad(value, regT1, regT0);
+    emitWidenArrayElementKind(regT1, regT3);
     store32(regT0, BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload))); // payload
     store32(regT1, BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(ArrayStorage, m_vector[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag))); // tag
     Jump end = jump();
@@ -1073,6 +1101,63 @@ void JIT::privateCompileGetByIdChain(StructureStubInfo* stubInfo, Structure* str
     repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_get_by_id_proto_list));
 }
 
+void JIT::privateCompileGetByIdMegamorphic(StructureStubInfo* stubInfo, const Identifier& ident)
+{
+    typedef MegamorphicGetByIdCache::Entry Entry;
+    StringImpl* uid = ident.impl();
+
+    // regT0 holds a JSCell*, and regT1 its tag, which we borrow and put back
+    // before going to the slow case. Find the cache entry for the cell's
+    // Structure and this property name; see MegamorphicGetByIdCache::index().
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT1);
+    move(regT1, regT2);
+    urshift32(TrustedImm32(MegamorphicGetByIdCache::structureShift), regT2);
+    xor32(TrustedImm32(uid->existingHash()), regT2);
+    and32(TrustedImm32(MegamorphicGetByIdCache::size - 1), regT2);
+    lshift32(TrustedImm32(MegamorphicGetByIdCache::entrySizeShift), regT2);
+    addPtr(TrustedImmPtr(m_globalData->jitStubs->megamorphicGetByIdCache().entries()), regT2);
+
+    JumpList failureCases;
+    failureCases.append(branchPtr(NotEqual, Address(regT2, OBJECT_OFFSETOF(Entry, structure)), regT1));
+    failureCases.append(branchPtr(NotEqual, Address(regT2, OBJECT_OFFSETOF(Entry, uid)), TrustedImmPtr(uid)));
+
+    // A property found on the prototype is only still there if the prototype's Structure is unchanged.
+    Jump isOwnProperty = branchTestPtr(Zero, Address(regT2, OBJECT_OFFSETOF(Entry, prototypeStructure)));
+    loadPtr(Address(regT1, Structure::prototypeOffset() + OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT3);
+    loadPtr(Address(regT2, OBJECT_OFFSETOF(Entry, prototypeStructure)), regT1);
+    failureCases.append(branchPtr(NotEqual, Address(regT3, JSCell::structureOffset()), regT1));
+    Jump haveSlotBase = jump();
+    isOwnProperty.link(this);
+    move(regT0, regT3);
+    haveSlotBase.link(this);
+
+    add32(TrustedImm32(1), AbsoluteAddress(&stubInfo->u.getByIdMegamorphic.hits));
+    loadPtr(Address(regT2, OBJECT_OFFSETOF(Entry, offset)), regT2);
+    compileGetDirectOffset(regT3, regT1, regT0, regT2);
+    Jump success = jump();
+
+    failureCases.link(this);
+    move(TrustedImm32(JSValue::CellTag), regT1);
+    Jump failure = jump();
+
+    LinkBuffer patchBuffer(this, m_codeBlock->executablePool(), 0);
+
+    // Use the patch information to link the failure cases back to the original slow case routine.
+    patchBuffer.link(failure, stubInfo->callReturnLocation.labelAtOffset(-patchOffsetGetByIdSlowCaseCall));
+
+    // On success return back to the hot patch code, at a point it will perform the store to dest for us.
+    patchBuffer.link(success, stubInfo->hotPathBegin.labelAtOffset(patchOffsetGetByIdPutResult));
+
+    // Track the stub we have created so that it will be deleted later.
+    CodeLocationLabel entryLabel = patchBuffer.finalizeCodeAddendum();
+    stubInfo->stubRoutine = entryLabel;
+
+    // Finally patch the jump to slow case back in the hot path to jump here instead.
+    CodeLocationJump jumpLocation = stubInfo->hotPathBegin.jumpAtOffset(patchOffsetGetByIdBranchToSlowCase);
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relink(jumpLocation, entryLabel);
+}
+
 /* ------------------------------ END: !ENABLE / ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS) ------------------------------ */
 
 #endif // !ENABLE(JIT_OPTIMIZE_PROPERTY_ACCESS)
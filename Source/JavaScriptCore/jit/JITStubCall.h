@@ -207,6 +207,13 @@ namespace JSC {
             m_jit->emitPutVirtualRegister(dst);
             return call;
         }
+
+        JIT::Call callWithValueProfiling(unsigned dst) // dst is a virtual register.
+        {
+            JIT::Call call = this->call(dst);
+            m_jit->emitValueProfilingSite();
+            return call;
+        }
 #endif
 
         JIT::Call call(JIT::RegisterID dst) // dst is a machine register.
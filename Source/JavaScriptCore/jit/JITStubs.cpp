@@ -58,6 +58,7 @@
 #include "RegExpObject.h"
 #include "RegExpPrototype.h"
 #include "Register.h"
+#include "RepatchBuffer.h"
 #include "SamplingTool.h"
 #include <wtf/StdLibExtras.h>
 #include <stdarg.h>
@@ -853,6 +854,36 @@ NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* co
     JIT::patchPutByIdReplace(codeBlock, stubInfo, structure, slot.cachedOffset(), returnAddress, direct);
 }
 
+COMPILE_ASSERT(sizeof(MegamorphicGetByIdCache::Entry) == 1 << MegamorphicGetByIdCache::entrySizeShift, MegamorphicGetByIdCache_entry_size_matches_shift);
+
+void MegamorphicGetByIdCache::add(JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot)
+{
+    if (!baseValue.isCell() || !slot.isCacheable() || slot.cachedPropertyType() != PropertySlot::Value)
+        return;
+
+    Structure* structure = baseValue.asCell()->structure();
+    if (structure->isDictionary())
+        return;
+
+    Structure* prototypeStructure = 0;
+    if (slot.slotBase() != baseValue) {
+        // The probe only knows how to find the immediate prototype.
+        JSValue prototype = structure->storedPrototype();
+        if (slot.slotBase() != prototype)
+            return;
+        prototypeStructure = asObject(prototype)->structure();
+        if (prototypeStructure->isDictionary())
+            return;
+    }
+
+    StringImpl* uid = propertyName.impl();
+    Entry& entry = m_entries[index(structure, uid->existingHash())];
+    entry.structure = structure;
+    entry.uid = uid;
+    entry.prototypeStructure = prototypeStructure;
+    entry.offset = slot.cachedOffset();
+}
+
 NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* codeBlock, ReturnAddressPtr returnAddress, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo* stubInfo)
 {
     // FIXME: Write a test that proves we need to check for recursion here just
@@ -1357,6 +1388,15 @@ DEFINE_STUB_FUNCTION(int, timeout_check)
     return timeoutChecker.ticksUntilNextCheck();
 }
 
+DEFINE_STUB_FUNCTION(void, take_sample)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+
+    unsigned bytecodeOffset = callFrame->codeBlock()->bytecodeOffset(STUB_RETURN_ADDRESS);
+    stackFrame.globalData->samplingProfiler()->takeSample(callFrame, bytecodeOffset);
+}
+
 DEFINE_STUB_FUNCTION(void*, register_file_check)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1374,6 +1414,87 @@ DEFINE_STUB_FUNCTION(void*, register_file_check)
     return callFrame;
 }
 
+#if ENABLE(DFG_JIT)
+// Once a function has been optimized, calls that were linked directly to its
+// baseline code still enter there; repoint the one that made this call.
+static void relinkCallerToOptimizedCode(CallFrame* callFrame, FunctionExecutable* executable)
+{
+    CallFrame* callerFrame = callFrame->callerFrame();
+    if (callerFrame->hasHostCallFrameFlag())
+        return;
+
+    CodeBlock* callerCodeBlock = callerFrame->codeBlock();
+    void* returnPC = callFrame->returnPC().value();
+    for (size_t i = 0; i < callerCodeBlock->numberOfCallLinkInfos(); ++i) {
+        CallLinkInfo& callLinkInfo = callerCodeBlock->callLinkInfo(i);
+        if (callLinkInfo.isLinked() && callLinkInfo.hotPathOther.executableAddress() == returnPC) {
+            RepatchBuffer repatchBuffer(callerCodeBlock);
+            repatchBuffer.relink(callLinkInfo.hotPathOther, executable->generatedJITCodeForCall().addressForCall());
+            return;
+        }
+    }
+}
+
+static bool optimize(CallFrame* callFrame, CodeBlock* codeBlock)
+{
+    JSFunction* callee = asFunction(callFrame->callee());
+    FunctionExecutable* executable = callee->jsExecutable();
+
+    if (!executable->optimizeForCall(callFrame, callee->scope())) {
+        codeBlock->dontOptimizeAnytimeSoon();
+        return false;
+    }
+
+    // Keep checking on entry, so that calls still linked to this code get relinked.
+    codeBlock->optimizeNextInvocation();
+    return true;
+}
+
+DEFINE_STUB_FUNCTION(void, optimize_from_entry)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    FunctionExecutable* executable = asFunction(callFrame->callee())->jsExecutable();
+
+    if (codeBlock != &executable->generatedBytecodeForCall() || optimize(callFrame, codeBlock)) {
+        // This code has been superseded by DFG code.
+        relinkCallerToOptimizedCode(callFrame, executable);
+        codeBlock->optimizeNextInvocation();
+    }
+}
+
+// Called at a loop header in baseline JIT code. Returns the address at which to
+// continue execution in the DFG JIT code for the function, or 0 to stay put.
+DEFINE_STUB_FUNCTION(void*, optimize_from_loop)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    unsigned bytecodeOffset = stackFrame.args[0].int32();
+    FunctionExecutable* executable = asFunction(callFrame->callee())->jsExecutable();
+
+    if (codeBlock == &executable->generatedBytecodeForCall()) {
+        if (!optimize(callFrame, codeBlock))
+            return 0;
+    } else
+        codeBlock->optimizeAfterWarmUp();
+
+    // The DFG JIT code shares this frame; no values are live in registers at the
+    // head of a basic block, so all that has to change is the frame's CodeBlock,
+    // and its size.
+    CodeBlock* optimizedCodeBlock = &executable->generatedBytecodeForCall();
+    if (optimizedCodeBlock->alternative() != codeBlock)
+        return 0;
+    void* entry = optimizedCodeBlock->osrEntryForBytecodeOffset(bytecodeOffset);
+    if (!entry || !stackFrame.registerFile->grow(&callFrame->registers()[optimizedCodeBlock->m_numCalleeRegisters]))
+        return 0;
+
+    callFrame->setCodeBlock(optimizedCodeBlock);
+    return entry;
+}
+#endif
+
 DEFINE_STUB_FUNCTION(int, op_loop_if_lesseq)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1641,7 +1762,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_self_fail)
             JIT::compileGetByIdSelfList(callFrame->scopeChain()->globalData, codeBlock, stubInfo, polymorphicStructureList, listIndex, baseValue.asCell()->structure(), ident, slot, slot.cachedOffset());
 
             if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
-                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
+                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_megamorphic));
         }
     } else
         ctiPatchCallByReturnAddress(callFrame->codeBlock(), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
@@ -1753,7 +1874,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
             JIT::compileGetByIdProtoList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, slotBaseObject->structure(), propertyName, slot, offset);
 
             if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
-                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_megamorphic));
         }
     } else if (size_t count = normalizePrototypeChain(callFrame, baseValue, slot.slotBase(), propertyName, offset)) {
         ASSERT(!baseValue.asCell()->structure()->isDictionary());
@@ -1765,7 +1886,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
             JIT::compileGetByIdChainList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, protoChain, count, propertyName, slot, offset);
 
             if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
-                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_megamorphic));
         }
     } else
         ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
@@ -1773,15 +1894,35 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
     return JSValue::encode(result);
 }
 
-DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list_full)
+DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_megamorphic)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
+    CallFrame* callFrame = stackFrame.callFrame;
+    const Identifier& propertyName = stackFrame.args[1].identifier();
+
     JSValue baseValue = stackFrame.args[0].jsValue();
     PropertySlot slot(baseValue);
-    JSValue result = baseValue.get(stackFrame.callFrame, stackFrame.args[1].identifier(), slot);
+    JSValue result = baseValue.get(callFrame, propertyName, slot);
 
-    CHECK_FOR_EXCEPTION_AT_END();
+    CHECK_FOR_EXCEPTION();
+
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    StructureStubInfo* stubInfo = &codeBlock->getStubInfo(STUB_RETURN_ADDRESS);
+
+    // The first miss after a polymorphic list fills up replaces the list with a
+    // probe of the shared cache.
+    if (stubInfo->accessType != access_get_by_id_megamorphic) {
+        Structure* hotPathStructure = 0;
+        if (stubInfo->accessType == access_get_by_id_self_list)
+            hotPathStructure = stubInfo->u.getByIdSelfList.structureList->list[0].base.get();
+        stubInfo->deref();
+        stubInfo->initGetByIdMegamorphic(callFrame->globalData(), codeBlock->ownerExecutable(), hotPathStructure);
+        JIT::compileGetByIdMegamorphic(callFrame->scopeChain()->globalData, codeBlock, stubInfo, propertyName);
+    }
+    ++stubInfo->u.getByIdMegamorphic.misses;
+
+    callFrame->globalData().jitStubs->megamorphicGetByIdCache().add(baseValue, propertyName, slot);
     return JSValue::encode(result);
 }
 
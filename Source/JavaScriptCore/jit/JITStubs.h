@@ -34,6 +34,7 @@
 #include "MacroAssemblerCodeRef.h"
 #include "Register.h"
 #include "ThunkGenerators.h"
+#include <wtf/Forward.h>
 #include <wtf/HashMap.h>
 
 #if ENABLE(JIT)
@@ -58,6 +59,7 @@ namespace JSC {
     class PutPropertySlot;
     class RegisterFile;
     class RegExp;
+    class Structure;
 
     union JITStubArg {
         void* asPointer;
@@ -277,6 +279,47 @@ namespace JSC {
 
     template <typename T> class Strong;
 
+    // A direct-mapped table from (Structure, property name) to a property
+    // storage index, shared by every get_by_id that has outgrown its
+    // polymorphic stub list. JIT code probes it before falling back to
+    // cti_op_get_by_id_megamorphic, which refills it. An entry for a property
+    // found on the immediate prototype also records the prototype's Structure,
+    // and the probe checks that it has not changed.
+    //
+    // Only non-dictionary Structures are entered, so an entry stays valid for as
+    // long as its Structures are alive; the heap clears the table on every
+    // collection because a dead Structure's address can be reused.
+    class MegamorphicGetByIdCache {
+        WTF_MAKE_NONCOPYABLE(MegamorphicGetByIdCache);
+    public:
+        struct Entry {
+            Structure* structure;
+            StringImpl* uid;
+            Structure* prototypeStructure; // 0 if the property is the object's own.
+            intptr_t offset;
+        };
+
+        static const unsigned size = 1024;
+        static const unsigned structureShift = 4;
+        static const unsigned entrySizeShift = sizeof(void*) == 8 ? 5 : 4;
+
+        MegamorphicGetByIdCache() { clear(); }
+
+        void clear() { memset(m_entries, 0, sizeof(m_entries)); }
+
+        static unsigned index(Structure* structure, unsigned identifierHash)
+        {
+            return ((static_cast<unsigned>(reinterpret_cast<uintptr_t>(structure)) >> structureShift) ^ identifierHash) & (size - 1);
+        }
+
+        void add(JSValue baseValue, const Identifier&, const PropertySlot&);
+
+        Entry* entries() { return m_entries; }
+
+    private:
+        Entry m_entries[size];
+    };
+
     class JITThunks {
     public:
         JITThunks(JSGlobalData*);
@@ -301,6 +344,8 @@ namespace JSC {
 
         void clearHostFunctionStubs();
 
+        MegamorphicGetByIdCache& megamorphicGetByIdCache() { return m_megamorphicGetByIdCache; }
+
     private:
         typedef HashMap<ThunkGenerator, MacroAssemblerCodePtr> CTIStubMap;
         CTIStubMap m_ctiStubMap;
@@ -309,6 +354,8 @@ namespace JSC {
         RefPtr<ExecutablePool> m_executablePool;
 
         TrampolineStructure m_trampolineStructure;
+
+        MegamorphicGetByIdCache m_megamorphicGetByIdCache;
     };
 
 extern "C" {
@@ -333,10 +380,10 @@ extern "C" {
     EncodedJSValue JIT_STUB cti_op_get_by_id_custom_stub(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_generic(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_getter_stub(STUB_ARGS_DECLARATION);
+    EncodedJSValue JIT_STUB cti_op_get_by_id_megamorphic(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_method_check(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_proto_fail(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_proto_list(STUB_ARGS_DECLARATION);
-    EncodedJSValue JIT_STUB cti_op_get_by_id_proto_list_full(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_self_fail(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_id_string_fail(STUB_ARGS_DECLARATION);
     EncodedJSValue JIT_STUB cti_op_get_by_val(STUB_ARGS_DECLARATION);
@@ -397,6 +444,7 @@ extern "C" {
     int JIT_STUB cti_op_load_varargs(STUB_ARGS_DECLARATION);
     int JIT_STUB cti_op_loop_if_lesseq(STUB_ARGS_DECLARATION);
     int JIT_STUB cti_timeout_check(STUB_ARGS_DECLARATION);
+    void JIT_STUB cti_take_sample(STUB_ARGS_DECLARATION);
     int JIT_STUB cti_has_property(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_check_has_instance(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_debug(STUB_ARGS_DECLARATION);
@@ -419,6 +467,9 @@ extern "C" {
     void JIT_STUB cti_op_tear_off_activation(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_tear_off_arguments(STUB_ARGS_DECLARATION);
     void JIT_STUB cti_op_throw_reference_error(STUB_ARGS_DECLARATION);
+#if ENABLE(DFG_JIT)
+    void JIT_STUB cti_optimize_from_entry(STUB_ARGS_DECLARATION);
+#endif
     void* JIT_STUB cti_op_call_arityCheck(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_construct_arityCheck(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_call_jitCompile(STUB_ARGS_DECLARATION);
@@ -427,6 +478,9 @@ extern "C" {
     void* JIT_STUB cti_op_switch_imm(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_switch_string(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_op_throw(STUB_ARGS_DECLARATION);
+#if ENABLE(DFG_JIT)
+    void* JIT_STUB cti_optimize_from_loop(STUB_ARGS_DECLARATION);
+#endif
     void* JIT_STUB cti_register_file_check(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_vm_lazyLinkCall(STUB_ARGS_DECLARATION);
     void* JIT_STUB cti_vm_lazyLinkConstruct(STUB_ARGS_DECLARATION);
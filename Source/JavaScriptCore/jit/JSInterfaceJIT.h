@@ -217,6 +217,7 @@ namespace JSC {
 
     struct ThunkHelpers {
         static unsigned stringImplDataOffset() { return StringImpl::dataOffset(); }
+        static unsigned stringImplIs8BitOffset() { return StringImpl::is8BitOffset(); }
         static unsigned jsStringLengthOffset() { return OBJECT_OFFSETOF(JSString, m_length); }
         static unsigned jsStringValueOffset() { return OBJECT_OFFSETOF(JSString, m_value); }
     };
@@ -32,6 +32,7 @@
 #include "JSLock.h"
 #include "JSString.h"
 #include "SamplingTool.h"
+#include "UStringConcatenate.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -101,11 +102,18 @@ struct Options {
     Options()
         : interactive(false)
         , dump(false)
+        , logGC(false)
+        , logGCObjectTypes(false)
+        , persistCache(false)
     {
     }
 
     bool interactive;
     bool dump;
+    bool logGC;
+    bool logGCObjectTypes;
+    bool persistCache;
+    UString profileFileName;
     Vector<Script> scripts;
     Vector<UString> arguments;
 };
@@ -371,7 +379,60 @@ static void cleanupGlobalData(JSGlobalData* globalData)
     globalData->deref();
 }
 
-static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scripts, bool dump)
+// The parser cache for a script file is kept alongside it, so that later runs
+// can skip parsing the bodies of functions it has already seen.
+static UString sourceCacheFileName(const UString& fileName)
+{
+    return makeUString(fileName, ".cache");
+}
+
+static void loadSourceCache(const SourceCode& source, const UString& script, const UString& fileName)
+{
+    SourceProviderCache* cache = source.provider()->cache();
+    cache->enablePersistence(script.characters(), script.length());
+
+    FILE* f = fopen(sourceCacheFileName(fileName).utf8().data(), "rb");
+    if (!f)
+        return;
+    Vector<char> buffer;
+    char chunk[4096];
+    size_t size;
+    while ((size = fread(chunk, 1, sizeof(chunk), f)))
+        buffer.append(chunk, size);
+    fclose(f);
+    cache->load(buffer.data(), buffer.size());
+}
+
+static void saveSourceCache(const SourceCode& source, const UString& fileName)
+{
+    SourceProviderCache* cache = source.provider()->cache();
+    if (!cache->hasUnsavedChanges())
+        return;
+
+    Vector<char> buffer;
+    cache->save(buffer);
+    FILE* f = fopen(sourceCacheFileName(fileName).utf8().data(), "wb");
+    if (!f) {
+        fprintf(stderr, "Could not write source cache for: %s\n", fileName.utf8().data());
+        return;
+    }
+    fwrite(buffer.data(), 1, buffer.size(), f);
+    fclose(f);
+}
+
+static void saveSampledStacks(const UString& sampledStacks, const UString& fileName)
+{
+    CString stacks = sampledStacks.utf8();
+    FILE* f = fopen(fileName.utf8().data(), "w");
+    if (!f) {
+        fprintf(stderr, "Could not write profile to: %s\n", fileName.utf8().data());
+        return;
+    }
+    fwrite(stacks.data(), 1, stacks.length(), f);
+    fclose(f);
+}
+
+static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scripts, bool dump, bool persistCache)
 {
     UString script;
     UString fileName;
@@ -398,10 +459,17 @@ static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scr
             fileName = "[Command Line]";
         }
 
+        SourceCode source = makeSource(script, fileName);
+        bool persistsCache = persistCache && scripts[i].isFile;
+        if (persistsCache)
+            loadSourceCache(source, script, fileName);
+
         globalData.startSampling();
 
-        Completion completion = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), makeSource(script, fileName));
+        Completion completion = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), source);
         success = success && completion.complType() != Throw;
+        if (persistsCache)
+            saveSourceCache(source, fileName);
         if (dump) {
             if (completion.complType() == Throw)
                 printf("Exception: %s\n", completion.value().toString(globalObject->globalExec()).utf8().data());
@@ -464,14 +532,59 @@ static void runInteractive(GlobalObject* globalObject)
     printf("\n");
 }
 
+class GCLogger : public GCObserver {
+public:
+    GCLogger(bool logObjectTypes)
+        : m_logObjectTypes(logObjectTypes)
+        , m_collectionCount(0)
+    {
+    }
+
+    virtual bool wantsObjectTypeCounts() { return m_logObjectTypes; }
+    virtual void didCollect(const GCEvent&);
+
+private:
+    bool m_logObjectTypes;
+    unsigned m_collectionCount;
+};
+
+void GCLogger::didCollect(const GCEvent& event)
+{
+    ++m_collectionCount;
+    fprintf(stderr, "GC #%u (%s): mark %.3fms, sweep %.3fms, %lu -> %lu bytes (%lu freed), capacity %lu -> %lu bytes%s\n",
+        m_collectionCount, event.isFullCollection ? "full" : "nursery",
+        event.markTime * 1000, event.sweepTime * 1000,
+        static_cast<unsigned long>(event.sizeBefore), static_cast<unsigned long>(event.sizeAfter),
+        static_cast<unsigned long>(event.bytesFreed()),
+        static_cast<unsigned long>(event.capacityBefore), static_cast<unsigned long>(event.capacityAfter),
+        event.didShrink ? ", shrunk" : "");
+
+    for (size_t i = 0; i < event.sizeClasses.size(); ++i) {
+        const MarkedSpace::SizeClassStatistics& sizeClass = event.sizeClasses[i];
+        fprintf(stderr, "    %5lu-byte cells: %lu blocks, %lu live\n",
+            static_cast<unsigned long>(sizeClass.cellSize), static_cast<unsigned long>(sizeClass.blockCount),
+            static_cast<unsigned long>(sizeClass.cellCount));
+    }
+
+    if (!event.objectTypeCounts)
+        return;
+    TypeCountSet::const_iterator end = event.objectTypeCounts->end();
+    for (TypeCountSet::const_iterator it = event.objectTypeCounts->begin(); it != end; ++it)
+        fprintf(stderr, "    %s: %u\n", it->first, it->second);
+}
+
 static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help = false)
 {
     fprintf(stderr, "Usage: jsc [options] [files] [-- arguments]\n");
+    fprintf(stderr, "  -b         Keeps the parser cache for each file in <file>.cache\n");
     fprintf(stderr, "  -d         Dumps bytecode (debug builds only)\n");
     fprintf(stderr, "  -e         Evaluate argument as script code\n");
     fprintf(stderr, "  -f         Specifies a source file (deprecated)\n");
+    fprintf(stderr, "  -g         Logs each garbage collection to stderr\n");
+    fprintf(stderr, "  -G         Like -g, and also counts surviving objects by type\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -i         Enables interactive mode (default if no files are specified)\n");
+    fprintf(stderr, "  -p <file>  Samples the running scripts and writes their stacks to <file> for flame graph tools\n");
 #if HAVE(SIGNAL_H)
     fprintf(stderr, "  -s         Installs signal handlers that exit on a crash (Unix platforms only)\n");
 #endif
@@ -501,10 +614,29 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             options.interactive = true;
             continue;
         }
+        if (!strcmp(arg, "-b")) {
+            options.persistCache = true;
+            continue;
+        }
+        if (!strcmp(arg, "-p")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            options.profileFileName = argv[i];
+            continue;
+        }
         if (!strcmp(arg, "-d")) {
             options.dump = true;
             continue;
         }
+        if (!strcmp(arg, "-g")) {
+            options.logGC = true;
+            continue;
+        }
+        if (!strcmp(arg, "-G")) {
+            options.logGC = true;
+            options.logGCObjectTypes = true;
+            continue;
+        }
         if (!strcmp(arg, "-s")) {
 #if HAVE(SIGNAL_H)
             signal(SIGILL, _exit);
@@ -537,11 +669,20 @@ int jscmain(int argc, char** argv, JSGlobalData* globalData)
     Options options;
     parseArguments(argc, argv, options, globalData);
 
+    if (options.logGC)
+        globalData->heap.setGCObserver(adoptPtr(new GCLogger(options.logGCObjectTypes)));
+
+    if (!options.profileFileName.isEmpty())
+        globalData->startSamplingProfiler();
+
     GlobalObject* globalObject = new (globalData) GlobalObject(*globalData, options.arguments);
-    bool success = runWithScripts(globalObject, options.scripts, options.dump);
+    bool success = runWithScripts(globalObject, options.scripts, options.dump, options.persistCache);
     if (options.interactive && success)
         runInteractive(globalObject);
 
+    if (!options.profileFileName.isEmpty())
+        saveSampledStacks(globalData->stopSamplingProfiler(), options.profileFileName);
+
     return success ? 0 : 3;
 }
 
@@ -468,12 +468,13 @@ private:
         {
             ASSERT(m_isFunction);
             m_usesEval = info->usesEval;
+            // Info loaded from a saved cache holds plain strings, not identifiers.
             unsigned size = info->usedVariables.size();
             for (unsigned i = 0; i < size; ++i)
-                m_usedVariables.add(info->usedVariables[i]);
+                m_usedVariables.add(Identifier(m_globalData, info->usedVariables[i].get()).impl());
             size = info->writtenVariables.size();
             for (unsigned i = 0; i < size; ++i)
-                m_writtenVariables.add(info->writtenVariables[i]);
+                m_writtenVariables.add(Identifier(m_globalData, info->writtenVariables[i].get()).impl());
         }
 
     private:
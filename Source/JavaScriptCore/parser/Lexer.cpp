@@ -233,15 +233,10 @@ Lexer::~Lexer()
     m_keywordTable.deleteTable();
 }
 
-ALWAYS_INLINE const UChar* Lexer::currentCharacter() const
-{
-    ASSERT(m_code <= m_codeEnd);
-    return m_code;
-}
-
 ALWAYS_INLINE int Lexer::currentOffset() const
 {
-    return currentCharacter() - m_codeStart;
+    ASSERT(m_position <= m_end);
+    return m_position;
 }
 
 void Lexer::setCode(const SourceCode& source, ParserArena& arena)
@@ -252,20 +247,27 @@ void Lexer::setCode(const SourceCode& source, ParserArena& arena)
     m_delimited = false;
     m_lastToken = -1;
 
-    const UChar* data = source.provider()->data();
+    SourceProvider* provider = source.provider();
 
     m_source = &source;
-    m_codeStart = data;
-    m_code = data + source.startOffset();
-    m_codeEnd = data + source.endOffset();
+    m_is8Bit = provider->is8Bit();
+    if (m_is8Bit) {
+        m_data8 = provider->data8();
+        m_data16 = 0;
+    } else {
+        m_data8 = 0;
+        m_data16 = provider->data();
+    }
+    m_position = source.startOffset();
+    m_end = source.endOffset();
     m_error = false;
     m_atLineStart = true;
 
     m_buffer8.reserveInitialCapacity(initialReadBufferCapacity);
-    m_buffer16.reserveInitialCapacity((m_codeEnd - m_code) / 2);
+    m_buffer16.reserveInitialCapacity((m_end - m_position) / 2);
 
-    if (LIKELY(m_code < m_codeEnd))
-        m_current = *m_code;
+    if (LIKELY(m_position < m_end))
+        m_current = characterAt(m_position);
     else
         m_current = -1;
     ASSERT(currentOffset() == source.startOffset());
@@ -276,17 +278,17 @@ ALWAYS_INLINE void Lexer::shift()
     // Faster than an if-else sequence
     ASSERT(m_current != -1);
     m_current = -1;
-    ++m_code;
-    if (LIKELY(m_code < m_codeEnd))
-        m_current = *m_code;
+    ++m_position;
+    if (LIKELY(m_position < m_end))
+        m_current = characterAt(m_position);
 }
 
 ALWAYS_INLINE int Lexer::peek(int offset)
 {
     // Only use if necessary
     ASSERT(offset > 0 && offset < 5);
-    const UChar* code = m_code + offset;
-    return (code < m_codeEnd) ? *code : -1;
+    int position = m_position + offset;
+    return (position < m_end) ? characterAt(position) : -1;
 }
 
 int Lexer::getUnicodeCharacter()
@@ -320,11 +322,29 @@ void Lexer::shiftLineTerminator()
     ++m_lineNumber;
 }
 
+ALWAYS_INLINE void Lexer::recordSourceRange16(int start, int end)
+{
+    ASSERT(start <= end);
+    if (!m_is8Bit) {
+        m_buffer16.append(m_data16 + start, end - start);
+        return;
+    }
+    for (int i = start; i < end; ++i)
+        m_buffer16.append(m_data8[i]);
+}
+
 ALWAYS_INLINE const Identifier* Lexer::makeIdentifier(const UChar* characters, size_t length)
 {
     return &m_arena->makeIdentifier(m_globalData, characters, length);
 }
 
+ALWAYS_INLINE const Identifier* Lexer::makeIdentifierFromSource(int start, int end)
+{
+    if (m_is8Bit)
+        return &m_arena->makeIdentifier(m_globalData, m_data8 + start, end - start);
+    return &m_arena->makeIdentifier(m_globalData, m_data16 + start, end - start);
+}
+
 ALWAYS_INLINE bool Lexer::lastTokenWasRestrKeyword() const
 {
     return m_lastToken == CONTINUE || m_lastToken == BREAK || m_lastToken == RETURN || m_lastToken == THROW;
@@ -402,8 +422,7 @@ inline void Lexer::record16(int c)
 ALWAYS_INLINE JSTokenType Lexer::parseIdentifier(JSTokenData* lvalp, LexType lexType)
 {
     bool bufferRequired = false;
-    const UChar* identifierStart = currentCharacter();
-    int identifierLength;
+    int identifierStart = m_position;
 
     while (true) {
         if (LIKELY(isIdentPart(m_current))) {
@@ -415,8 +434,8 @@ ALWAYS_INLINE JSTokenType Lexer::parseIdentifier(JSTokenData* lvalp, LexType lex
 
         // \uXXXX unicode characters.
         bufferRequired = true;
-        if (identifierStart != currentCharacter())
-            m_buffer16.append(identifierStart, currentCharacter() - identifierStart);
+        if (identifierStart != m_position)
+            recordSourceRange16(identifierStart, m_position);
         shift();
         if (UNLIKELY(m_current != 'u'))
             return ERRORTOK;
@@ -427,19 +446,18 @@ ALWAYS_INLINE JSTokenType Lexer::parseIdentifier(JSTokenData* lvalp, LexType lex
         if (UNLIKELY(m_buffer16.size() ? !isIdentPart(character) : !isIdentStart(character)))
             return ERRORTOK;
         record16(character);
-        identifierStart = currentCharacter();
+        identifierStart = m_position;
     }
 
+    const Identifier* ident;
     if (!bufferRequired)
-        identifierLength = currentCharacter() - identifierStart;
+        ident = makeIdentifierFromSource(identifierStart, m_position);
     else {
-        if (identifierStart != currentCharacter())
-            m_buffer16.append(identifierStart, currentCharacter() - identifierStart);
-        identifierStart = m_buffer16.data();
-        identifierLength = m_buffer16.size();
+        if (identifierStart != m_position)
+            recordSourceRange16(identifierStart, m_position);
+        ident = makeIdentifier(m_buffer16.data(), m_buffer16.size());
     }
 
-    const Identifier* ident = makeIdentifier(identifierStart, identifierLength);
     lvalp->ident = ident;
     m_delimited = false;
 
@@ -458,12 +476,12 @@ ALWAYS_INLINE bool Lexer::parseString(JSTokenData* lvalp, bool strictMode)
     int stringQuoteCharacter = m_current;
     shift();
 
-    const UChar* stringStart = currentCharacter();
+    int stringStart = m_position;
 
     while (m_current != stringQuoteCharacter) {
         if (UNLIKELY(m_current == '\\')) {
-            if (stringStart != currentCharacter())
-                m_buffer16.append(stringStart, currentCharacter() - stringStart);
+            if (stringStart != m_position)
+                recordSourceRange16(stringStart, m_position);
             shift();
 
             int escape = singleEscape(m_current);
@@ -520,7 +538,7 @@ ALWAYS_INLINE bool Lexer::parseString(JSTokenData* lvalp, bool strictMode)
             } else
                 return false;
 
-            stringStart = currentCharacter();
+            stringStart = m_position;
             continue;
         }
         // Fast check for characters that require special handling.
@@ -535,8 +553,13 @@ ALWAYS_INLINE bool Lexer::parseString(JSTokenData* lvalp, bool strictMode)
         shift();
     }
 
-    if (currentCharacter() != stringStart)
-        m_buffer16.append(stringStart, currentCharacter() - stringStart);
+    // A string without escapes is taken straight from the source, keeping Latin-1 sources narrow.
+    if (m_buffer16.isEmpty()) {
+        lvalp->ident = makeIdentifierFromSource(stringStart, m_position);
+        return true;
+    }
+    if (m_position != stringStart)
+        recordSourceRange16(stringStart, m_position);
     lvalp->ident = makeIdentifier(m_buffer16.data(), m_buffer16.size());
     m_buffer16.resize(0);
     return true;
@@ -705,11 +728,11 @@ ALWAYS_INLINE bool Lexer::parseMultilineComment()
 
 bool Lexer::nextTokenIsColon()
 {
-    const UChar* code = m_code;
-    while (code < m_codeEnd && (isWhiteSpace(*code) || isLineTerminator(*code)))
-        code++;
+    int position = m_position;
+    while (position < m_end && (isWhiteSpace(characterAt(position)) || isLineTerminator(characterAt(position))))
+        position++;
         
-    return code < m_codeEnd && *code == ':';
+    return position < m_end && characterAt(position) == ':';
 }
 
 JSTokenType Lexer::lex(JSTokenData* lvalp, JSTokenInfo* llocp, LexType lexType, bool strictMode)
@@ -1197,8 +1220,8 @@ void Lexer::clear()
 
 SourceCode Lexer::sourceCode(int openBrace, int closeBrace, int firstLine)
 {
-    ASSERT(m_source->provider()->data()[openBrace] == '{');
-    ASSERT(m_source->provider()->data()[closeBrace] == '}');
+    ASSERT(characterAt(openBrace) == '{');
+    ASSERT(characterAt(closeBrace) == '}');
     return SourceCode(m_source->provider(), openBrace, closeBrace + 1, firstLine);
 }
 
@@ -66,17 +66,17 @@ namespace JSC {
         // Functions for use after parsing.
         bool sawError() const { return m_error; }
         void clear();
-        int currentOffset() { return m_code - m_codeStart; }
+        int currentOffset() { return m_position; }
         void setOffset(int offset)
         {
             m_error = 0;
-            m_code = m_codeStart + offset;
+            m_position = offset;
             m_buffer8.resize(0);
             m_buffer16.resize(0);
             // Faster than an if-else sequence
             m_current = -1;
-            if (LIKELY(m_code < m_codeEnd))
-                m_current = *m_code;
+            if (LIKELY(m_position < m_end))
+                m_current = characterAt(m_position);
         }
         void setLineNumber(int line)
         {
@@ -102,10 +102,12 @@ namespace JSC {
         int getUnicodeCharacter();
         void shiftLineTerminator();
 
-        ALWAYS_INLINE const UChar* currentCharacter() const;
+        ALWAYS_INLINE int characterAt(int position) const { return m_is8Bit ? m_data8[position] : m_data16[position]; }
         ALWAYS_INLINE int currentOffset() const;
 
+        ALWAYS_INLINE void recordSourceRange16(int start, int end);
         ALWAYS_INLINE const Identifier* makeIdentifier(const UChar* characters, size_t length);
+        ALWAYS_INLINE const Identifier* makeIdentifierFromSource(int start, int end);
 
         ALWAYS_INLINE bool lastTokenWasRestrKeyword() const;
 
@@ -130,9 +132,12 @@ namespace JSC {
         int m_lastToken;
 
         const SourceCode* m_source;
-        const UChar* m_code;
-        const UChar* m_codeStart;
-        const UChar* m_codeEnd;
+        // Latin-1 sources are lexed in place rather than widened to UTF-16 first.
+        bool m_is8Bit;
+        const LChar* m_data8;
+        const UChar* m_data16;
+        int m_position;
+        int m_end;
         bool m_isReparsing;
         bool m_atLineStart;
         bool m_error;
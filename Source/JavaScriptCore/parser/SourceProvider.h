@@ -56,6 +56,10 @@ namespace JSC {
         virtual UString getRange(int start, int end) const = 0;
         virtual const UChar* data() const = 0;
         virtual int length() const = 0;
+
+        // Providers whose source is entirely Latin-1 can expose it without widening.
+        virtual bool is8Bit() const { return false; }
+        virtual const LChar* data8() const { ASSERT_NOT_REACHED(); return 0; }
         
         const UString& url() { return m_url; }
         virtual TextPosition1 startPosition() const { return TextPosition1::minimumPosition(); }
@@ -89,6 +93,8 @@ namespace JSC {
         }
         const UChar* data() const { return m_source.characters(); }
         int length() const { return m_source.length(); }
+        bool is8Bit() const { return m_source.is8Bit(); }
+        const LChar* data8() const { return m_source.characters8(); }
 
     private:
         UStringSourceProvider(const UString& source, const UString& url)
@@ -27,6 +27,8 @@
 #include "SourceProviderCache.h"
 
 #include "SourceProviderCacheItem.h"
+#include <wtf/OwnPtr.h>
+#include <wtf/SHA1.h>
 
 namespace JSC {
 
@@ -39,6 +41,7 @@ void SourceProviderCache::clear()
 {
     deleteAllValues(m_map);
     m_map.clear();
+    m_hasUnsavedChanges = false;
     m_contentByteSize = 0;
 }
 
@@ -47,10 +50,181 @@ unsigned SourceProviderCache::byteSize() const
     return m_contentByteSize + sizeof(*this) + m_map.capacity() * sizeof(SourceProviderCacheItem*);
 }
 
+// Bounds the memory a single source can hold on to. Once full, functions that
+// are not yet cached are simply parsed every time.
+static const unsigned maximumContentByteSize = 8 * 1024 * 1024;
+
+bool SourceProviderCache::hasRoomFor(unsigned size) const
+{
+    return size <= maximumContentByteSize - std::min(m_contentByteSize, maximumContentByteSize);
+}
+
 void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem> item, unsigned size)
 {
-    m_map.add(sourcePosition, item.leakPtr());
+    if (!hasRoomFor(size))
+        return;
+    if (!m_map.add(sourcePosition, item.get()).second)
+        return;
+    item.leakPtr();
     m_contentByteSize += size;
+    m_hasUnsavedChanges = true;
+}
+
+// Saved caches are only ever loaded back by the build that saved them, so are
+// stored in native byte order. The header names the source by its digest, and is
+// followed by a SHA-1 digest of the rest of the cache, so that a cache damaged on its way to and from storage is
+// rejected as a whole rather than partly decoded.
+static const unsigned cacheMagic = 0x4a535043;
+static const unsigned cacheFormatVersion = 4;
+static const size_t cacheDigestSize = 20;
+
+static void computeDigest(const char* data, size_t size, Vector<uint8_t, 20>& digest)
+{
+    SHA1 sha1;
+    sha1.addBytes(reinterpret_cast<const uint8_t*>(data), size);
+    sha1.computeHash(digest);
+}
+
+void SourceProviderCache::enablePersistence(const UChar* source, unsigned length)
+{
+    ASSERT(m_map.isEmpty());
+    m_isPersistent = true;
+    computeDigest(reinterpret_cast<const char*>(source), length * sizeof(UChar), m_sourceDigest);
+}
+
+template <typename T> static void append(Vector<char>& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void appendStrings(Vector<char>& buffer, const Vector<RefPtr<StringImpl> >& strings)
+{
+    append(buffer, static_cast<unsigned>(strings.size()));
+    for (size_t i = 0; i < strings.size(); ++i) {
+        StringImpl* string = strings[i].get();
+        append(buffer, string->length());
+        append(buffer, string->is8Bit());
+        if (string->is8Bit())
+            buffer.append(reinterpret_cast<const char*>(string->characters8()), string->length() * sizeof(LChar));
+        else
+            buffer.append(reinterpret_cast<const char*>(string->characters16()), string->length() * sizeof(UChar));
+    }
+}
+
+template <typename T> static bool read(const char*& position, const char* end, T& value)
+{
+    if (static_cast<size_t>(end - position) < sizeof(T))
+        return false;
+    memcpy(&value, position, sizeof(T));
+    position += sizeof(T);
+    return true;
+}
+
+static bool readStrings(const char*& position, const char* end, Vector<RefPtr<StringImpl> >& strings)
+{
+    unsigned count;
+    if (!read(position, end, count))
+        return false;
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned length;
+        bool is8Bit;
+        if (!read(position, end, length) || !read(position, end, is8Bit))
+            return false;
+        size_t size = static_cast<size_t>(length) * (is8Bit ? sizeof(LChar) : sizeof(UChar));
+        if (static_cast<size_t>(end - position) < size)
+            return false;
+        if (is8Bit)
+            strings.append(StringImpl::create(reinterpret_cast<const LChar*>(position), length));
+        else {
+            UChar* characters;
+            strings.append(StringImpl::createUninitialized(length, characters));
+            memcpy(characters, position, size);
+        }
+        position += size;
+    }
+    strings.shrinkToFit();
+    return true;
+}
+
+void SourceProviderCache::save(Vector<char>& buffer) const
+{
+    ASSERT(m_isPersistent);
+    append(buffer, cacheMagic);
+    append(buffer, cacheFormatVersion);
+    buffer.append(reinterpret_cast<const char*>(m_sourceDigest.data()), cacheDigestSize);
+
+    size_t digestOffset = buffer.size();
+    buffer.grow(digestOffset + cacheDigestSize);
+    size_t contentsOffset = buffer.size();
+
+    append(buffer, static_cast<unsigned>(m_map.size()));
+    HashMap<int, SourceProviderCacheItem*>::const_iterator mapEnd = m_map.end();
+    for (HashMap<int, SourceProviderCacheItem*>::const_iterator it = m_map.begin(); it != mapEnd; ++it) {
+        const SourceProviderCacheItem* item = it->second;
+        append(buffer, it->first);
+        append(buffer, item->closeBraceLine);
+        append(buffer, item->closeBracePos);
+        append(buffer, item->usesEval);
+        appendStrings(buffer, item->usedVariables);
+        appendStrings(buffer, item->writtenVariables);
+    }
+
+    Vector<uint8_t, 20> digest;
+    computeDigest(buffer.data() + contentsOffset, buffer.size() - contentsOffset, digest);
+    ASSERT(digest.size() == cacheDigestSize);
+    memcpy(buffer.data() + digestOffset, digest.data(), cacheDigestSize);
+}
+
+bool SourceProviderCache::load(const char* data, size_t size)
+{
+    ASSERT(m_isPersistent);
+    bool hadUnsavedChanges = m_hasUnsavedChanges;
+    if (!loadContents(data, size)) {
+        clear();
+        return false;
+    }
+    // What was just loaded has already been saved.
+    m_hasUnsavedChanges = hadUnsavedChanges;
+    return true;
+}
+
+bool SourceProviderCache::loadContents(const char* data, size_t size)
+{
+    const char* position = data;
+    const char* end = data + size;
+    unsigned magic;
+    unsigned version;
+    unsigned count;
+    if (!read(position, end, magic) || magic != cacheMagic
+        || !read(position, end, version) || version != cacheFormatVersion
+        || static_cast<size_t>(end - position) < 2 * cacheDigestSize
+        || memcmp(m_sourceDigest.data(), position, cacheDigestSize))
+        return false;
+    position += cacheDigestSize;
+
+    Vector<uint8_t, 20> digest;
+    computeDigest(position + cacheDigestSize, end - position - cacheDigestSize, digest);
+    if (memcmp(digest.data(), position, cacheDigestSize))
+        return false;
+    position += cacheDigestSize;
+
+    if (!read(position, end, count))
+        return false;
+
+    for (unsigned i = 0; i < count; ++i) {
+        int sourcePosition;
+        int closeBraceLine;
+        int closeBracePos;
+        if (!read(position, end, sourcePosition) || !read(position, end, closeBraceLine) || !read(position, end, closeBracePos))
+            return false;
+        OwnPtr<SourceProviderCacheItem> item = adoptPtr(new SourceProviderCacheItem(closeBraceLine, closeBracePos));
+        if (!read(position, end, item->usesEval) || !readStrings(position, end, item->usedVariables) || !readStrings(position, end, item->writtenVariables))
+            return false;
+        unsigned itemSize = item->approximateByteSize();
+        add(sourcePosition, item.release(), itemSize);
+    }
+
+    return position == end;
 }
 
 }
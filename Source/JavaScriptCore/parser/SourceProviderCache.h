@@ -25,6 +25,8 @@
 
 #include <wtf/HashMap.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/Vector.h>
+#include <wtf/unicode/Unicode.h>
 
 namespace JSC {
 
@@ -32,7 +34,12 @@ class SourceProviderCacheItem;
 
 class SourceProviderCache {
 public:
-    SourceProviderCache() : m_contentByteSize(0) {}
+    SourceProviderCache()
+        : m_contentByteSize(0)
+        , m_isPersistent(false)
+        , m_hasUnsavedChanges(false)
+    {
+    }
     ~SourceProviderCache();
 
     void clear();
@@ -40,9 +47,26 @@ public:
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
 
+    // An embedder may persist the cache across loads of the source, so that the
+    // parser can skip the bodies of known functions from the first parse onwards.
+    // A saved cache is only loaded back for the same source text, which is
+    // identified by a SHA-1 digest of all of its characters.
+    void enablePersistence(const UChar* source, unsigned length);
+    bool isPersistent() const { return m_isPersistent; }
+
+    bool hasUnsavedChanges() const { return m_hasUnsavedChanges; }
+    void save(Vector<char>&) const;
+    bool load(const char*, size_t);
+
 private:
+    bool hasRoomFor(unsigned size) const;
+    bool loadContents(const char*, size_t);
+
     HashMap<int, SourceProviderCacheItem*> m_map;
     unsigned m_contentByteSize;
+    bool m_isPersistent;
+    bool m_hasUnsavedChanges;
+    Vector<uint8_t, 20> m_sourceDigest;
 };
 
 }
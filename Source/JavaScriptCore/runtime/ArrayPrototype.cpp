@@ -489,6 +489,16 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncSlice(ExecState* exec)
     return JSValue::encode(result);
 }
 
+static void sortArray(ExecState* exec, JSArray* array, JSValue function, CallType callType, const CallData& callData)
+{
+    if (isNumericCompareFunction(exec, callType, callData))
+        array->sortNumeric(exec, function, callType, callData);
+    else if (callType != CallTypeNone)
+        array->sort(exec, function, callType, callData);
+    else
+        array->sort(exec);
+}
+
 EncodedJSValue JSC_HOST_CALL arrayProtoFuncSort(ExecState* exec)
 {
     JSObject* thisObj = exec->hostThisValue().toThisObject(exec);
@@ -501,50 +511,36 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncSort(ExecState* exec)
     CallType callType = getCallData(function, callData);
 
     if (thisObj->classInfo() == &JSArray::s_info) {
-        if (isNumericCompareFunction(exec, callType, callData))
-            asArray(thisObj)->sortNumeric(exec, function, callType, callData);
-        else if (callType != CallTypeNone)
-            asArray(thisObj)->sort(exec, function, callType, callData);
-        else
-            asArray(thisObj)->sort(exec);
+        sortArray(exec, asArray(thisObj), function, callType, callData);
         return JSValue::encode(thisObj);
     }
 
-    // "Min" sort. Not the fastest, but definitely less code than heapsort
-    // or quicksort, and much less swapping than bubblesort/insertionsort.
-    for (unsigned i = 0; i < length - 1; ++i) {
-        JSValue iObj = thisObj->get(exec, i);
+    // Other objects are sorted by copying their elements into an array, sorting that, and
+    // copying the elements back, so they get the same O(n log n) sorts as arrays do.
+    // Holes are not copied, so they end up after the undefined values, as they do for arrays.
+    JSArray* values = constructEmptyArray(exec);
+    for (unsigned i = 0; i < length; ++i) {
+        JSValue value = getProperty(exec, thisObj, i);
+        if (exec->hadException())
+            return JSValue::encode(jsUndefined());
+        if (value)
+            values->push(exec, value);
+    }
+
+    sortArray(exec, values, function, callType, callData);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+
+    unsigned numValues = values->length();
+    for (unsigned i = 0; i < numValues; ++i) {
+        thisObj->put(exec, i, values->get(exec, i));
+        if (exec->hadException())
+            return JSValue::encode(jsUndefined());
+    }
+    for (unsigned i = numValues; i < length; ++i) {
+        thisObj->deleteProperty(exec, i);
         if (exec->hadException())
             return JSValue::encode(jsUndefined());
-        unsigned themin = i;
-        JSValue minObj = iObj;
-        for (unsigned j = i + 1; j < length; ++j) {
-            JSValue jObj = thisObj->get(exec, j);
-            if (exec->hadException())
-                return JSValue::encode(jsUndefined());
-            double compareResult;
-            if (jObj.isUndefined())
-                compareResult = 1; // don't check minObj because there's no need to differentiate == (0) from > (1)
-            else if (minObj.isUndefined())
-                compareResult = -1;
-            else if (callType != CallTypeNone) {
-                MarkedArgumentBuffer l;
-                l.append(jObj);
-                l.append(minObj);
-                compareResult = call(exec, function, callType, callData, exec->globalThisValue(), l).toNumber(exec);
-            } else
-                compareResult = (jObj.toString(exec) < minObj.toString(exec)) ? -1 : 1;
-
-            if (compareResult < 0) {
-                themin = j;
-                minObj = jObj;
-            }
-        }
-        // Swap themin and i
-        if (themin > i) {
-            thisObj->put(exec, i, minObj);
-            thisObj->put(exec, themin, iObj);
-        }
     }
     return JSValue::encode(thisObj);
 }
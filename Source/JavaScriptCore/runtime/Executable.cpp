@@ -142,6 +142,14 @@ void EvalExecutable::markChildren(MarkStack& markStack)
         m_evalCodeBlock->markAggregate(markStack);
 }
 
+#if ENABLE(JIT)
+void EvalExecutable::unlinkCallsToDiscardedCode()
+{
+    if (m_evalCodeBlock)
+        m_evalCodeBlock->unlinkCallsToDiscardedCode();
+}
+#endif
+
 JSObject* ProgramExecutable::checkSyntax(ExecState* exec)
 {
     JSObject* exception = 0;
@@ -193,34 +201,6 @@ JSObject* ProgramExecutable::compileInternal(ExecState* exec, ScopeChainNode* sc
    return 0;
 }
 
-#if ENABLE(JIT)
-static bool tryDFGCompile(JSGlobalData* globalData, CodeBlock* codeBlock, JITCode& jitCode, MacroAssemblerCodePtr& jitCodeWithArityCheck)
-{
-#if ENABLE(DFG_JIT)
-#if ENABLE(DFG_JIT_RESTRICTIONS)
-    // FIXME: No flow control yet supported, don't bother scanning the bytecode if there are any jump targets.
-    // FIXME: temporarily disable property accesses until we fix regressions.
-    if (codeBlock->numberOfJumpTargets() || codeBlock->numberOfStructureStubInfos())
-        return false;
-#endif
-
-    DFG::Graph dfg;
-    if (!parse(dfg, globalData, codeBlock))
-        return false;
-
-    DFG::JITCompiler dataFlowJIT(globalData, dfg, codeBlock);
-    dataFlowJIT.compileFunction(jitCode, jitCodeWithArityCheck);
-    return true;
-#else
-    UNUSED_PARAM(globalData);
-    UNUSED_PARAM(codeBlock);
-    UNUSED_PARAM(jitCode);
-    UNUSED_PARAM(jitCodeWithArityCheck);
-    return false;
-#endif
-}
-#endif
-
 void ProgramExecutable::markChildren(MarkStack& markStack)
 {
     ScriptExecutable::markChildren(markStack);
@@ -228,14 +208,13 @@ void ProgramExecutable::markChildren(MarkStack& markStack)
         m_programCodeBlock->markAggregate(markStack);
 }
 
-JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChainNode* scopeChainNode)
+PassOwnPtr<FunctionCodeBlock> FunctionExecutable::produceCodeBlockFor(ExecState* exec, ScopeChainNode* scopeChainNode, bool isConstructor, JSObject*& exception)
 {
-    JSObject* exception = 0;
     JSGlobalData* globalData = scopeChainNode->globalData;
     RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
     if (!body) {
         ASSERT(exception);
-        return exception;
+        return nullptr;
     }
     if (m_forceUsesArguments)
         body->setUsesArguments();
@@ -244,27 +223,95 @@ JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChain
 
     JSGlobalObject* globalObject = scopeChainNode->globalObject.get();
 
+    OwnPtr<FunctionCodeBlock> codeBlock = adoptPtr(new FunctionCodeBlock(this, FunctionCode, globalObject, source().provider(), source().startOffset(), isConstructor));
+    OwnPtr<BytecodeGenerator> generator(adoptPtr(new BytecodeGenerator(body.get(), scopeChainNode, codeBlock->symbolTable(), codeBlock.get())));
+    exception = generator->generate();
+    body->destroyData();
+    if (exception)
+        return nullptr;
+
+    return codeBlock.release();
+}
+
+#if ENABLE(DFG_JIT)
+static bool canCompileWithDFG(CodeBlock* codeBlock)
+{
+#if ENABLE(DFG_JIT_RESTRICTIONS)
+    // Branches and loops are parsed by the DFG and every block head is an OSR
+    // entry, so jump targets are fine.
+    // FIXME: temporarily disable property accesses until we fix regressions;
+    // the DFG does not inline cache them yet.
+    if (codeBlock->numberOfStructureStubInfos())
+        return false;
+#else
+    UNUSED_PARAM(codeBlock);
+#endif
+    return true;
+}
+
+bool FunctionExecutable::optimizeForCall(ExecState* exec, ScopeChainNode* scopeChainNode)
+{
+    ASSERT(m_codeBlockForCall && m_codeBlockForCall->isOSRExitTarget());
+    JSGlobalData* globalData = scopeChainNode->globalData;
+
+    // The two JITs populate the CodeBlock's inline caches differently, so the DFG
+    // JIT compiles from a CodeBlock of its own. The baseline code, along with the
+    // value profiles it has collected, is kept as the target for OSR exits.
+    JSObject* exception = 0;
+    OwnPtr<FunctionCodeBlock> codeBlock = produceCodeBlockFor(exec, scopeChainNode, false, exception);
+    if (!codeBlock)
+        return false;
+
+    DFG::Graph dfg;
+    if (!parse(dfg, globalData, codeBlock.get(), m_codeBlockForCall.get()))
+        return false;
+
+    codeBlock->setAlternative(m_codeBlockForCall.release());
+
+    DFG::JITCompiler dataFlowJIT(globalData, dfg, codeBlock.get());
+    dataFlowJIT.compileFunction(m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
+#if !ENABLE(OPCODE_SAMPLING)
+    if (!BytecodeGenerator::dumpsGeneratedCode())
+        codeBlock->discardBytecode();
+#endif
+
+    m_codeBlockForCall = codeBlock.release();
+    return true;
+}
+
+bool FunctionExecutable::isOptimizedForCall() const
+{
+    // optimizeForCall() keeps the baseline CodeBlock as the alternative of the
+    // optimized one.
+    return m_codeBlockForCall && m_codeBlockForCall->alternative();
+}
+#endif
+
+JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChainNode* scopeChainNode)
+{
+    JSObject* exception = 0;
     ASSERT(!m_codeBlockForCall);
-    m_codeBlockForCall = adoptPtr(new FunctionCodeBlock(this, FunctionCode, globalObject, source().provider(), source().startOffset(), false));
-    OwnPtr<BytecodeGenerator> generator(adoptPtr(new BytecodeGenerator(body.get(), scopeChainNode, m_codeBlockForCall->symbolTable(), m_codeBlockForCall.get())));
-    if ((exception = generator->generate())) {
-        m_codeBlockForCall.clear();
-        body->destroyData();
+    m_codeBlockForCall = produceCodeBlockFor(exec, scopeChainNode, false, exception);
+    if (!m_codeBlockForCall)
         return exception;
-    }
 
     m_numParametersForCall = m_codeBlockForCall->m_numParameters;
     ASSERT(m_numParametersForCall);
     m_numCapturedVariables = m_codeBlockForCall->m_numCapturedVars;
     m_symbolTable = m_codeBlockForCall->sharedSymbolTable();
 
-    body->destroyData();
-
 #if ENABLE(JIT)
     if (exec->globalData().canUseJIT()) {
-        bool dfgCompiled = tryDFGCompile(&exec->globalData(), m_codeBlockForCall.get(), m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
-        if (!dfgCompiled)
-            m_jitCodeForCall = JIT::compile(scopeChainNode->globalData, m_codeBlockForCall.get(), &m_jitCodeForCallWithArityCheck);
+#if ENABLE(DFG_JIT)
+        // Functions start out in the baseline JIT, which profiles them and counts
+        // their executions; once hot they are recompiled by the DFG JIT (see
+        // optimizeForCall), exiting back to this code on speculation failure.
+        if (canCompileWithDFG(m_codeBlockForCall.get())) {
+            m_codeBlockForCall->setIsOSRExitTarget();
+            m_codeBlockForCall->optimizeAfterWarmUp();
+        }
+#endif
+        m_jitCodeForCall = JIT::compile(scopeChainNode->globalData, m_codeBlockForCall.get(), &m_jitCodeForCallWithArityCheck);
 
 #if !ENABLE(OPCODE_SAMPLING)
         if (!BytecodeGenerator::dumpsGeneratedCode())
@@ -279,35 +326,16 @@ JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChain
 JSObject* FunctionExecutable::compileForConstructInternal(ExecState* exec, ScopeChainNode* scopeChainNode)
 {
     JSObject* exception = 0;
-    JSGlobalData* globalData = scopeChainNode->globalData;
-    RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
-    if (!body) {
-        ASSERT(exception);
-        return exception;
-    }
-    if (m_forceUsesArguments)
-        body->setUsesArguments();
-    body->finishParsing(m_parameters, m_name);
-    recordParse(body->features(), body->hasCapturedVariables(), body->lineNo(), body->lastLine());
-
-    JSGlobalObject* globalObject = scopeChainNode->globalObject.get();
-
     ASSERT(!m_codeBlockForConstruct);
-    m_codeBlockForConstruct = adoptPtr(new FunctionCodeBlock(this, FunctionCode, globalObject, source().provider(), source().startOffset(), true));
-    OwnPtr<BytecodeGenerator> generator(adoptPtr(new BytecodeGenerator(body.get(), scopeChainNode, m_codeBlockForConstruct->symbolTable(), m_codeBlockForConstruct.get())));
-    if ((exception = generator->generate())) {
-        m_codeBlockForConstruct.clear();
-        body->destroyData();
+    m_codeBlockForConstruct = produceCodeBlockFor(exec, scopeChainNode, true, exception);
+    if (!m_codeBlockForConstruct)
         return exception;
-    }
 
     m_numParametersForConstruct = m_codeBlockForConstruct->m_numParameters;
     ASSERT(m_numParametersForConstruct);
     m_numCapturedVariables = m_codeBlockForConstruct->m_numCapturedVars;
     m_symbolTable = m_codeBlockForConstruct->sharedSymbolTable();
 
-    body->destroyData();
-
 #if ENABLE(JIT)
     if (exec->globalData().canUseJIT()) {
         m_jitCodeForConstruct = JIT::compile(scopeChainNode->globalData, m_codeBlockForConstruct.get(), &m_jitCodeForConstructWithArityCheck);
@@ -342,6 +370,31 @@ void FunctionExecutable::discardCode()
 #endif
 }
 
+#if ENABLE(JIT)
+bool FunctionExecutable::discardCodeIfCold()
+{
+    // Both code blocks must be checked, since checking clears the flags.
+    bool wasExecuted = false;
+    if (m_codeBlockForCall && m_codeBlockForCall->wasExecutedSinceLastCheck())
+        wasExecuted = true;
+    if (m_codeBlockForConstruct && m_codeBlockForConstruct->wasExecutedSinceLastCheck())
+        wasExecuted = true;
+    if (wasExecuted || (!m_codeBlockForCall && !m_codeBlockForConstruct))
+        return false;
+
+    discardCode();
+    return true;
+}
+
+void FunctionExecutable::unlinkCallsToDiscardedCode()
+{
+    if (m_codeBlockForCall)
+        m_codeBlockForCall->unlinkCallsToDiscardedCode();
+    if (m_codeBlockForConstruct)
+        m_codeBlockForConstruct->unlinkCallsToDiscardedCode();
+}
+#endif
+
 FunctionExecutable* FunctionExecutable::fromGlobalCode(const Identifier& functionName, ExecState* exec, Debugger* debugger, const SourceCode& source, JSObject** exception)
 {
     JSGlobalObject* lexicalGlobalObject = exec->lexicalGlobalObject();
@@ -231,6 +231,8 @@ namespace JSC {
         {
             return generatedJITCodeForCall();
         }
+
+        void unlinkCallsToDiscardedCode();
 #endif
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(CompoundType, StructureFlags), AnonymousSlotCount, 0); }
 
@@ -369,7 +371,21 @@ namespace JSC {
         UString paramString() const;
         SharedSymbolTable* symbolTable() const { return m_symbolTable; }
 
+#if ENABLE(DFG_JIT)
+        // Replaces the baseline JIT code for calls with code from the DFG JIT, once
+        // the baseline code has found the function to be hot. Returns false if the
+        // function cannot be compiled by the DFG JIT.
+        bool optimizeForCall(ExecState*, ScopeChainNode*);
+        bool isOptimizedForCall() const;
+#endif
+
         void discardCode();
+#if ENABLE(JIT)
+        // Discards the code if none of it has been entered since the last call,
+        // returning true if it did so.
+        bool discardCodeIfCold();
+        void unlinkCallsToDiscardedCode();
+#endif
         void markChildren(MarkStack&);
         static FunctionExecutable* fromGlobalCode(const Identifier&, ExecState*, Debugger*, const SourceCode&, JSObject** exception);
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(CompoundType, StructureFlags), AnonymousSlotCount, 0); }
@@ -378,6 +394,7 @@ namespace JSC {
         FunctionExecutable(JSGlobalData*, const Identifier& name, const SourceCode&, bool forceUsesArguments, FunctionParameters*, bool, int firstLine, int lastLine);
         FunctionExecutable(ExecState*, const Identifier& name, const SourceCode&, bool forceUsesArguments, FunctionParameters*, bool, int firstLine, int lastLine);
 
+        PassOwnPtr<FunctionCodeBlock> produceCodeBlockFor(ExecState*, ScopeChainNode*, bool isConstructor, JSObject*& exception);
         JSObject* compileForCallInternal(ExecState*, ScopeChainNode*);
         JSObject* compileForConstructInternal(ExecState*, ScopeChainNode*);
         
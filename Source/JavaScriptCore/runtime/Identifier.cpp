@@ -70,7 +70,14 @@ void deleteIdentifierTable(IdentifierTable* table)
 bool Identifier::equal(const StringImpl* r, const char* s)
 {
     int length = r->length();
-    const UChar* d = r->characters();
+    if (r->is8Bit()) {
+        const LChar* d = r->characters8();
+        for (int i = 0; i != length; ++i)
+            if (d[i] != (unsigned char)s[i])
+                return false;
+        return s[length] == 0;
+    }
+    const UChar* d = r->characters16();
     for (int i = 0; i != length; ++i)
         if (d[i] != (unsigned char)s[i])
             return false;
@@ -81,13 +88,24 @@ bool Identifier::equal(const StringImpl* r, const UChar* s, unsigned length)
 {
     if (r->length() != length)
         return false;
-    const UChar* d = r->characters();
+    if (r->is8Bit())
+        return WTF::equal(r->characters8(), s, length);
+    const UChar* d = r->characters16();
     for (unsigned i = 0; i != length; ++i)
         if (d[i] != s[i])
             return false;
     return true;
 }
 
+bool Identifier::equal(const StringImpl* r, const LChar* s, unsigned length)
+{
+    if (r->length() != length)
+        return false;
+    if (r->is8Bit())
+        return WTF::equal(r->characters8(), s, length);
+    return WTF::equal(r->characters16(), s, length);
+}
+
 struct IdentifierCStringTranslator {
     static unsigned hash(const char* c)
     {
@@ -102,10 +120,9 @@ struct IdentifierCStringTranslator {
     static void translate(StringImpl*& location, const char* c, unsigned hash)
     {
         size_t length = strlen(c);
-        UChar* d;
+        LChar* d;
         StringImpl* r = StringImpl::createUninitialized(length, d).leakRef();
-        for (size_t i = 0; i != length; i++)
-            d[i] = static_cast<unsigned char>(c[i]); // use unsigned char to zero-extend instead of sign-extend
+        memcpy(d, c, length);
         r->setHash(hash);
         location = r;
     }
@@ -170,13 +187,11 @@ struct IdentifierUCharBufferTranslator {
     }
 };
 
-uint32_t Identifier::toUInt32(const UString& string, bool& ok)
+template <typename CharType>
+static inline uint32_t toUInt32FromCharacters(const CharType* characters, unsigned length, bool& ok)
 {
     ok = false;
 
-    unsigned length = string.length();
-    const UChar* characters = string.characters();
-
     // An empty string is not a number.
     if (!length)
         return 0;
@@ -213,6 +228,44 @@ uint32_t Identifier::toUInt32(const UString& string, bool& ok)
     return value;
 }
 
+struct LCharBuffer {
+    const LChar* s;
+    unsigned int length;
+};
+
+struct IdentifierLCharBufferTranslator {
+    static unsigned hash(const LCharBuffer& buf)
+    {
+        return StringHasher::computeHash<LChar>(buf.s, buf.length);
+    }
+
+    static bool equal(StringImpl* str, const LCharBuffer& buf)
+    {
+        return Identifier::equal(str, buf.s, buf.length);
+    }
+
+    static void translate(StringImpl*& location, const LCharBuffer& buf, unsigned hash)
+    {
+        LChar* d;
+        StringImpl* r = StringImpl::createUninitialized(buf.length, d).leakRef();
+        memcpy(d, buf.s, buf.length);
+        r->setHash(hash);
+        location = r; 
+    }
+};
+
+uint32_t Identifier::toUInt32(const UString& string, bool& ok)
+{
+    StringImpl* impl = string.impl();
+    if (!impl) {
+        ok = false;
+        return 0;
+    }
+    if (impl->is8Bit())
+        return toUInt32FromCharacters(impl->characters8(), impl->length(), ok);
+    return toUInt32FromCharacters(impl->characters16(), impl->length(), ok);
+}
+
 PassRefPtr<StringImpl> Identifier::add(JSGlobalData* globalData, const UChar* s, int length)
 {
     if (length == 1) {
@@ -230,6 +283,20 @@ PassRefPtr<StringImpl> Identifier::add(JSGlobalData* globalData, const UChar* s,
     return addResult.second ? adoptRef(*addResult.first) : *addResult.first;
 }
 
+PassRefPtr<StringImpl> Identifier::add(JSGlobalData* globalData, const LChar* s, int length)
+{
+    if (length == 1)
+        return add(globalData, globalData->smallStrings.singleCharacterStringRep(s[0]));
+    if (!length)
+        return StringImpl::empty();
+    LCharBuffer buf = {s, length}; 
+    pair<HashSet<StringImpl*>::iterator, bool> addResult = globalData->identifierTable->add<LCharBuffer, IdentifierLCharBufferTranslator>(buf);
+
+    // If the string is newly-translated, then we need to adopt it.
+    // The boolean in the pair tells us if that is so.
+    return addResult.second ? adoptRef(*addResult.first) : *addResult.first;
+}
+
 PassRefPtr<StringImpl> Identifier::add(ExecState* exec, const UChar* s, int length)
 {
     return add(&exec->globalData(), s, length);
@@ -243,7 +310,7 @@ PassRefPtr<StringImpl> Identifier::addSlowCase(JSGlobalData* globalData, StringI
     ASSERT(r->length());
 
     if (r->length() == 1) {
-        UChar c = r->characters()[0];
+        UChar c = (*r)[0];
         if (c <= maxSingleCharacterString)
             r = globalData->smallStrings.singleCharacterStringRep(c);
             if (r->isIdentifier())
@@ -42,6 +42,7 @@ namespace JSC {
 
         Identifier(JSGlobalData* globalData, const char* s) : m_string(add(globalData, s)) { } // Only to be used with string literals.
         Identifier(JSGlobalData* globalData, const UChar* s, int length) : m_string(add(globalData, s, length)) { }
+        Identifier(JSGlobalData* globalData, const LChar* s, int length) : m_string(add(globalData, s, length)) { }
         Identifier(JSGlobalData* globalData, StringImpl* rep) : m_string(add(globalData, rep)) { } 
         Identifier(JSGlobalData* globalData, const UString& s) : m_string(add(globalData, s.impl())) { }
 
@@ -75,6 +76,7 @@ namespace JSC {
     
         static bool equal(const StringImpl*, const char*);
         static bool equal(const StringImpl*, const UChar*, unsigned length);
+        static bool equal(const StringImpl*, const LChar*, unsigned length);
         static bool equal(const StringImpl* a, const StringImpl* b) { return ::equal(a, b); }
 
         static PassRefPtr<StringImpl> add(ExecState*, const char*); // Only to be used with string literals.
@@ -88,6 +90,7 @@ namespace JSC {
 
         static PassRefPtr<StringImpl> add(ExecState*, const UChar*, int length);
         static PassRefPtr<StringImpl> add(JSGlobalData*, const UChar*, int length);
+        static PassRefPtr<StringImpl> add(JSGlobalData*, const LChar*, int length);
 
         static PassRefPtr<StringImpl> add(ExecState* exec, StringImpl* r)
         {
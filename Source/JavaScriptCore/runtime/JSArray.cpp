@@ -28,7 +28,7 @@
 #include "Error.h"
 #include "Executable.h"
 #include "PropertyNameArray.h"
-#include <wtf/AVLTree.h>
+#include <algorithm>
 #include <wtf/Assertions.h>
 #include <wtf/OwnPtr.h>
 #include <Operations.h>
@@ -167,6 +167,7 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, unsigned initia
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
     m_storage->reportedMapCapacity = 0;
+    m_storage->m_elementKind = Int32Elements;
 
     if (creationMode == CreateCompact) {
 #if CHECK_ARRAY_CONSISTENCY
@@ -214,6 +215,7 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, const ArgList&
     m_storage->m_sparseValueMap = 0;
     m_storage->subclassData = 0;
     m_storage->reportedMapCapacity = 0;
+    m_storage->m_elementKind = Int32Elements;
 #if CHECK_ARRAY_CONSISTENCY
     m_storage->m_inCompactInitialization = false;
 #endif
@@ -221,8 +223,10 @@ JSArray::JSArray(JSGlobalData& globalData, Structure* structure, const ArgList&
     size_t i = 0;
     WriteBarrier<Unknown>* vector = m_storage->m_vector;
     ArgList::const_iterator end = list.end();
-    for (ArgList::const_iterator it = list.begin(); it != end; ++it, ++i)
+    for (ArgList::const_iterator it = list.begin(); it != end; ++it, ++i) {
+        widenElementKind(*it);
         vector[i].set(globalData, this, *it);
+    }
     for (; i < initialStorage; i++)
         vector[i].clear();
 
@@ -353,6 +357,7 @@ void JSArray::put(ExecState* exec, unsigned i, JSValue value)
     }
 
     if (i < m_vectorLength) {
+        widenElementKind(value);
         WriteBarrier<Unknown>& valueSlot = storage->m_vector[i];
         if (valueSlot) {
             valueSlot.set(exec->globalData(), this, value);
@@ -409,6 +414,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
     if (!map || map->isEmpty()) {
         if (increaseVectorLength(i + 1)) {
             storage = m_storage;
+            widenElementKind(value);
             storage->m_vector[i].set(exec->globalData(), this, value);
             ++storage->m_numValuesInVector;
             checkConsistency();
@@ -462,8 +468,12 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
         for (unsigned j = vectorLength; j < max(vectorLength, MIN_SPARSE_ARRAY_INDEX); ++j)
             vector[j].clear();
         JSGlobalData& globalData = exec->globalData();
-        for (unsigned j = max(vectorLength, MIN_SPARSE_ARRAY_INDEX); j < newVectorLength; ++j)
-            vector[j].set(globalData, this, map->take(j).get());
+        for (unsigned j = max(vectorLength, MIN_SPARSE_ARRAY_INDEX); j < newVectorLength; ++j) {
+            JSValue movedValue = map->take(j).get();
+            if (movedValue)
+                widenElementKind(movedValue);
+            vector[j].set(globalData, this, movedValue);
+        }
     }
 
     ASSERT(i < newVectorLength);
@@ -471,6 +481,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
     m_vectorLength = newVectorLength;
     storage->m_numValuesInVector = newNumValuesInVector;
 
+    widenElementKind(value);
     storage->m_vector[i].set(exec->globalData(), this, value);
 
     checkConsistency();
@@ -737,6 +748,7 @@ void JSArray::push(ExecState* exec, JSValue value)
     ArrayStorage* storage = m_storage;
 
     if (storage->m_length < m_vectorLength) {
+        widenElementKind(value);
         storage->m_vector[storage->m_length].set(exec->globalData(), this, value);
         ++storage->m_numValuesInVector;
         ++storage->m_length;
@@ -749,6 +761,7 @@ void JSArray::push(ExecState* exec, JSValue value)
         if (!map || map->isEmpty()) {
             if (increaseVectorLength(storage->m_length + 1)) {
                 storage = m_storage;
+                widenElementKind(value);
                 storage->m_vector[storage->m_length].set(exec->globalData(), this, value);
                 ++storage->m_numValuesInVector;
                 ++storage->m_length;
@@ -862,19 +875,29 @@ void JSArray::markChildren(MarkStack& markStack)
     markChildrenDirect(markStack);
 }
 
-static int compareNumbersForQSort(const void* a, const void* b)
+static inline bool lessThanInt32(JSValue a, JSValue b)
+{
+    return a.asInt32() < b.asInt32();
+}
+
+static inline bool lessThanNumber(JSValue a, JSValue b)
 {
-    double da = static_cast<const JSValue*>(a)->uncheckedGetNumber();
-    double db = static_cast<const JSValue*>(b)->uncheckedGetNumber();
-    return (da > db) - (da < db);
+    return a.uncheckedGetNumber() < b.uncheckedGetNumber();
 }
 
+#if HAVE(MERGESORT)
 static int compareByStringPairForQSort(const void* a, const void* b)
 {
     const ValueStringPair* va = static_cast<const ValueStringPair*>(a);
     const ValueStringPair* vb = static_cast<const ValueStringPair*>(b);
     return codePointCompare(va->second, vb->second);
 }
+#else
+static bool lessThanByStringPair(const ValueStringPair& a, const ValueStringPair& b)
+{
+    return codePointCompare(a.second, b.second) < 0;
+}
+#endif
 
 void JSArray::sortNumeric(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
 {
@@ -889,22 +912,26 @@ void JSArray::sortNumeric(ExecState* exec, JSValue compareFunction, CallType cal
     if (!lengthNotIncludingUndefined)
         return;
         
-    bool allValuesAreNumbers = true;
+    // An array that has held other values may hold only numbers again, so check.
+    ArrayElementKind kind = elementKind();
     size_t size = storage->m_numValuesInVector;
-    for (size_t i = 0; i < size; ++i) {
-        if (!storage->m_vector[i].isNumber()) {
-            allValuesAreNumbers = false;
-            break;
+    if (kind == ContiguousElements) {
+        for (size_t i = 0; i < size; ++i) {
+            if (!storage->m_vector[i].isNumber())
+                return sort(exec, compareFunction, callType, callData);
         }
     }
 
-    if (!allValuesAreNumbers)
-        return sort(exec, compareFunction, callType, callData);
-
-    // For numeric comparison, which is fast, qsort is faster than mergesort. We
-    // also don't require mergesort's stability, since there's no user visible
-    // side-effect from swapping the order of equal primitive values.
-    qsort(storage->m_vector, size, sizeof(JSValue), compareNumbersForQSort);
+    // For numeric comparison, which is fast, an introsort with the comparison inlined
+    // is faster than mergesort. We also don't require mergesort's stability, since
+    // there's no user visible side-effect from swapping the order of equal primitive
+    // values. No JavaScript runs during the sort, so the values can be moved in place
+    // without write barriers.
+    JSValue* values = reinterpret_cast<JSValue*>(storage->m_vector);
+    if (kind == Int32Elements)
+        std::sort(values, values + size, lessThanInt32);
+    else
+        std::sort(values, values + size, lessThanNumber);
 
     checkConsistency(SortConsistencyCheck);
 }
@@ -958,9 +985,8 @@ void JSArray::sort(ExecState* exec)
 #if HAVE(MERGESORT)
     mergesort(values.begin(), values.size(), sizeof(ValueStringPair), compareByStringPairForQSort);
 #else
-    // FIXME: The qsort library function is likely to not be a stable sort.
     // ECMAScript-262 does not specify a stable sort, but in practice, browsers perform a stable sort.
-    qsort(values.begin(), values.size(), sizeof(ValueStringPair), compareByStringPairForQSort);
+    std::stable_sort(values.begin(), values.end(), lessThanByStringPair);
 #endif
 
     // If the toString function changed the length of the array or vector storage,
@@ -979,62 +1005,32 @@ void JSArray::sort(ExecState* exec)
     checkConsistency(SortConsistencyCheck);
 }
 
-struct AVLTreeNodeForArrayCompare {
-    JSValue value;
-
-    // Child pointers.  The high bit of gt is robbed and used as the
-    // balance factor sign.  The high bit of lt is robbed and used as
-    // the magnitude of the balance factor.
-    int32_t gt;
-    int32_t lt;
-};
-
-struct AVLTreeAbstractorForArrayCompare {
-    typedef int32_t handle; // Handle is an index into m_nodes vector.
-    typedef JSValue key;
-    typedef int32_t size;
-
-    Vector<AVLTreeNodeForArrayCompare> m_nodes;
-    ExecState* m_exec;
-    JSValue m_compareFunction;
-    CallType m_compareCallType;
-    const CallData* m_compareCallData;
-    JSValue m_globalThisValue;
-    OwnPtr<CachedCall> m_cachedCall;
-
-    handle get_less(handle h) { return m_nodes[h].lt & 0x7FFFFFFF; }
-    void set_less(handle h, handle lh) { m_nodes[h].lt &= 0x80000000; m_nodes[h].lt |= lh; }
-    handle get_greater(handle h) { return m_nodes[h].gt & 0x7FFFFFFF; }
-    void set_greater(handle h, handle gh) { m_nodes[h].gt &= 0x80000000; m_nodes[h].gt |= gh; }
-
-    int get_balance_factor(handle h)
+class ArrayCompareFunction {
+public:
+    ArrayCompareFunction(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData, const Vector<ValueStringPair>& values)
+        : m_exec(exec)
+        , m_compareFunction(compareFunction)
+        , m_compareCallType(callType)
+        , m_compareCallData(callData)
+        , m_globalThisValue(exec->globalThisValue())
+        , m_values(values)
     {
-        if (m_nodes[h].gt & 0x80000000)
-            return -1;
-        return static_cast<unsigned>(m_nodes[h].lt) >> 31;
-    }
-
-    void set_balance_factor(handle h, int bf)
-    {
-        if (bf == 0) {
-            m_nodes[h].lt &= 0x7FFFFFFF;
-            m_nodes[h].gt &= 0x7FFFFFFF;
-        } else {
-            m_nodes[h].lt |= 0x80000000;
-            if (bf < 0)
-                m_nodes[h].gt |= 0x80000000;
-            else
-                m_nodes[h].gt &= 0x7FFFFFFF;
-        }
+        if (callType == CallTypeJS)
+            m_cachedCall = adoptPtr(new CachedCall(exec, asFunction(compareFunction), 2));
     }
 
-    int compare_key_key(key va, key vb)
+    // Whether the value at index a sorts after the value at index b. Once the compare function
+    // has thrown, every pair is reported as already in order, so the sort finishes without
+    // calling it again.
+    bool greaterThan(unsigned a, unsigned b)
     {
+        JSValue va = m_values[a].first;
+        JSValue vb = m_values[b].first;
         ASSERT(!va.isUndefined());
         ASSERT(!vb.isUndefined());
 
         if (m_exec->hadException())
-            return 1;
+            return false;
 
         double compareResult;
         if (m_cachedCall) {
@@ -1046,17 +1042,64 @@ struct AVLTreeAbstractorForArrayCompare {
             MarkedArgumentBuffer arguments;
             arguments.append(va);
             arguments.append(vb);
-            compareResult = call(m_exec, m_compareFunction, m_compareCallType, *m_compareCallData, m_globalThisValue, arguments).toNumber(m_exec);
+            compareResult = call(m_exec, m_compareFunction, m_compareCallType, m_compareCallData, m_globalThisValue, arguments).toNumber(m_exec);
         }
-        return (compareResult < 0) ? -1 : 1; // Not passing equality through, because we need to store all values, even if equivalent.
+        return compareResult > 0;
     }
 
-    int compare_key_node(key k, handle h) { return compare_key_key(k, m_nodes[h].value); }
-    int compare_node_node(handle h1, handle h2) { return compare_key_key(m_nodes[h1].value, m_nodes[h2].value); }
-
-    static handle null() { return 0x7FFFFFFF; }
+private:
+    ExecState* m_exec;
+    JSValue m_compareFunction;
+    CallType m_compareCallType;
+    const CallData& m_compareCallData;
+    JSValue m_globalThisValue;
+    OwnPtr<CachedCall> m_cachedCall;
+    const Vector<ValueStringPair>& m_values;
 };
 
+// A stable merge sort of the indices in [indices, indices + size), using buffer as scratch
+// space. Short runs are sorted by insertion first, then merged pairwise bottom-up. Only
+// indices move, so the values being sorted stay where the collector can find them
+// however the compare function behaves.
+static void mergeSortIndices(unsigned* indices, unsigned size, unsigned* buffer, ArrayCompareFunction& compare)
+{
+    static const unsigned insertionSortRunLength = 8;
+
+    for (unsigned runStart = 0; runStart < size; runStart += insertionSortRunLength) {
+        unsigned runEnd = min(runStart + insertionSortRunLength, size);
+        for (unsigned i = runStart + 1; i < runEnd; ++i) {
+            unsigned index = indices[i];
+            unsigned j = i;
+            for (; j > runStart && compare.greaterThan(indices[j - 1], index); --j)
+                indices[j] = indices[j - 1];
+            indices[j] = index;
+        }
+    }
+
+    unsigned* source = indices;
+    unsigned* destination = buffer;
+    for (unsigned width = insertionSortRunLength; width < size; width *= 2) {
+        for (unsigned left = 0; left < size; left += 2 * width) {
+            unsigned middle = min(left + width, size);
+            unsigned right = min(middle + width, size);
+            unsigned i = left;
+            unsigned j = middle;
+            unsigned k = left;
+            // Take from the left run on ties, which keeps the sort stable.
+            while (i < middle && j < right)
+                destination[k++] = compare.greaterThan(source[i], source[j]) ? source[j++] : source[i++];
+            while (i < middle)
+                destination[k++] = source[i++];
+            while (j < right)
+                destination[k++] = source[j++];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != indices)
+        memcpy(indices, source, size * sizeof(unsigned));
+}
+
 void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
 {
     checkConsistency();
@@ -1065,68 +1108,46 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
 
     // FIXME: This ignores exceptions raised in the compare function or in toNumber.
 
-    // The maximum tree depth is compiled in - but the caller is clearly up to no good
-    // if a larger array is passed.
-    ASSERT(storage->m_length <= static_cast<unsigned>(std::numeric_limits<int>::max()));
-    if (storage->m_length > static_cast<unsigned>(std::numeric_limits<int>::max()))
-        return;
-
     unsigned usedVectorLength = min(storage->m_length, m_vectorLength);
-    unsigned nodeCount = usedVectorLength + (storage->m_sparseValueMap ? storage->m_sparseValueMap->size() : 0);
+    unsigned valueCount = usedVectorLength + (storage->m_sparseValueMap ? storage->m_sparseValueMap->size() : 0);
 
-    if (!nodeCount)
+    if (!valueCount)
         return;
 
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44> tree; // Depth 44 is enough for 2^31 items
-    tree.abstractor().m_exec = exec;
-    tree.abstractor().m_compareFunction = compareFunction;
-    tree.abstractor().m_compareCallType = callType;
-    tree.abstractor().m_compareCallData = &callData;
-    tree.abstractor().m_globalThisValue = exec->globalThisValue();
-    tree.abstractor().m_nodes.grow(nodeCount);
-
-    if (callType == CallTypeJS)
-        tree.abstractor().m_cachedCall = adoptPtr(new CachedCall(exec, asFunction(compareFunction), 2));
-
-    if (!tree.abstractor().m_nodes.begin()) {
+    // The values are copied out before sorting, since the compare function may modify the
+    // array. Only the first member of each pair is used; the vector is pushed so that the
+    // collector marks it.
+    Vector<ValueStringPair> values;
+    Vector<unsigned> indices;
+    Vector<unsigned> buffer;
+    if (!values.tryReserveCapacity(valueCount) || !indices.tryReserveCapacity(valueCount) || !buffer.tryReserveCapacity(valueCount)) {
         throwOutOfMemoryError(exec);
         return;
     }
 
-    // FIXME: If the compare function modifies the array, the vector, map, etc. could be modified
-    // right out from under us while we're building the tree here.
+    Heap::heap(this)->pushTempSortVector(&values);
 
-    unsigned numDefined = 0;
     unsigned numUndefined = 0;
 
-    // Iterate over the array, ignoring missing values, counting undefined ones, and inserting all other ones into the tree.
-    for (; numDefined < usedVectorLength; ++numDefined) {
-        JSValue v = storage->m_vector[numDefined].get();
-        if (!v || v.isUndefined())
-            break;
-        tree.abstractor().m_nodes[numDefined].value = v;
-        tree.insert(numDefined);
-    }
-    for (unsigned i = numDefined; i < usedVectorLength; ++i) {
+    // Iterate over the array, ignoring missing values and counting undefined ones.
+    for (unsigned i = 0; i < usedVectorLength; ++i) {
         JSValue v = storage->m_vector[i].get();
-        if (v) {
-            if (v.isUndefined())
-                ++numUndefined;
-            else {
-                tree.abstractor().m_nodes[numDefined].value = v;
-                tree.insert(numDefined);
-                ++numDefined;
-            }
-        }
+        if (!v)
+            continue;
+        if (v.isUndefined())
+            ++numUndefined;
+        else
+            values.uncheckedAppend(ValueStringPair(v, UString()));
     }
 
-    unsigned newUsedVectorLength = numDefined + numUndefined;
+    unsigned newUsedVectorLength = values.size() + numUndefined;
 
     if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
         newUsedVectorLength += map->size();
         if (newUsedVectorLength > m_vectorLength) {
             // Check that it is possible to allocate an array large enough to hold all the entries.
             if ((newUsedVectorLength > MAX_STORAGE_VECTOR_LENGTH) || !increaseVectorLength(newUsedVectorLength)) {
+                Heap::heap(this)->popTempSortVector(&values);
                 throwOutOfMemoryError(exec);
                 return;
             }
@@ -1136,30 +1157,35 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
 
         SparseArrayValueMap::iterator end = map->end();
         for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
-            tree.abstractor().m_nodes[numDefined].value = it->second.get();
-            tree.insert(numDefined);
-            ++numDefined;
+            widenElementKind(it->second.get());
+            values.uncheckedAppend(ValueStringPair(it->second.get(), UString()));
         }
 
         delete map;
         storage->m_sparseValueMap = 0;
     }
 
-    ASSERT(tree.abstractor().m_nodes.size() >= numDefined);
+    unsigned numDefined = values.size();
+    for (unsigned i = 0; i < numDefined; ++i)
+        indices.uncheckedAppend(i);
+    buffer.grow(numDefined);
+
+    ArrayCompareFunction compare(exec, compareFunction, callType, callData, values);
+    mergeSortIndices(indices.data(), numDefined, buffer.data(), compare);
 
     // FIXME: If the compare function changed the length of the array, the following might be
     // modifying the vector incorrectly.
 
     // Copy the values back into m_storage.
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44>::Iterator iter;
-    iter.start_iter_least(tree);
     JSGlobalData& globalData = exec->globalData();
-    for (unsigned i = 0; i < numDefined; ++i) {
-        storage->m_vector[i].set(globalData, this, tree.abstractor().m_nodes[*iter].value);
-        ++iter;
-    }
+    for (unsigned i = 0; i < numDefined; ++i)
+        storage->m_vector[i].set(globalData, this, values[indices[i]].first);
+
+    Heap::heap(this)->popTempSortVector(&values);
 
     // Put undefined values back in.
+    if (numDefined < newUsedVectorLength)
+        widenElementKind(jsUndefined());
     for (unsigned i = numDefined; i < newUsedVectorLength; ++i)
         storage->m_vector[i].setUndefined();
 
@@ -1249,13 +1275,17 @@ unsigned JSArray::compactForSorting()
         }
 
         SparseArrayValueMap::iterator end = map->end();
-        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it)
+        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
+            widenElementKind(it->second.get());
             storage->m_vector[numDefined++].setWithoutWriteBarrier(it->second.get());
+        }
 
         delete map;
         storage->m_sparseValueMap = 0;
     }
 
+    if (numDefined < newUsedVectorLength)
+        widenElementKind(jsUndefined());
     for (unsigned i = numDefined; i < newUsedVectorLength; ++i)
         storage->m_vector[i].setUndefined();
     for (unsigned i = newUsedVectorLength; i < usedVectorLength; ++i)
@@ -29,6 +29,12 @@ namespace JSC {
 
     typedef HashMap<unsigned, WriteBarrier<Unknown> > SparseArrayValueMap;
 
+    // The kinds of values an array's vector may hold, from narrowest to widest. An array
+    // starts out with Int32Elements and widens as values are stored into its vector; it
+    // never narrows again. The collector does not visit the vector of an array that holds
+    // only numbers. Values in the sparse map are not counted.
+    enum ArrayElementKind { Int32Elements, DoubleElements, ContiguousElements };
+
     // This struct holds the actual data values of an array.  A JSArray object points to it's contained ArrayStorage
     // struct by pointing to m_vector.  To access the contained ArrayStorage struct, use the getStorage() and 
     // setStorage() methods.  It is important to note that there may be space before the ArrayStorage that 
@@ -41,6 +47,7 @@ namespace JSC {
         void* subclassData; // A JSArray subclass can use this to fill the vector lazily.
         void* m_allocBase; // Pointer to base address returned by malloc().  Keeping this pointer does eliminate false positives from the leak detector.
         size_t reportedMapCapacity;
+        unsigned m_elementKind; // An ArrayElementKind.
 #if CHECK_ARRAY_CONSISTENCY
         bool m_inCompactInitialization;
 #endif
@@ -76,6 +83,7 @@ namespace JSC {
         static JS_EXPORTDATA const ClassInfo s_info;
         
         unsigned length() const { return m_storage->m_length; }
+        ArrayElementKind elementKind() const { return static_cast<ArrayElementKind>(m_storage->m_elementKind); }
         void setLength(unsigned); // OK to use on new arrays, but not if it might be a RegExpMatchArray.
 
         void sort(ExecState*);
@@ -107,6 +115,7 @@ namespace JSC {
                 if (i >= storage->m_length)
                     storage->m_length = i + 1;
             }
+            widenElementKind(v);
             x.set(globalData, this, v);
         }
         
@@ -117,6 +126,7 @@ namespace JSC {
 #if CHECK_ARRAY_CONSISTENCY
             ASSERT(storage->m_inCompactInitialization);
 #endif
+            widenElementKind(v);
             storage->m_vector[i].set(globalData, this, v);
         }
 
@@ -161,6 +171,8 @@ namespace JSC {
         
         unsigned compactForSorting();
 
+        void widenElementKind(JSValue);
+
         enum ConsistencyCheckType { NormalConsistencyCheck, DestructorConsistencyCheck, SortConsistencyCheck };
         void checkConsistency(ConsistencyCheckType = NormalConsistencyCheck);
 
@@ -182,6 +194,19 @@ namespace JSC {
         return asArray(value.asCell());
     }
 
+    inline void JSArray::widenElementKind(JSValue value)
+    {
+        ArrayStorage* storage = m_storage;
+        if (value.isInt32())
+            return;
+        if (value.isDouble()) {
+            if (storage->m_elementKind == Int32Elements)
+                storage->m_elementKind = DoubleElements;
+            return;
+        }
+        storage->m_elementKind = ContiguousElements;
+    }
+
     inline bool isJSArray(JSGlobalData* globalData, JSCell* cell) { return cell->vptr() == globalData->jsArrayVPtr; }
     inline bool isJSArray(JSGlobalData* globalData, JSValue v) { return v.isCell() && isJSArray(globalData, v.asCell()); }
 
@@ -191,8 +216,10 @@ namespace JSC {
         
         ArrayStorage* storage = m_storage;
 
-        unsigned usedVectorLength = std::min(storage->m_length, m_vectorLength);
-        markStack.appendValues(storage->m_vector, usedVectorLength, MayContainNullValues);
+        if (storage->m_elementKind == ContiguousElements) {
+            unsigned usedVectorLength = std::min(storage->m_length, m_vectorLength);
+            markStack.appendValues(storage->m_vector, usedVectorLength, MayContainNullValues);
+        }
 
         if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
             SparseArrayValueMap::iterator end = map->end();
@@ -351,21 +351,6 @@ namespace JSC {
     }
 #endif
 
-    inline void* MarkedBlock::allocate()
-    {
-        while (m_nextAtom < m_endAtom) {
-            if (!m_marks.testAndSet(m_nextAtom)) {
-                JSCell* cell = reinterpret_cast<JSCell*>(&atoms()[m_nextAtom]);
-                m_nextAtom += m_atomsPerCell;
-                cell->~JSCell();
-                return cell;
-            }
-            m_nextAtom += m_atomsPerCell;
-        }
-
-        return 0;
-    }
-    
     inline MarkedSpace::SizeClass& MarkedSpace::sizeClassFor(size_t bytes)
     {
         ASSERT(bytes && bytes < maxCellSize);
@@ -377,7 +362,12 @@ namespace JSC {
     inline void* MarkedSpace::allocate(size_t bytes)
     {
         SizeClass& sizeClass = sizeClassFor(bytes);
-        return allocateFromSizeClass(sizeClass);
+        MarkedBlock::FreeCell* firstFreeCell = sizeClass.firstFreeCell;
+        if (!firstFreeCell)
+            return allocateFromSizeClass(sizeClass);
+
+        sizeClass.firstFreeCell = firstFreeCell->next;
+        return firstFreeCell;
     }
     
     inline void* Heap::allocate(size_t bytes)
@@ -65,6 +65,8 @@ namespace JSC {
             m_scopeChain.set(globalData, this, scopeChain);
         }
 
+        static ptrdiff_t offsetOfScopeChain() { return OBJECT_OFFSETOF(JSFunction, m_scopeChain); }
+
         ExecutableBase* executable() const { return m_executable.get(); }
 
         // To call either of these methods include Executable.h
@@ -51,6 +51,7 @@
 #include "Nodes.h"
 #include "Parser.h"
 #include "RegExpCache.h"
+#include "SamplingTool.h"
 #include "StrictEvalActivation.h"
 #include <wtf/WTFThreadData.h>
 #if ENABLE(REGEXP_TRACING)
@@ -88,6 +89,25 @@ inline void Recompiler::operator()(JSCell* cell)
     function->jsExecutable()->discardCode();
 }
 
+#if ENABLE(JIT)
+class FunctionExecutableCollector {
+public:
+    void operator()(JSCell*);
+
+    HashSet<FunctionExecutable*> executables;
+};
+
+inline void FunctionExecutableCollector::operator()(JSCell* cell)
+{
+    if (!cell->inherits(&JSFunction::s_info))
+        return;
+    JSFunction* function = asFunction(cell);
+    if (function->executable()->isHostFunction())
+        return;
+    executables.add(function->jsExecutable());
+}
+#endif
+
 } // namespace
 
 namespace JSC {
@@ -106,6 +126,7 @@ void* JSGlobalData::jsArrayVPtr;
 void* JSGlobalData::jsByteArrayVPtr;
 void* JSGlobalData::jsStringVPtr;
 void* JSGlobalData::jsFunctionVPtr;
+void* JSGlobalData::jsFinalObjectVPtr;
 
 #if COMPILER(GCC)
 // Work around for gcc trying to coalesce our reads of the various cell vptrs
@@ -118,7 +139,7 @@ void* JSGlobalData::jsFunctionVPtr;
 
 void JSGlobalData::storeVPtrs()
 {
-    // Enough storage to fit a JSArray, JSByteArray, JSString, or JSFunction.
+    // Enough storage to fit a JSArray, JSByteArray, JSString, JSFunction, or JSFinalObject.
     // COMPILE_ASSERTS below check that this is true.
     char storage[64];
 
@@ -141,6 +162,11 @@ void JSGlobalData::storeVPtrs()
     JSCell* jsFunction = new (storage) JSFunction(JSCell::VPtrStealingHack);
     CLOBBER_MEMORY();
     JSGlobalData::jsFunctionVPtr = jsFunction->vptr();
+
+    COMPILE_ASSERT(sizeof(JSFinalObject) <= sizeof(storage), sizeof_JSFinalObject_must_be_less_than_storage);
+    JSCell* jsFinalObject = new (storage) JSFinalObject(JSCell::VPtrStealingHack);
+    CLOBBER_MEMORY();
+    JSGlobalData::jsFinalObjectVPtr = jsFinalObject->vptr();
 }
 
 JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType threadStackType)
@@ -396,6 +422,31 @@ void JSGlobalData::dumpSampleData(ExecState* exec)
     interpreter->dumpSampleData(exec);
 }
 
+void JSGlobalData::startSamplingProfiler(unsigned intervalInMicroseconds)
+{
+    if (!m_samplingProfiler)
+        m_samplingProfiler = adoptPtr(new SamplingProfiler(*this));
+    if (m_samplingProfiler->isRunning())
+        return;
+
+    m_samplingProfiler->start(intervalInMicroseconds);
+
+    // Existing JIT code has no safepoints at which to take samples.
+    if (!dynamicGlobalObject)
+        recompileAllJSFunctions();
+}
+
+UString JSGlobalData::stopSamplingProfiler()
+{
+    if (!m_samplingProfiler || !m_samplingProfiler->isRunning())
+        return UString();
+
+    m_samplingProfiler->stop();
+    UString stacks = m_samplingProfiler->collapsedStacks();
+    m_samplingProfiler->clear();
+    return stacks;
+}
+
 void JSGlobalData::recompileAllJSFunctions()
 {
     // If JavaScript is running, it's not safe to recompile, since we'll end
@@ -406,6 +457,25 @@ void JSGlobalData::recompileAllJSFunctions()
     heap.forEach(recompiler);
 }
 
+void JSGlobalData::releaseExecutableMemory()
+{
+    // As above, code that is live on the stack must not be thrown away.
+    ASSERT(!dynamicGlobalObject);
+
+#if ENABLE(JIT)
+    FunctionExecutableCollector collector;
+    heap.forEach(collector);
+
+    // Throw away code that has not run since the last time we were here, then
+    // make sure none of the code we kept still calls directly into it.
+    HashSet<FunctionExecutable*>::iterator end = collector.executables.end();
+    for (HashSet<FunctionExecutable*>::iterator it = collector.executables.begin(); it != end; ++it)
+        (*it)->discardCodeIfCold();
+    for (HashSet<FunctionExecutable*>::iterator it = collector.executables.begin(); it != end; ++it)
+        (*it)->unlinkCallsToDiscardedCode();
+#endif
+}
+
 #if ENABLE(REGEXP_TRACING)
 void JSGlobalData::addRegExpToTrace(PassRefPtr<RegExp> regExp)
 {
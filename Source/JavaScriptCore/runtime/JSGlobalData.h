@@ -67,6 +67,7 @@ namespace JSC {
     class NativeExecutable;
     class Parser;
     class RegExpCache;
+    class SamplingProfiler;
     class Stringifier;
     class Structure;
     class UString;
@@ -175,6 +176,7 @@ namespace JSC {
         static JS_EXPORTDATA void* jsByteArrayVPtr;
         static JS_EXPORTDATA void* jsStringVPtr;
         static JS_EXPORTDATA void* jsFunctionVPtr;
+        static JS_EXPORTDATA void* jsFinalObjectVPtr;
 
         IdentifierTable* identifierTable;
         CommonIdentifiers* propertyNames;
@@ -259,7 +261,16 @@ namespace JSC {
         void startSampling();
         void stopSampling();
         void dumpSampleData(ExecState* exec);
+
+        // The sampling profiler is kept once created, since code compiled while it
+        // was running refers to it. Stopping it returns the stacks sampled since it
+        // was started, in the collapsed format read by flame graph tools.
+        void startSamplingProfiler(unsigned intervalInMicroseconds = 1000);
+        UString stopSamplingProfiler();
+        SamplingProfiler* samplingProfiler() { return m_samplingProfiler.get(); }
+
         void recompileAllJSFunctions();
+        void releaseExecutableMemory();
         RegExpCache* regExpCache() { return m_regExpCache; }
 #if ENABLE(REGEXP_TRACING)
         void addRegExpToTrace(PassRefPtr<RegExp> regExp);
@@ -277,6 +288,7 @@ namespace JSC {
         bool m_canUseJIT;
 #endif
         StackBounds m_stack;
+        OwnPtr<SamplingProfiler> m_samplingProfiler;
     };
 
     inline HandleSlot allocateGlobalHandle(JSGlobalData& globalData)
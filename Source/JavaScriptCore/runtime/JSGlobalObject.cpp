@@ -439,8 +439,13 @@ DynamicGlobalObjectScope::DynamicGlobalObjectScope(JSGlobalData& globalData, JSG
 {
     if (!m_dynamicGlobalObjectSlot) {
 #if ENABLE(ASSEMBLER)
-        if (ExecutableAllocator::underMemoryPressure())
-            globalData.recompileAllJSFunctions();
+        if (ExecutableAllocator::underMemoryPressure()) {
+            // Start by dropping code that has gone cold, and only throw away
+            // everything if that did not free up enough memory.
+            globalData.releaseExecutableMemory();
+            if (ExecutableAllocator::underMemoryPressure())
+                globalData.recompileAllJSFunctions();
+        }
 #endif
 
         m_dynamicGlobalObjectSlot = dynamicGlobalObject;
@@ -170,32 +170,36 @@ bool JSLock::currentThreadIsHoldingLock()
 // order in which they were made - though implementing the less restrictive policy
 // would likely increase complexity and overhead.
 //
+// Only the shared context is locked for real, so only it is subject to this policy. Every
+// other context group has its own register file, and its threads never touch lockDropDepth.
 static unsigned lockDropDepth = 0;
 
 JSLock::DropAllLocks::DropAllLocks(ExecState* exec)
-    : m_lockBehavior(exec->globalData().isSharedInstance() ? LockForReal : SilenceAssertionsOnly)
+    : m_lockCount(0)
+    , m_lockBehavior(exec->globalData().isSharedInstance() ? LockForReal : SilenceAssertionsOnly)
 {
-    pthread_once(&createJSLockCountOnce, createJSLockCount);
-
-    if (lockDropDepth++) {
-        m_lockCount = 0;
-        return;
-    }
-
-    m_lockCount = JSLock::lockCount();
-    for (intptr_t i = 0; i < m_lockCount; i++)
-        JSLock::unlock(m_lockBehavior);
+    dropAllLocks();
 }
 
 JSLock::DropAllLocks::DropAllLocks(JSLockBehavior JSLockBehavior)
-    : m_lockBehavior(JSLockBehavior)
+    : m_lockCount(0)
+    , m_lockBehavior(JSLockBehavior)
 {
+    dropAllLocks();
+}
+
+void JSLock::DropAllLocks::dropAllLocks()
+{
+#ifdef NDEBUG
+    // Locking "not for real" is a debug-only feature.
+    if (m_lockBehavior == SilenceAssertionsOnly)
+        return;
+#endif
+
     pthread_once(&createJSLockCountOnce, createJSLockCount);
 
-    if (lockDropDepth++) {
-        m_lockCount = 0;
+    if (m_lockBehavior == LockForReal && lockDropDepth++)
         return;
-    }
 
     // It is necessary to drop even "unreal" locks, because having a non-zero lock count
     // will prevent a real lock from being taken.
@@ -210,7 +214,8 @@ JSLock::DropAllLocks::~DropAllLocks()
     for (intptr_t i = 0; i < m_lockCount; i++)
         JSLock::lock(m_lockBehavior);
 
-    --lockDropDepth;
+    if (m_lockBehavior == LockForReal)
+        --lockDropDepth;
 }
 
 #else // ENABLE(JSC_MULTIPLE_THREADS) && (OS(DARWIN) || USE(PTHREADS))
@@ -98,6 +98,8 @@ namespace JSC {
             ~DropAllLocks();
             
         private:
+            void dropAllLocks();
+
             intptr_t m_lockCount;
             JSLockBehavior m_lockBehavior;
         };
@@ -82,6 +82,13 @@ public:
     void markAggregate(MarkStack&);
 
 private:
+    // The enumerable properties of a plain object Structure, in enumeration order, with
+    // the offsets at which their values are stored.
+    struct StructureProperties : RefCounted<StructureProperties> {
+        RefPtr<PropertyNameArrayData> names;
+        Vector<size_t> offsets;
+    };
+
     class Holder {
     public:
         Holder(JSGlobalData&, JSObject*);
@@ -97,10 +104,18 @@ private:
         unsigned m_index;
         unsigned m_size;
         RefPtr<PropertyNameArrayData> m_propertyNames;
+
+        // Set if the object's values can be read straight from its property storage,
+        // for as long as it keeps this Structure.
+        Local<Structure> m_structure;
+        RefPtr<StructureProperties> m_structureProperties;
     };
 
     friend class Holder;
 
+    bool canReadPropertyStorageDirectly(JSObject*) const;
+    PassRefPtr<StructureProperties> structureProperties(Structure*);
+
     static void appendQuotedString(UStringBuilder&, const UString&);
 
     JSValue toJSON(JSValue, const PropertyNameForFunctionCall&);
@@ -124,6 +139,11 @@ private:
     Vector<Holder, 16> m_holderStack;
     UString m_repeatedGap;
     UString m_indent;
+
+    // Arrays of like-shaped objects are common, so remember the properties of the last
+    // Structure walked.
+    Local<Structure> m_cachedStructure;
+    RefPtr<StructureProperties> m_cachedStructureProperties;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -204,6 +224,7 @@ Stringifier::Stringifier(ExecState* exec, const Local<Unknown>& replacer, const
     , m_arrayReplacerPropertyNames(exec)
     , m_replacerCallType(CallTypeNone)
     , m_gap(gap(exec, space.get()))
+    , m_cachedStructure(exec->globalData())
 {
     if (!m_replacer.isObject())
         return;
@@ -437,6 +458,34 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
     return StringifySucceeded;
 }
 
+// Plain objects with neither accessors nor a dictionary Structure hold all their own
+// enumerable properties as values in their property storage, at offsets fixed by the
+// Structure. A replacer may see or change properties in ways this does not account for.
+inline bool Stringifier::canReadPropertyStorageDirectly(JSObject* object) const
+{
+    if (m_usingArrayReplacer || m_replacerCallType != CallTypeNone)
+        return false;
+    if (object->classInfo() != &JSObject::s_info)
+        return false;
+    Structure* structure = object->structure();
+    return !structure->isDictionary() && !structure->hasGetterSetterProperties();
+}
+
+PassRefPtr<Stringifier::StructureProperties> Stringifier::structureProperties(Structure* structure)
+{
+    if (m_cachedStructure.get() == structure)
+        return m_cachedStructureProperties;
+
+    RefPtr<StructureProperties> properties = adoptRef(new StructureProperties);
+    PropertyNameArray propertyNames(m_exec);
+    structure->getPropertyNamesAndOffsets(m_exec->globalData(), propertyNames, properties->offsets);
+    properties->names = propertyNames.releaseData();
+
+    m_cachedStructure = structure;
+    m_cachedStructureProperties = properties;
+    return properties.release();
+}
+
 inline bool Stringifier::willIndent() const
 {
     return !m_gap.isEmpty();
@@ -470,6 +519,7 @@ inline Stringifier::Holder::Holder(JSGlobalData& globalData, JSObject* object)
     : m_object(globalData, object)
     , m_isArray(object->inherits(&JSArray::s_info))
     , m_index(0)
+    , m_structure(globalData)
 {
 }
 
@@ -488,7 +538,11 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
-            else {
+            else if (stringifier.canReadPropertyStorageDirectly(m_object.get())) {
+                m_structure = m_object->structure();
+                m_structureProperties = stringifier.structureProperties(m_object->structure());
+                m_propertyNames = m_structureProperties->names;
+            } else {
                 PropertyNameArray objectPropertyNames(exec);
                 m_object->getOwnPropertyNames(exec, objectPropertyNames);
                 m_propertyNames = objectPropertyNames.releaseData();
@@ -534,14 +588,20 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         // Append the stringified value.
         stringifyResult = stringifier.appendStringifiedValue(builder, value, m_object.get(), index);
     } else {
-        // Get the value.
-        PropertySlot slot(m_object.get());
+        // Get the value. A toJSON function may have changed the object's Structure since we
+        // started, in which case look the property up the slow way.
         Identifier& propertyName = m_propertyNames->propertyNameVector()[index];
-        if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
-            return true;
-        JSValue value = slot.getValue(exec, propertyName);
-        if (exec->hadException())
-            return false;
+        JSValue value;
+        if (m_structure && m_object->structure() == m_structure.get())
+            value = m_object->getDirectOffset(m_structureProperties->offsets[index]);
+        else {
+            PropertySlot slot(m_object.get());
+            if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
+                return true;
+            value = slot.getValue(exec, propertyName);
+            if (exec->hadException())
+                return false;
+        }
 
         rollBackPoint = builder.length();
 
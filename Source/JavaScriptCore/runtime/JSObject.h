@@ -245,6 +245,7 @@ namespace JSC {
         }
 
         static size_t offsetOfInlineStorage();
+        static ptrdiff_t offsetOfPropertyStorage() { return OBJECT_OFFSETOF(JSObject, m_propertyStorage); }
         
         static JS_EXPORTDATA const ClassInfo s_info;
 
@@ -357,6 +358,11 @@ COMPILE_ASSERT((JSFinalObject_inlineStorageCapacity >= JSNonFinalObject_inlineSt
             return new (exec) JSFinalObject(exec->globalData(), structure);
         }
 
+        explicit JSFinalObject(VPtrStealingHackType)
+            : JSObject(VPtrStealingHack, m_inlineStorage)
+        {
+        }
+
         static Structure* createStructure(JSGlobalData& globalData, JSValue prototype)
         {
             return Structure::create(globalData, prototype, TypeInfo(ObjectType, StructureFlags), AnonymousSlotCount, &s_info);
@@ -33,6 +33,7 @@
 namespace JSC {
     
 static const unsigned substringFromRopeCutoff = 4;
+static const unsigned ropeSearchInitialLength = 1024;
 
 // Overview: this methods converts a JSString from holding a string in rope form
 // down to a simple UString representation.  It does so by building up the string
@@ -85,7 +86,12 @@ void JSString::resolveRope(ExecState* exec) const
             StringImpl* string = static_cast<StringImpl*>(currentFiber);
             unsigned length = string->length();
             position -= length;
-            StringImpl::copyChars(position, string->characters(), length);
+            // Latin-1 fibers are widened straight into the buffer rather than through characters(),
+            // which would leave a cached UTF-16 copy behind on the fiber.
+            if (string->is8Bit())
+                StringImpl::copyChars(position, string->characters8(), length);
+            else
+                StringImpl::copyChars(position, string->characters16(), length);
 
             // Was this the last item in the work queue?
             if (workQueue.isEmpty()) {
@@ -142,7 +148,15 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
         if (fiberEnd >= substringEnd)
             break;
         if (fiberCount > substringFromRopeCutoff || substringFiberCount >= 3) {
-            // This turned out to be a really inefficient rope. Just flatten it.
+            // This turned out to be a really inefficient rope. Copy the substring out of it,
+            // or flatten it if it has already been read in place often enough.
+            if (!shouldResolveRope()) {
+                UChar* buffer;
+                if (PassRefPtr<StringImpl> substring = StringImpl::tryCreateUninitialized(substringLength, buffer)) {
+                    chargeRopeTraversal(copyCharactersFromRope(buffer, substringStart, substringLength) + substringLength);
+                    return new (globalData) JSString(globalData, UString(substring));
+                }
+            }
             resolveRope(exec);
             return jsSubstring(&exec->globalData(), m_value, substringStart, substringLength);
         }
@@ -151,7 +165,7 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
 
     if (substringLength == 1) {
         ASSERT(substringFiberCount == 1);
-        UChar c = substringFibers[0].characters()[0];
+        UChar c = substringFibers[0][0];
         if (c <= maxSingleCharacterString)
             return globalData->smallStrings.singleCharacterString(globalData, c);
     }
@@ -162,6 +176,88 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
     return new (globalData) JSString(globalData, substringFibers[0], substringFibers[1], substringFibers[2]);
 }
 
+// Copies the characters [offset, offset + length) of a rope into buffer, descending only into
+// the fibers that overlap that range. Returns the number of fibers visited.
+unsigned JSString::copyCharactersFromRope(UChar* buffer, unsigned offset, unsigned length) const
+{
+    ASSERT(isRope());
+    ASSERT(length);
+    ASSERT(offset + length <= m_length);
+
+    unsigned end = offset + length;
+    unsigned fibersVisited = 0;
+
+    // Each entry is a fiber and the position of its first character in this string.
+    Vector<std::pair<RopeImpl::Fiber, unsigned>, 32> workQueue;
+    unsigned fiberStart = m_length;
+    for (unsigned i = m_fiberCount; i--; ) {
+        RopeImpl::Fiber fiber = m_other.m_fibers[i];
+        fiberStart -= fiber->length();
+        if (fiberStart < end && fiberStart + fiber->length() > offset)
+            workQueue.append(std::make_pair(fiber, fiberStart));
+    }
+
+    while (!workQueue.isEmpty()) {
+        RopeImpl::Fiber fiber = workQueue.last().first;
+        unsigned fiberStart = workQueue.last().second;
+        workQueue.removeLast();
+        ++fibersVisited;
+
+        if (RopeImpl::isRope(fiber)) {
+            RopeImpl* rope = static_cast<RopeImpl*>(fiber);
+            unsigned childStart = fiberStart + rope->length();
+            for (unsigned i = rope->fiberCount(); i--; ) {
+                RopeImpl::Fiber child = rope->fibers()[i];
+                childStart -= child->length();
+                if (childStart < end && childStart + child->length() > offset)
+                    workQueue.append(std::make_pair(child, childStart));
+            }
+            continue;
+        }
+
+        StringImpl* string = static_cast<StringImpl*>(fiber);
+        unsigned copyStart = std::max(offset, fiberStart);
+        unsigned copyEnd = std::min(end, fiberStart + string->length());
+        if (string->is8Bit())
+            StringImpl::copyChars(buffer + copyStart - offset, string->characters8() + copyStart - fiberStart, copyEnd - copyStart);
+        else
+            StringImpl::copyChars(buffer + copyStart - offset, string->characters16() + copyStart - fiberStart, copyEnd - copyStart);
+    }
+
+    return fibersVisited;
+}
+
+UChar JSString::characterAt(ExecState* exec, unsigned index)
+{
+    ASSERT(index < m_length);
+    if (isRope() && !shouldResolveRope()) {
+        UChar character;
+        chargeRopeTraversal(copyCharactersFromRope(&character, index, 1));
+        return character;
+    }
+    return value(exec)[index];
+}
+
+// Matches in a large rope are usually looked for near its start, so search prefixes of it that
+// double in length each time, and only resolve the whole rope once they reach half of it.
+size_t JSString::find(ExecState* exec, const UString& pattern, unsigned start)
+{
+    ASSERT(start <= m_length);
+    unsigned searchLength = std::max(ropeSearchInitialLength, 2 * pattern.length());
+    while (isRope() && !shouldResolveRope() && searchLength < (m_length - start) / 2) {
+        UChar* buffer;
+        PassRefPtr<StringImpl> prefix = StringImpl::tryCreateUninitialized(searchLength, buffer);
+        if (!prefix)
+            break;
+        chargeRopeTraversal(copyCharactersFromRope(buffer, start, searchLength) + searchLength);
+        size_t result = UString(prefix).find(pattern);
+        if (result != notFound)
+            return start + result;
+        searchLength *= 2;
+    }
+    return value(exec).find(pattern, start);
+}
+
 JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UString& replacement)
 {
     if (!isRope()) {
@@ -217,6 +313,8 @@ JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UStri
 JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
+    if (!shouldResolveRope())
+        return jsSingleCharacterString(exec, characterAt(exec, i));
     resolveRope(exec);
     // Return a safe no-value result, this should never be used, since the excetion will be thrown.
     if (exec->exception())
@@ -189,6 +189,7 @@ namespace JSC {
             , m_length(value.length())
             , m_value(value)
             , m_fiberCount(0)
+            , m_ropeTraversalCost(0)
         {
             ASSERT(!m_value.isNull());
             Heap::heap(this)->reportExtraMemoryCost(value.impl()->cost());
@@ -200,6 +201,7 @@ namespace JSC {
             , m_length(value.length())
             , m_value(value)
             , m_fiberCount(0)
+            , m_ropeTraversalCost(0)
         {
             ASSERT(!m_value.isNull());
         }
@@ -208,6 +210,7 @@ namespace JSC {
             , m_length(value->length())
             , m_value(value)
             , m_fiberCount(0)
+            , m_ropeTraversalCost(0)
         {
             ASSERT(!m_value.isNull());
         }
@@ -215,6 +218,7 @@ namespace JSC {
             : JSCell(*globalData, globalData->stringStructure.get())
             , m_length(rope->length())
             , m_fiberCount(1)
+            , m_ropeTraversalCost(0)
         {
             m_other.m_fibers[0] = rope.leakRef();
         }
@@ -224,6 +228,7 @@ namespace JSC {
             : JSCell(*globalData, globalData->stringStructure.get())
             , m_length(s1->length() + s2->length())
             , m_fiberCount(fiberCount)
+            , m_ropeTraversalCost(0)
         {
             ASSERT(fiberCount <= s_maxInternalRopeLength);
             unsigned index = 0;
@@ -237,6 +242,7 @@ namespace JSC {
             : JSCell(*globalData, globalData->stringStructure.get())
             , m_length(s1->length() + u2.length())
             , m_fiberCount(fiberCount)
+            , m_ropeTraversalCost(0)
         {
             ASSERT(fiberCount <= s_maxInternalRopeLength);
             unsigned index = 0;
@@ -250,6 +256,7 @@ namespace JSC {
             : JSCell(*globalData, globalData->stringStructure.get())
             , m_length(u1.length() + s2->length())
             , m_fiberCount(fiberCount)
+            , m_ropeTraversalCost(0)
         {
             ASSERT(fiberCount <= s_maxInternalRopeLength);
             unsigned index = 0;
@@ -265,6 +272,7 @@ namespace JSC {
             : JSCell(exec->globalData(), exec->globalData().stringStructure.get())
             , m_length(0)
             , m_fiberCount(s_maxInternalRopeLength)
+            , m_ropeTraversalCost(0)
         {
             unsigned index = 0;
             appendValueInConstructAndIncrementLength(exec, index, v1);
@@ -278,6 +286,7 @@ namespace JSC {
             : JSCell(*globalData, globalData->stringStructure.get())
             , m_length(u1.length() + u2.length())
             , m_fiberCount(2)
+            , m_ropeTraversalCost(0)
         {
             unsigned index = 0;
             appendStringInConstruct(index, u1);
@@ -290,6 +299,7 @@ namespace JSC {
             : JSCell(*globalData, globalData->stringStructure.get())
             , m_length(u1.length() + u2.length() + u3.length())
             , m_fiberCount(s_maxInternalRopeLength)
+            , m_ropeTraversalCost(0)
         {
             unsigned index = 0;
             appendStringInConstruct(index, u1);
@@ -303,6 +313,7 @@ namespace JSC {
             , m_length(value.length())
             , m_value(value)
             , m_fiberCount(0)
+            , m_ropeTraversalCost(0)
         {
             ASSERT(!m_value.isNull());
             // nasty hack because we can't union non-POD types
@@ -347,6 +358,11 @@ namespace JSC {
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
 
+        // These read ropes in place rather than resolving them; see shouldResolveRope().
+        UChar characterAt(ExecState*, unsigned index);
+        size_t find(ExecState*, const UString& pattern, unsigned start);
+        bool equal(ExecState*, JSString*);
+
         JSValue replaceCharacter(ExecState*, UChar, const UString& replacement);
 
         static Structure* createStructure(JSGlobalData& globalData, JSValue proto) { return Structure::create(globalData, proto, TypeInfo(StringType, OverridesGetOwnPropertySlot | NeedsThisConversion), AnonymousSlotCount, 0); }
@@ -355,11 +371,19 @@ namespace JSC {
         JSString(VPtrStealingHackType) 
             : JSCell(VPtrStealingHack)
             , m_fiberCount(0)
+            , m_ropeTraversalCost(0)
         {
         }
 
         void resolveRope(ExecState*) const;
         JSString* substringFromRope(ExecState*, unsigned offset, unsigned length);
+        unsigned copyCharactersFromRope(UChar* buffer, unsigned offset, unsigned length) const;
+
+        // Reading a rope in place is cheaper than resolving it for a few accesses, but not for
+        // many. Each in-place read is charged to the string, and once the charges add up to the
+        // cost of resolving it the string is resolved instead.
+        bool shouldResolveRope() const { return m_ropeTraversalCost >= m_length; }
+        void chargeRopeTraversal(unsigned cost) { m_ropeTraversalCost += std::min(cost, m_length); }
 
         void appendStringInConstruct(unsigned& index, const UString& string)
         {
@@ -417,6 +441,7 @@ namespace JSC {
         unsigned m_length;
         mutable UString m_value;
         mutable unsigned m_fiberCount;
+        unsigned m_ropeTraversalCost;
         // This structure exists to support a temporary workaround for a GC issue.
         struct JSStringFinalizerStruct {
             JSStringFinalizerStruct() : m_finalizerCallback(0) {}
@@ -476,7 +501,7 @@ namespace JSC {
     {
         JSGlobalData* globalData = &exec->globalData();
         ASSERT(offset < static_cast<unsigned>(s.length()));
-        UChar c = s.characters()[offset];
+        UChar c = s[offset];
         if (c <= maxSingleCharacterString)
             return globalData->smallStrings.singleCharacterString(globalData, c);
         return fixupVPtr(globalData, new (globalData) JSString(globalData, UString(StringImpl::create(s.impl(), offset, 1))));
@@ -505,13 +530,20 @@ namespace JSC {
         return jsSingleCharacterSubstring(exec, m_value, i);
     }
 
+    inline bool JSString::equal(ExecState* exec, JSString* other)
+    {
+        if (m_length != other->m_length)
+            return false;
+        return value(exec) == other->value(exec);
+    }
+
     inline JSString* jsString(JSGlobalData* globalData, const UString& s)
     {
         int size = s.length();
         if (!size)
             return globalData->smallStrings.emptyString(globalData);
         if (size == 1) {
-            UChar c = s.characters()[0];
+            UChar c = s[0];
             if (c <= maxSingleCharacterString)
                 return globalData->smallStrings.singleCharacterString(globalData, c);
         }
@@ -520,7 +552,7 @@ namespace JSC {
 
     inline JSString* jsStringWithFinalizer(ExecState* exec, const UString& s, JSStringFinalizerCallback callback, void* context)
     {
-        ASSERT(s.length() && (s.length() > 1 || s.characters()[0] > maxSingleCharacterString));
+        ASSERT(s.length() && (s.length() > 1 || s[0] > maxSingleCharacterString));
         JSGlobalData* globalData = &exec->globalData();
         return fixupVPtr(globalData, new (globalData) JSString(globalData, s, callback, context));
     }
@@ -546,7 +578,7 @@ namespace JSC {
         if (!length)
             return globalData->smallStrings.emptyString(globalData);
         if (length == 1) {
-            UChar c = s.characters()[offset];
+            UChar c = s[offset];
             if (c <= maxSingleCharacterString)
                 return globalData->smallStrings.singleCharacterString(globalData, c);
         }
@@ -559,7 +591,7 @@ namespace JSC {
         if (!size)
             return globalData->smallStrings.emptyString(globalData);
         if (size == 1) {
-            UChar c = s.characters()[0];
+            UChar c = s[0];
             if (c <= maxSingleCharacterString)
                 return globalData->smallStrings.singleCharacterString(globalData, c);
         }
@@ -287,6 +287,17 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     return TokNumber;
 }
 
+inline Identifier LiteralParser::makeIdentifier(const UString& name)
+{
+    if (name.isEmpty() || name[0] >= recentIdentifierCacheSize)
+        return Identifier(m_exec, name);
+
+    Identifier& recentIdentifier = m_recentIdentifiers[name[0]];
+    if (recentIdentifier.ustring() != name)
+        recentIdentifier = Identifier(m_exec, name);
+    return recentIdentifier;
+}
+
 JSValue LiteralParser::parse(ParserState initialState)
 {
     ParserState state = initialState;
@@ -345,7 +356,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                         return JSValue();
                     
                     m_lexer.next();
-                    identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                    identifierStack.append(makeIdentifier(identifierToken.stringToken));
                     stateStack.append(DoParseObjectEndExpression);
                     goto startParseExpression;
                 } else if (type != TokRBrace) 
@@ -367,7 +378,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     return JSValue();
 
                 m_lexer.next();
-                identifierStack.append(Identifier(m_exec, identifierToken.stringToken));
+                identifierStack.append(makeIdentifier(identifierToken.stringToken));
                 stateStack.append(DoParseObjectEndExpression);
                 goto startParseExpression;
             }
@@ -26,6 +26,7 @@
 #ifndef LiteralParser_h
 #define LiteralParser_h
 
+#include "Identifier.h"
 #include "JSGlobalObjectFunctions.h"
 #include "JSValue.h"
 #include "UString.h"
@@ -100,10 +101,17 @@ namespace JSC {
         
         class StackGuard;
         JSValue parse(ParserState);
+        Identifier makeIdentifier(const UString&);
 
         ExecState* m_exec;
         LiteralParser::Lexer m_lexer;
         ParserMode m_mode;
+
+        // Objects in a document usually share a handful of property names, so keep the
+        // last one seen for each leading ASCII character rather than looking each one up
+        // in the identifier table.
+        static const unsigned recentIdentifierCacheSize = 128;
+        Identifier m_recentIdentifiers[recentIdentifierCacheSize];
     };
 }
 
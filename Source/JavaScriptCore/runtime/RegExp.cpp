@@ -111,7 +111,7 @@ RegExp::RegExpState RegExp::compile(JSGlobalData* globalData)
     RegExpState res = ByteCode;
 
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && globalData->canUseJIT()) {
+    if (globalData->canUseJIT()) {
         Yarr::jitCompile(pattern, globalData, m_representation->m_regExpJITCode);
 #if ENABLE(YARR_JIT_DEBUG)
         if (!m_representation->m_regExpJITCode.isFallBack())
@@ -486,6 +486,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    // Strings are read through the JSString so that ropes do not have to be resolved.
+    if (thisValue.isString()) {
+        JSString* jsString = asString(thisValue);
+        unsigned len = jsString->length();
+        JSValue a0 = exec->argument(0);
+        double dpos = a0.isUInt32() ? a0.asUInt32() : a0.toInteger(exec);
+        if (dpos >= 0 && dpos < len)
+            return JSValue::encode(jsString->getIndex(exec, static_cast<unsigned>(dpos)));
+        return JSValue::encode(jsEmptyString(exec));
+    }
     UString s = thisValue.toThisString(exec);
     unsigned len = s.length();
     JSValue a0 = exec->argument(0);
@@ -506,6 +516,15 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    if (thisValue.isString()) {
+        JSString* jsString = asString(thisValue);
+        unsigned len = jsString->length();
+        JSValue a0 = exec->argument(0);
+        double dpos = a0.isUInt32() ? a0.asUInt32() : a0.toInteger(exec);
+        if (dpos >= 0 && dpos < len)
+            return JSValue::encode(jsNumber(jsString->characterAt(exec, static_cast<unsigned>(dpos))));
+        return JSValue::encode(jsNaN());
+    }
     UString s = thisValue.toThisString(exec);
     unsigned len = s.length();
     JSValue a0 = exec->argument(0);
@@ -540,8 +559,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    int len = s.length();
+    int len;
+    JSString* jsString = 0;
+    UString s;
+    if (thisValue.isString()) {
+        jsString = asString(thisValue);
+        len = jsString->length();
+    } else {
+        s = thisValue.toThisString(exec);
+        len = s.length();
+    }
 
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
@@ -560,7 +587,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncIndexOf(ExecState* exec)
         pos = static_cast<int>(dpos);
     }
 
-    size_t result = s.find(u2, pos);
+    size_t result = jsString ? jsString->find(exec, u2, pos) : s.find(u2, pos);
     if (result == notFound)
         return JSValue::encode(jsNumber(-1));
     return JSValue::encode(jsNumber(result));
@@ -677,8 +704,16 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
-    UString s = thisValue.toThisString(exec);
-    int len = s.length();
+    int len;
+    JSString* jsString = 0;
+    UString s;
+    if (thisValue.isString()) {
+        jsString = asString(thisValue);
+        len = jsString->length();
+    } else {
+        s = thisValue.toThisString(exec);
+        len = s.length();
+    }
 
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
@@ -693,7 +728,11 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec)
             from = 0;
         if (to > len)
             to = len;
-        return JSValue::encode(jsSubstring(exec, s, static_cast<unsigned>(from), static_cast<unsigned>(to) - static_cast<unsigned>(from)));
+        unsigned substringStart = static_cast<unsigned>(from);
+        unsigned substringLength = static_cast<unsigned>(to) - substringStart;
+        if (jsString)
+            return JSValue::encode(jsSubstring(exec, jsString, substringStart, substringLength));
+        return JSValue::encode(jsSubstring(exec, s, substringStart, substringLength));
     }
 
     return JSValue::encode(jsEmptyString(exec));
@@ -765,6 +765,23 @@ void Structure::getPropertyNames(JSGlobalData& globalData, PropertyNameArray& pr
     }
 }
 
+void Structure::getPropertyNamesAndOffsets(JSGlobalData& globalData, PropertyNameArray& propertyNames, Vector<size_t>& offsets)
+{
+    ASSERT(!propertyNames.size());
+
+    materializePropertyMapIfNecessary(globalData);
+    if (!m_propertyTable)
+        return;
+
+    PropertyTable::iterator end = m_propertyTable->end();
+    for (PropertyTable::iterator iter = m_propertyTable->begin(); iter != end; ++iter) {
+        if (iter->attributes & DontEnum)
+            continue;
+        propertyNames.addKnownUnique(iter->key);
+        offsets.append(iter->offset);
+    }
+}
+
 void Structure::markChildren(MarkStack& markStack)
 {
     JSCell::markChildren(markStack);
@@ -132,6 +132,8 @@ namespace JSC {
         void setEnumerationCache(JSGlobalData&, JSPropertyNameIterator* enumerationCache); // Defined in JSPropertyNameIterator.h.
         JSPropertyNameIterator* enumerationCache(); // Defined in JSPropertyNameIterator.h.
         void getPropertyNames(JSGlobalData&, PropertyNameArray&, EnumerationMode mode);
+        // Like getPropertyNames with ExcludeDontEnumProperties, also recording each property's offset.
+        void getPropertyNamesAndOffsets(JSGlobalData&, PropertyNameArray&, Vector<size_t>& offsets);
 
         const ClassInfo* classInfo() const { return m_classInfo; }
 
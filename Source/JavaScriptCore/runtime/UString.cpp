@@ -75,6 +75,12 @@ UString::UString(const UChar* characters)
     m_impl = StringImpl::create(characters, length);
 }
 
+// Construct a string with latin1 data.
+UString::UString(const LChar* characters, unsigned length)
+    : m_impl(characters ? StringImpl::create(characters, length) : 0)
+{
+}
+
 // Construct a string with latin1 data.
 UString::UString(const char* characters, unsigned length)
     : m_impl(characters ? StringImpl::create(characters, length) : 0)
@@ -89,9 +95,9 @@ UString::UString(const char* characters)
 
 UString UString::number(int i)
 {
-    UChar buf[1 + sizeof(i) * 3];
-    UChar* end = buf + WTF_ARRAY_LENGTH(buf);
-    UChar* p = end;
+    LChar buf[1 + sizeof(i) * 3];
+    LChar* end = buf + WTF_ARRAY_LENGTH(buf);
+    LChar* p = end;
 
     if (i == 0)
         *--p = '0';
@@ -106,7 +112,7 @@ UString UString::number(int i)
             i = -i;
         }
         while (i) {
-            *--p = static_cast<unsigned short>((i % 10) + '0');
+            *--p = static_cast<LChar>((i % 10) + '0');
             i /= 10;
         }
         if (negative)
@@ -118,9 +124,9 @@ UString UString::number(int i)
 
 UString UString::number(long long i)
 {
-    UChar buf[1 + sizeof(i) * 3];
-    UChar* end = buf + WTF_ARRAY_LENGTH(buf);
-    UChar* p = end;
+    LChar buf[1 + sizeof(i) * 3];
+    LChar* end = buf + WTF_ARRAY_LENGTH(buf);
+    LChar* p = end;
 
     if (i == 0)
         *--p = '0';
@@ -139,7 +145,7 @@ UString UString::number(long long i)
             i = -i;
         }
         while (i) {
-            *--p = static_cast<unsigned short>((i % 10) + '0');
+            *--p = static_cast<LChar>((i % 10) + '0');
             i /= 10;
         }
         if (negative)
@@ -151,15 +157,15 @@ UString UString::number(long long i)
 
 UString UString::number(unsigned u)
 {
-    UChar buf[sizeof(u) * 3];
-    UChar* end = buf + WTF_ARRAY_LENGTH(buf);
-    UChar* p = end;
+    LChar buf[sizeof(u) * 3];
+    LChar* end = buf + WTF_ARRAY_LENGTH(buf);
+    LChar* p = end;
 
     if (u == 0)
         *--p = '0';
     else {
         while (u) {
-            *--p = static_cast<unsigned short>((u % 10) + '0');
+            *--p = static_cast<LChar>((u % 10) + '0');
             u /= 10;
         }
     }
@@ -169,9 +175,9 @@ UString UString::number(unsigned u)
 
 UString UString::number(long l)
 {
-    UChar buf[1 + sizeof(l) * 3];
-    UChar* end = buf + WTF_ARRAY_LENGTH(buf);
-    UChar* p = end;
+    LChar buf[1 + sizeof(l) * 3];
+    LChar* end = buf + WTF_ARRAY_LENGTH(buf);
+    LChar* p = end;
 
     if (l == 0)
         *--p = '0';
@@ -186,7 +192,7 @@ UString UString::number(long l)
             l = -l;
         }
         while (l) {
-            *--p = static_cast<unsigned short>((l % 10) + '0');
+            *--p = static_cast<LChar>((l % 10) + '0');
             l /= 10;
         }
         if (negative)
@@ -221,6 +227,9 @@ bool operator==(const UString& s1, const char *s2)
     if (s2 == 0)
         return s1.isEmpty();
 
+    if (s1.is8Bit())
+        return WTF::equal(s1.impl(), s2);
+
     const UChar* u = s1.characters();
     const UChar* uend = u + s1.length();
     while (u != uend && *s2) {
@@ -296,6 +305,10 @@ CString UString::latin1() const
     // preserved, characters outside of this range are converted to '?'.
 
     unsigned length = this->length();
+
+    if (is8Bit())
+        return CString(reinterpret_cast<const char*>(characters8()), length);
+
     const UChar* characters = this->characters();
 
     char* characterBuffer;
@@ -39,6 +39,7 @@ public:
     UString(const UChar*);
 
     // Construct a string with latin1 data.
+    UString(const LChar* characters, unsigned length);
     UString(const char* characters, unsigned length);
 
     // Construct a string with latin1 data, from a null-terminated source.
@@ -76,6 +77,20 @@ public:
         return m_impl->characters();
     }
 
+    bool is8Bit() const { return m_impl && m_impl->is8Bit(); }
+    const LChar* characters8() const
+    {
+        if (!m_impl)
+            return 0;
+        return m_impl->characters8();
+    }
+    const UChar* characters16() const
+    {
+        if (!m_impl)
+            return 0;
+        return m_impl->characters16();
+    }
+
     CString ascii() const;
     CString latin1() const;
     CString utf8(bool strict = false) const;
@@ -84,7 +99,7 @@ public:
     {
         if (!m_impl || index >= m_impl->length())
             return 0;
-        return m_impl->characters()[index];
+        return (*m_impl)[index];
     }
 
     static UString number(int);
@@ -138,8 +153,16 @@ ALWAYS_INLINE bool operator==(const UString& s1, const UString& s2)
     // At this point we know 
     //   (a) that the strings are the same length and
     //   (b) that they are greater than zero length.
-    const UChar* d1 = rep1->characters();
-    const UChar* d2 = rep2->characters();
+    if (rep1->is8Bit()) {
+        if (rep2->is8Bit())
+            return WTF::equal(rep1->characters8(), rep2->characters8(), size1);
+        return WTF::equal(rep1->characters8(), rep2->characters16(), size1);
+    }
+    if (rep2->is8Bit())
+        return WTF::equal(rep1->characters16(), rep2->characters8(), size1);
+
+    const UChar* d1 = rep1->characters16();
+    const UChar* d2 = rep2->characters16();
     
     if (d1 == d2) // Check to see if the data pointers are the same.
         return true;
@@ -200,11 +223,19 @@ struct UStringHash {
         if (aLength != bLength)
             return false;
 
+        if (a->is8Bit()) {
+            if (b->is8Bit())
+                return WTF::equal(a->characters8(), b->characters8(), aLength);
+            return WTF::equal(a->characters8(), b->characters16(), aLength);
+        }
+        if (b->is8Bit())
+            return WTF::equal(a->characters16(), b->characters8(), aLength);
+
         // FIXME: perhaps we should have a more abstract macro that indicates when
         // going 4 bytes at a time is unsafe
 #if CPU(ARM) || CPU(SH4) || CPU(MIPS)
-        const UChar* aChars = a->characters();
-        const UChar* bChars = b->characters();
+        const UChar* aChars = a->characters16();
+        const UChar* bChars = b->characters16();
         for (unsigned i = 0; i != aLength; ++i) {
             if (*aChars++ != *bChars++)
                 return false;
@@ -212,8 +243,8 @@ struct UStringHash {
         return true;
 #else
         /* Do it 4-bytes-at-a-time on architectures where it's safe */
-        const uint32_t* aChars = reinterpret_cast<const uint32_t*>(a->characters());
-        const uint32_t* bChars = reinterpret_cast<const uint32_t*>(b->characters());
+        const uint32_t* aChars = reinterpret_cast<const uint32_t*>(a->characters16());
+        const uint32_t* bChars = reinterpret_cast<const uint32_t*>(b->characters16());
 
         unsigned halfLength = aLength >> 1;
         for (unsigned i = 0; i != halfLength; ++i)
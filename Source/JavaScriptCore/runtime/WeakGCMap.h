@@ -28,7 +28,9 @@
 
 #include "Handle.h"
 #include "JSGlobalData.h"
+#include <wtf/Deque.h>
 #include <wtf/HashMap.h>
+#include <wtf/Vector.h>
 
 namespace JSC {
 
@@ -148,7 +150,7 @@ public:
         HandleSlot slot = iter.first->second;
         if (iter.second) {
             slot = globalData.allocateGlobalHandle();
-            HandleHeap::heapFor(slot)->makeWeak(slot, this, key);
+            HandleHeap::heapFor(slot)->makeWeak(slot, this, FinalizerCallback::finalizerContextFor(key));
             iter.first->second = slot;
         }
         HandleHeap::heapFor(slot)->writeBarrier(slot, value);
@@ -186,6 +188,249 @@ private:
     MapType m_map;
 };
 
+// A WeakGCMap for values that can be recreated on demand, such as wrappers
+// kept only to avoid allocating the same wrapper twice. The cache can be
+// bounded, and it counts hits, misses, evictions and finalizations so that
+// clients can tell whether it is paying for itself.
+//
+// A bounded cache evicts with the clock (second chance) policy: keys sit in a
+// queue in insertion order, a hit marks the entry as referenced, and eviction
+// takes the oldest entry that has not been referenced since the clock last
+// passed it, moving referenced entries to the back and clearing their mark.
+// Keys removed by other means stay in the queue until the clock reaches them
+// or the queue is compacted; a stamp tells them apart from a later insertion
+// of the same key.
+//
+// Entries whose values die are not removed from within the collector: the
+// finalizer only queues their keys, and the whole batch is purged by the next
+// call that mutates the cache. Lookups that land on such an entry see an empty
+// slot and count as misses.
+template<typename KeyType, typename MappedType, typename FinalizerCallback = DefaultWeakGCMapFinalizerCallback<KeyType, MappedType>, typename HashArg = typename DefaultHash<KeyType>::Hash, typename KeyTraitsArg = HashTraits<KeyType> >
+class WeakGCCache : private WeakHandleOwner {
+    WTF_MAKE_FAST_ALLOCATED;
+    WTF_MAKE_NONCOPYABLE(WeakGCCache);
+
+    struct Entry {
+        Entry()
+            : slot(0)
+            , stamp(0)
+            , referenced(false)
+        {
+        }
+
+        HandleSlot slot;
+        unsigned stamp;
+        bool referenced;
+    };
+
+    typedef HashMap<KeyType, Entry, HashArg, KeyTraitsArg> MapType;
+    typedef typename HandleTypes<MappedType>::ExternalType ExternalType;
+    typedef typename MapType::iterator map_iterator;
+    typedef std::pair<KeyType, unsigned> ClockEntry;
+    typedef Deque<ClockEntry> ClockType;
+
+public:
+    static const size_t unlimitedCapacity = 0;
+
+    WeakGCCache(size_t capacity = unlimitedCapacity)
+        : m_capacity(capacity)
+        , m_nextStamp(0)
+        , m_hits(0)
+        , m_misses(0)
+        , m_evictions(0)
+        , m_finalizations(0)
+    {
+    }
+
+    ~WeakGCCache()
+    {
+        clear();
+    }
+
+    bool isEmpty() { return m_map.isEmpty(); }
+
+    // Includes entries whose values have died but have not been purged yet.
+    size_t size() { return m_map.size(); }
+
+    size_t capacity() const { return m_capacity; }
+    void setCapacity(size_t capacity)
+    {
+        bool wasUnlimited = m_capacity == unlimitedCapacity;
+        m_capacity = capacity;
+        purgeDeadEntries();
+        if (m_capacity == unlimitedCapacity) {
+            m_clock.clear();
+            return;
+        }
+
+        // An unbounded cache does not keep the clock, so entries added before
+        // the cache was bounded join it in hash table order.
+        if (wasUnlimited) {
+            map_iterator end = m_map.end();
+            for (map_iterator ptr = m_map.begin(); ptr != end; ++ptr)
+                m_clock.append(std::make_pair(ptr->first, ptr->second.stamp));
+        }
+        while (static_cast<size_t>(m_map.size()) > m_capacity)
+            evict();
+    }
+
+    ExternalType get(const KeyType& key)
+    {
+        map_iterator iter = m_map.find(key);
+        if (iter == m_map.end() || !*iter->second.slot) {
+            ++m_misses;
+            return HashTraits<ExternalType>::emptyValue();
+        }
+        ++m_hits;
+        iter->second.referenced = true;
+        return HandleTypes<MappedType>::getFromSlot(iter->second.slot);
+    }
+
+    void set(JSGlobalData& globalData, const KeyType& key, ExternalType value)
+    {
+        purgeDeadEntries();
+        if (m_capacity != unlimitedCapacity && static_cast<size_t>(m_map.size()) >= m_capacity && !m_map.contains(key))
+            evict();
+
+        pair<map_iterator, bool> iter = m_map.add(key, Entry());
+        Entry& entry = iter.first->second;
+        if (iter.second) {
+            entry.slot = globalData.allocateGlobalHandle();
+            entry.stamp = m_nextStamp++;
+            HandleHeap::heapFor(entry.slot)->makeWeak(entry.slot, this, FinalizerCallback::finalizerContextFor(key));
+            if (m_capacity != unlimitedCapacity) {
+                m_clock.append(std::make_pair(key, entry.stamp));
+                if (m_clock.size() > 2 * static_cast<size_t>(m_map.size()))
+                    compactClock();
+            }
+        }
+        HandleHeap::heapFor(entry.slot)->writeBarrier(entry.slot, value);
+        *entry.slot = value;
+    }
+
+    ExternalType take(const KeyType& key)
+    {
+        purgeDeadEntries();
+        map_iterator iter = m_map.find(key);
+        if (iter == m_map.end())
+            return HashTraits<ExternalType>::emptyValue();
+        HandleSlot slot = iter->second.slot;
+        m_map.remove(iter);
+        ExternalType result = HandleTypes<MappedType>::getFromSlot(slot);
+        HandleHeap::heapFor(slot)->deallocate(slot);
+        return result;
+    }
+
+    void remove(const KeyType& key)
+    {
+        take(key);
+    }
+
+    void clear()
+    {
+        map_iterator end = m_map.end();
+        for (map_iterator ptr = m_map.begin(); ptr != end; ++ptr)
+            HandleHeap::heapFor(ptr->second.slot)->deallocate(ptr->second.slot);
+        m_map.clear();
+        m_clock.clear();
+        m_deadKeys.clear();
+    }
+
+    // Removes the entries queued by the finalizer since the last purge.
+    void purgeDeadEntries()
+    {
+        if (m_deadKeys.isEmpty())
+            return;
+
+        size_t size = m_deadKeys.size();
+        for (size_t i = 0; i < size; ++i) {
+            HandleSlot slot = m_map.take(m_deadKeys[i]).slot;
+            ASSERT(slot && !*slot);
+            HandleHeap::heapFor(slot)->deallocate(slot);
+        }
+        m_finalizations += size;
+        m_deadKeys.clear();
+    }
+
+    size_t hits() const { return m_hits; }
+    size_t misses() const { return m_misses; }
+    size_t evictions() const { return m_evictions; }
+    size_t finalizations() const { return m_finalizations; }
+
+    void resetStatistics()
+    {
+        m_hits = 0;
+        m_misses = 0;
+        m_evictions = 0;
+        m_finalizations = 0;
+    }
+
+private:
+    virtual void finalize(Handle<Unknown> handle, void* context)
+    {
+        // The HandleHeap clears the slot once we return, which is what marks
+        // the entry as dead until purgeDeadEntries() runs.
+        m_deadKeys.append(FinalizerCallback::keyForFinalizer(context, HandleTypes<MappedType>::getFromSlot(handle.slot())));
+    }
+
+    // Returns the map entry a clock entry stands for, or end() if that key was
+    // removed after the clock entry was queued.
+    map_iterator findCurrent(const ClockEntry& clockEntry)
+    {
+        map_iterator iter = m_map.find(clockEntry.first);
+        if (iter != m_map.end() && iter->second.stamp != clockEntry.second)
+            return m_map.end();
+        return iter;
+    }
+
+    void compactClock()
+    {
+        ClockType liveEntries;
+        typename ClockType::iterator end = m_clock.end();
+        for (typename ClockType::iterator ptr = m_clock.begin(); ptr != end; ++ptr) {
+            if (findCurrent(*ptr) != m_map.end())
+                liveEntries.append(*ptr);
+        }
+        m_clock.swap(liveEntries);
+    }
+
+    void evict()
+    {
+        ASSERT(!m_map.isEmpty());
+        while (true) {
+            // Every live entry is in the clock, and a full pass clears every
+            // referenced mark, so this finds a victim within two passes.
+            ASSERT(!m_clock.isEmpty());
+            ClockEntry clockEntry = m_clock.first();
+            m_clock.removeFirst();
+
+            map_iterator victim = findCurrent(clockEntry);
+            if (victim == m_map.end())
+                continue;
+            if (victim->second.referenced) {
+                victim->second.referenced = false;
+                m_clock.append(clockEntry);
+                continue;
+            }
+
+            HandleHeap::heapFor(victim->second.slot)->deallocate(victim->second.slot);
+            m_map.remove(victim);
+            ++m_evictions;
+            return;
+        }
+    }
+
+    MapType m_map;
+    ClockType m_clock;
+    Vector<KeyType> m_deadKeys;
+    size_t m_capacity;
+    unsigned m_nextStamp;
+    size_t m_hits;
+    size_t m_misses;
+    size_t m_evictions;
+    size_t m_finalizations;
+};
+
 } // namespace JSC
 
 #endif // WeakGCMap_h
@@ -27,11 +27,29 @@
 #define WriteBarrier_h
 
 #include "JSValue.h"
+#include "MarkedBlock.h"
 
 namespace JSC {
 class JSCell;
 class JSGlobalData;
 
+#if ENABLE(GGC)
+inline void writeBarrier(JSGlobalData&, const JSCell* owner, JSCell* value)
+{
+    // Only old owners need remembering; young ones are traced by every collection.
+    if (!owner || !value)
+        return;
+    MarkedBlock* block = MarkedBlock::blockFor(owner);
+    if (block->isOld(owner))
+        block->setCardDirty(owner);
+}
+
+inline void writeBarrier(JSGlobalData& globalData, const JSCell* owner, JSValue value)
+{
+    if (value && value.isCell())
+        writeBarrier(globalData, owner, value.asCell());
+}
+#else
 inline void writeBarrier(JSGlobalData&, const JSCell*, JSValue)
 {
 }
@@ -39,6 +57,7 @@ inline void writeBarrier(JSGlobalData&, const JSCell*, JSValue)
 inline void writeBarrier(JSGlobalData&, const JSCell*, JSCell*)
 {
 }
+#endif
 
 typedef enum { } Unknown;
 typedef JSValue* HandleSlot;
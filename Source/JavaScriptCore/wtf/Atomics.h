@@ -108,6 +108,32 @@ inline int atomicDecrement(int volatile* addend) { return __gnu_cxx::__exchange_
 
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+// Returns true if *location held expected and was replaced by newValue. May fail
+// spuriously, so callers should retry in a loop.
+#if OS(WINDOWS)
+inline bool weakCompareAndSwap(unsigned* location, unsigned expected, unsigned newValue)
+{
+    return static_cast<unsigned>(InterlockedCompareExchange(reinterpret_cast<LONG volatile*>(location), newValue, expected)) == expected;
+}
+#elif OS(DARWIN)
+inline bool weakCompareAndSwap(unsigned* location, unsigned expected, unsigned newValue)
+{
+    return OSAtomicCompareAndSwap32Barrier(expected, newValue, reinterpret_cast<int32_t volatile*>(location));
+}
+#elif OS(ANDROID)
+inline bool weakCompareAndSwap(unsigned* location, unsigned expected, unsigned newValue)
+{
+    return !android_atomic_cmpxchg(expected, newValue, reinterpret_cast<int32_t volatile*>(location));
+}
+#else
+inline bool weakCompareAndSwap(unsigned* location, unsigned expected, unsigned newValue)
+{
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+}
+#endif
+#endif
+
 } // namespace WTF
 
 #if USE(LOCKFREE_THREADSAFEREFCOUNTED)
@@ -115,4 +141,8 @@ using WTF::atomicDecrement;
 using WTF::atomicIncrement;
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+using WTF::weakCompareAndSwap;
+#endif
+
 #endif // Atomics_h
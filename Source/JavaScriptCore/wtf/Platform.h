@@ -1133,6 +1133,11 @@
 #define ENABLE_DFG_JIT_RESTRICTIONS 1
 #endif
 
+/* Record the types of values observed by the baseline JIT, to guide the DFG JIT's speculation. */
+#if !defined(ENABLE_VALUE_PROFILER) && ENABLE(DFG_JIT)
+#define ENABLE_VALUE_PROFILER 1
+#endif
+
 /* Ensure that either the JIT or the interpreter has been enabled. */
 #if !defined(ENABLE_INTERPRETER) && !ENABLE(JIT)
 #define ENABLE_INTERPRETER 1
@@ -1278,6 +1283,27 @@
 
 #define ENABLE_JSC_ZOMBIES 0
 
+/* Atomic compare-and-swap, used by lock-free code such as the parallel marker. */
+#if !defined(ENABLE_COMPARE_AND_SWAP) && (OS(DARWIN) || OS(ANDROID) || (OS(WINDOWS) && !OS(WINCE)) || (COMPILER(GCC) && !OS(SYMBIAN) && GCC_VERSION_AT_LEAST(4, 1, 0)))
+#define ENABLE_COMPARE_AND_SWAP 1
+#endif
+
+/* Mark the heap on several threads at once, stealing work between per-thread mark stacks. */
+#if !defined(ENABLE_PARALLEL_GC) && PLATFORM(MAC) && ENABLE(COMPARE_AND_SWAP) && ENABLE(JSC_MULTIPLE_THREADS)
+#define ENABLE_PARALLEL_GC 1
+#endif
+
+/* Collect short-lived cells in cheap nursery collections, tracking old-to-young
+   pointers with card marking in the write barrier. The DFG JIT and the
+   JSVALUE32_64 JIT do not emit barriers yet. */
+#if !defined(ENABLE_GGC)
+#define ENABLE_GGC 0
+#endif
+
+#if ENABLE(GGC) && (ENABLE(DFG_JIT) || (ENABLE(JIT) && !USE(JSVALUE64)))
+#error "ENABLE(GGC) requires a JIT that emits write barriers"
+#endif
+
 /* FIXME: Eventually we should enable this for all platforms and get rid of the define. */
 #if PLATFORM(MAC) || PLATFORM(WIN) || PLATFORM(QT)
 #define WTF_USE_PLATFORM_STRATEGIES 1
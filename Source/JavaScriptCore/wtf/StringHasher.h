@@ -153,6 +153,11 @@ private:
         return ch;
     }
 
+    static inline UChar defaultCoverter(LChar ch)
+    {
+        return ch;
+    }
+
     static inline UChar defaultCoverter(char ch)
     {
         return static_cast<unsigned char>(ch);
@@ -93,7 +93,16 @@ struct CStringTranslator {
     static bool equal(StringImpl* r, const char* s)
     {
         int length = r->length();
-        const UChar* d = r->characters();
+        if (r->is8Bit()) {
+            const LChar* d = r->characters8();
+            for (int i = 0; i != length; ++i) {
+                if (d[i] != static_cast<LChar>(s[i]))
+                    return false;
+            }
+            return !s[length];
+        }
+
+        const UChar* d = r->characters16();
         for (int i = 0; i != length; ++i) {
             unsigned char c = s[i];
             if (d[i] != c)
@@ -140,10 +149,13 @@ static inline bool equal(StringImpl* string, const UChar* characters, unsigned l
     if (string->length() != length)
         return false;
 
+    if (string->is8Bit())
+        return equal(string->characters8(), characters, length);
+
     // FIXME: perhaps we should have a more abstract macro that indicates when
     // going 4 bytes at a time is unsafe
 #if CPU(ARM) || CPU(SH4) || CPU(MIPS) || CPU(SPARC)
-    const UChar* stringCharacters = string->characters();
+    const UChar* stringCharacters = string->characters16();
     for (unsigned i = 0; i != length; ++i) {
         if (*stringCharacters++ != *characters++)
             return false;
@@ -152,7 +164,7 @@ static inline bool equal(StringImpl* string, const UChar* characters, unsigned l
 #else
     /* Do it 4-bytes-at-a-time on architectures where it's safe */
 
-    const uint32_t* stringCharacters = reinterpret_cast<const uint32_t*>(string->characters());
+    const uint32_t* stringCharacters = reinterpret_cast<const uint32_t*>(string->characters16());
     const uint32_t* bufferCharacters = reinterpret_cast<const uint32_t*>(characters);
 
     unsigned halfLength = length >> 1;
@@ -192,6 +204,34 @@ struct UCharBufferTranslator {
     }
 };
 
+struct LCharBuffer {
+    const LChar* s;
+    unsigned length;
+};
+
+struct LCharBufferTranslator {
+    static unsigned hash(const LCharBuffer& buf)
+    {
+        return StringHasher::computeHash(buf.s, buf.length);
+    }
+
+    static bool equal(StringImpl* const& str, const LCharBuffer& buf)
+    {
+        if (str->length() != buf.length)
+            return false;
+        if (str->is8Bit())
+            return WTF::equal(str->characters8(), buf.s, buf.length);
+        return WTF::equal(str->characters16(), buf.s, buf.length);
+    }
+
+    static void translate(StringImpl*& location, const LCharBuffer& buf, unsigned hash)
+    {
+        location = StringImpl::create(buf.s, buf.length).leakRef();
+        location->setHash(hash);
+        location->setIsAtomic(true);
+    }
+};
+
 struct HashAndCharacters {
     unsigned hash;
     const UChar* characters;
@@ -236,11 +276,16 @@ struct HashAndUTF8CharactersTranslator {
         if (buffer.utf16Length != string->length())
             return false;
 
-        const UChar* stringCharacters = string->characters();
-
         // If buffer contains only ASCII characters UTF-8 and UTF16 length are the same.
-        if (buffer.utf16Length != buffer.length)
+        if (buffer.utf16Length != buffer.length) {
+            const UChar* stringCharacters = string->characters();
             return equalUTF16WithUTF8(stringCharacters, stringCharacters + string->length(), buffer.characters, buffer.characters + buffer.length);
+        }
+
+        if (string->is8Bit())
+            return WTF::equal(string->characters8(), reinterpret_cast<const LChar*>(buffer.characters), buffer.length);
+
+        const UChar* stringCharacters = string->characters16();
 
         for (unsigned i = 0; i < buffer.length; ++i) {
             ASSERT(isASCII(buffer.characters[i]));
@@ -253,6 +298,14 @@ struct HashAndUTF8CharactersTranslator {
 
     static void translate(StringImpl*& location, const HashAndUTF8Characters& buffer, unsigned hash)
     {
+        // An all-ASCII buffer can be stored as Latin-1 without conversion.
+        if (buffer.utf16Length == buffer.length) {
+            location = StringImpl::create(buffer.characters, buffer.length).leakRef();
+            location->setHash(hash);
+            location->setIsAtomic(true);
+            return;
+        }
+
         UChar* target;
         location = StringImpl::createUninitialized(buffer.utf16Length, target).releaseRef();
 
@@ -277,6 +330,18 @@ PassRefPtr<StringImpl> AtomicString::add(const UChar* s, unsigned length)
     return addToStringTable<UCharBuffer, UCharBufferTranslator>(buffer);
 }
 
+PassRefPtr<StringImpl> AtomicString::add(const LChar* s, unsigned length)
+{
+    if (!s)
+        return 0;
+
+    if (!length)
+        return StringImpl::empty();
+
+    LCharBuffer buffer = { s, length };
+    return addToStringTable<LCharBuffer, LCharBufferTranslator>(buffer);
+}
+
 PassRefPtr<StringImpl> AtomicString::add(const UChar* s, unsigned length, unsigned existingHash)
 {
     ASSERT(s);
@@ -37,9 +37,8 @@ namespace WTF {
 
 using namespace Unicode;
 
-static const unsigned minLengthToShare = 20;
-
-COMPILE_ASSERT(sizeof(StringImpl) == 2 * sizeof(int) + 3 * sizeof(void*), StringImpl_should_stay_small);
+// On 64-bit platforms m_is8Bit lives in what was the padding after m_hash.
+COMPILE_ASSERT(sizeof(StringImpl) <= 3 * sizeof(int) + 3 * sizeof(void*), StringImpl_should_stay_small);
 
 StringImpl::~StringImpl()
 {
@@ -55,11 +54,15 @@ StringImpl::~StringImpl()
 #endif
 
     BufferOwnership ownership = bufferOwnership();
-    if (ownership != BufferInternal) {
+    if (ownership == BufferInternal) {
+        if (is8Bit() && m_copyData16)
+            fastFree(m_copyData16);
+    } else {
         if (ownership == BufferOwned) {
             ASSERT(!m_sharedBuffer);
-            ASSERT(m_data);
-            fastFree(const_cast<UChar*>(m_data));
+            ASSERT(m_data16);
+            ASSERT(!is8Bit());
+            fastFree(const_cast<UChar*>(m_data16));
         } else if (ownership == BufferSubstring) {
             ASSERT(m_substringBuffer);
             m_substringBuffer->deref();
@@ -90,6 +93,23 @@ PassRefPtr<StringImpl> StringImpl::createUninitialized(unsigned length, UChar*&
     return adoptRef(new (string) StringImpl(length));
 }
 
+PassRefPtr<StringImpl> StringImpl::createUninitialized(unsigned length, LChar*& data)
+{
+    if (!length) {
+        data = 0;
+        return empty();
+    }
+
+    // As above, the characters follow the StringImpl in a single allocation.
+    if (length > ((std::numeric_limits<unsigned>::max() - sizeof(StringImpl)) / sizeof(LChar)))
+        CRASH();
+    size_t size = sizeof(StringImpl) + length * sizeof(LChar);
+    StringImpl* string = static_cast<StringImpl*>(fastMalloc(size));
+
+    data = reinterpret_cast<LChar*>(string + 1);
+    return adoptRef(new (string) StringImpl(length, Force8BitConstructor));
+}
+
 PassRefPtr<StringImpl> StringImpl::create(const UChar* characters, unsigned length)
 {
     if (!characters || !length)
@@ -101,17 +121,14 @@ PassRefPtr<StringImpl> StringImpl::create(const UChar* characters, unsigned leng
     return string.release();
 }
 
-PassRefPtr<StringImpl> StringImpl::create(const char* characters, unsigned length)
+PassRefPtr<StringImpl> StringImpl::create(const LChar* characters, unsigned length)
 {
     if (!characters || !length)
         return empty();
 
-    UChar* data;
+    LChar* data;
     RefPtr<StringImpl> string = createUninitialized(length, data);
-    for (unsigned i = 0; i != length; ++i) {
-        unsigned char c = characters[i];
-        data[i] = c;
-    }
+    memcpy(data, characters, length * sizeof(LChar));
     return string.release();
 }
 
@@ -128,13 +145,43 @@ PassRefPtr<StringImpl> StringImpl::create(const char* string)
 PassRefPtr<StringImpl> StringImpl::create(const UChar* characters, unsigned length, PassRefPtr<SharedUChar> sharedBuffer)
 {
     ASSERT(characters);
-    ASSERT(minLengthToShare && length >= minLengthToShare);
+    ASSERT(s_minLengthToShare && length >= s_minLengthToShare);
     return adoptRef(new StringImpl(characters, length, sharedBuffer));
 }
 
+PassRefPtr<StringImpl> StringImpl::createWithExternalBuffer(const UChar* characters, unsigned length, SharableUChar::ReleaseCallback releaseCallback, void* releaseContext)
+{
+    ASSERT(releaseCallback);
+    if (!canShareBuffer(length)) {
+        RefPtr<StringImpl> string = length ? create(characters, length) : empty();
+        releaseCallback(characters, releaseContext);
+        return string.release();
+    }
+    return create(characters, length, SharedUChar::create(new SharableUChar(characters, releaseCallback, releaseContext)));
+}
+
+const UChar* StringImpl::getData16SlowCase() const
+{
+    ASSERT(is8Bit());
+
+    // A Latin-1 substring indexes into its base's widened copy, so the base
+    // pays for the conversion at most once however many substrings it has.
+    if (bufferOwnership() == BufferSubstring)
+        return m_substringBuffer->characters() + (m_data8 - m_substringBuffer->m_data8);
+
+    ASSERT(bufferOwnership() == BufferInternal);
+    if (!m_copyData16) {
+        UChar* copy = static_cast<UChar*>(fastMalloc(m_length * sizeof(UChar)));
+        for (unsigned i = 0; i < m_length; ++i)
+            copy[i] = m_data8[i];
+        m_copyData16 = copy;
+    }
+    return m_copyData16;
+}
+
 SharedUChar* StringImpl::sharedBuffer()
 {
-    if (m_length < minLengthToShare)
+    if (m_length < s_minLengthToShare)
         return 0;
     // All static strings are smaller that the minimim length to share.
     ASSERT(!isStatic());
@@ -147,7 +194,7 @@ SharedUChar* StringImpl::sharedBuffer()
         return m_substringBuffer->sharedBuffer();
     if (ownership == BufferOwned) {
         ASSERT(!m_sharedBuffer);
-        m_sharedBuffer = SharedUChar::create(new SharableUChar(m_data)).leakRef();
+        m_sharedBuffer = SharedUChar::create(new SharableUChar(m_data16)).leakRef();
         m_bufferOwnership = BufferShared;
     }
 
@@ -161,8 +208,9 @@ bool StringImpl::containsOnlyWhitespace()
     // FIXME: The definition of whitespace here includes a number of characters
     // that are not whitespace from the point of view of RenderText; I wonder if
     // that's a problem in practice.
+    const UChar* characters = this->characters();
     for (unsigned i = 0; i < m_length; i++)
-        if (!isASCIISpace(m_data[i]))
+        if (!isASCIISpace(characters[i]))
             return false;
     return true;
 }
@@ -177,15 +225,20 @@ PassRefPtr<StringImpl> StringImpl::substring(unsigned start, unsigned length)
             return this;
         length = maxLength;
     }
-    return create(m_data + start, length);
+    if (is8Bit())
+        return create(m_data8 + start, length);
+    return create(m_data16 + start, length);
 }
 
 UChar32 StringImpl::characterStartingAt(unsigned i)
 {
-    if (U16_IS_SINGLE(m_data[i]))
-        return m_data[i];
-    if (i + 1 < m_length && U16_IS_LEAD(m_data[i]) && U16_IS_TRAIL(m_data[i + 1]))
-        return U16_GET_SUPPLEMENTARY(m_data[i], m_data[i + 1]);
+    if (is8Bit())
+        return m_data8[i];
+    const UChar* characters = m_data16;
+    if (U16_IS_SINGLE(characters[i]))
+        return characters[i];
+    if (i + 1 < m_length && U16_IS_LEAD(characters[i]) && U16_IS_TRAIL(characters[i + 1]))
+        return U16_GET_SUPPLEMENTARY(characters[i], characters[i + 1]);
     return 0;
 }
 
@@ -195,12 +248,36 @@ PassRefPtr<StringImpl> StringImpl::lower()
     // no-op code path up through the first 'return' statement.
     if (isLower())
         return this;
-    
+
+    if (is8Bit()) {
+        // Keep all-ASCII Latin-1 strings narrow; anything else takes the UTF-16 path below.
+        LChar ored = 0;
+        bool noUpper = true;
+        for (unsigned i = 0; i < m_length; ++i) {
+            if (UNLIKELY(isASCIIUpper(m_data8[i])))
+                noUpper = false;
+            ored |= m_data8[i];
+        }
+        if (!(ored & ~0x7F)) {
+            if (noUpper) {
+                setIsLower(true);
+                return this;
+            }
+            LChar* data8;
+            RefPtr<StringImpl> newImpl = createUninitialized(m_length, data8);
+            for (unsigned i = 0; i < m_length; ++i)
+                data8[i] = toASCIILower(m_data8[i]);
+            return newImpl.release();
+        }
+    }
+
+    const UChar* characters = this->characters();
+
     // First scan the string for uppercase and non-ASCII characters:
     UChar ored = 0;
     bool noUpper = true;
-    const UChar *end = m_data + m_length;
-    for (const UChar* chp = m_data; chp != end; chp++) {
+    const UChar *end = characters + m_length;
+    for (const UChar* chp = characters; chp != end; chp++) {
         if (UNLIKELY(isASCIIUpper(*chp)))
             noUpper = false;
         ored |= *chp;
@@ -222,7 +299,7 @@ PassRefPtr<StringImpl> StringImpl::lower()
     if (!(ored & ~0x7F)) {
         // Do a faster loop for the case where all the characters are ASCII.
         for (int i = 0; i < length; i++) {
-            UChar c = m_data[i];
+            UChar c = characters[i];
             data[i] = toASCIILower(c);
         }
         return newImpl;
@@ -230,11 +307,11 @@ PassRefPtr<StringImpl> StringImpl::lower()
     
     // Do a slower implementation for cases that include non-ASCII characters.
     bool error;
-    int32_t realLength = Unicode::toLower(data, length, m_data, m_length, &error);
+    int32_t realLength = Unicode::toLower(data, length, characters, m_length, &error);
     if (!error && realLength == length)
         return newImpl;
     newImpl = createUninitialized(realLength, data);
-    Unicode::toLower(data, realLength, m_data, m_length, &error);
+    Unicode::toLower(data, realLength, characters, m_length, &error);
     if (error)
         return this;
     return newImpl;
@@ -251,11 +328,12 @@ PassRefPtr<StringImpl> StringImpl::upper()
     if (m_length > static_cast<unsigned>(numeric_limits<int32_t>::max()))
         CRASH();
     int32_t length = m_length;
+    const UChar* characters = this->characters();
 
     // Do a faster loop for the case where all the characters are ASCII.
     UChar ored = 0;
     for (int i = 0; i < length; i++) {
-        UChar c = m_data[i];
+        UChar c = characters[i];
         ored |= c;
         data[i] = toASCIIUpper(c);
     }
@@ -264,11 +342,11 @@ PassRefPtr<StringImpl> StringImpl::upper()
 
     // Do a slower implementation for cases that include non-ASCII characters.
     bool error;
-    int32_t realLength = Unicode::toUpper(data, length, m_data, m_length, &error);
+    int32_t realLength = Unicode::toUpper(data, length, characters, m_length, &error);
     if (!error && realLength == length)
         return newImpl;
     newImpl = createUninitialized(realLength, data);
-    Unicode::toUpper(data, realLength, m_data, m_length, &error);
+    Unicode::toUpper(data, realLength, characters, m_length, &error);
     if (error)
         return this;
     return newImpl.release();
@@ -284,7 +362,7 @@ PassRefPtr<StringImpl> StringImpl::secure(UChar character, LastCharacterBehavior
     unsigned lastCharacterIndex = m_length - 1;
     for (unsigned i = 0; i < lastCharacterIndex; ++i)
         data[i] = character;
-    data[lastCharacterIndex] = (behavior == ObscureLastCharacter) ? character : m_data[lastCharacterIndex];
+    data[lastCharacterIndex] = (behavior == ObscureLastCharacter) ? character : characters()[lastCharacterIndex];
     return newImpl.release();
 }
 
@@ -296,11 +374,12 @@ PassRefPtr<StringImpl> StringImpl::foldCase()
     if (m_length > static_cast<unsigned>(numeric_limits<int32_t>::max()))
         CRASH();
     int32_t length = m_length;
+    const UChar* characters = this->characters();
 
     // Do a faster loop for the case where all the characters are ASCII.
     UChar ored = 0;
     for (int32_t i = 0; i < length; i++) {
-        UChar c = m_data[i];
+        UChar c = characters[i];
         ored |= c;
         data[i] = toASCIILower(c);
     }
@@ -309,11 +388,11 @@ PassRefPtr<StringImpl> StringImpl::foldCase()
 
     // Do a slower implementation for cases that include non-ASCII characters.
     bool error;
-    int32_t realLength = Unicode::foldCase(data, length, m_data, m_length, &error);
+    int32_t realLength = Unicode::foldCase(data, length, characters, m_length, &error);
     if (!error && realLength == length)
         return newImpl.release();
     newImpl = createUninitialized(realLength, data);
-    Unicode::foldCase(data, realLength, m_data, m_length, &error);
+    Unicode::foldCase(data, realLength, characters, m_length, &error);
     if (error)
         return this;
     return newImpl.release();
@@ -328,7 +407,7 @@ PassRefPtr<StringImpl> StringImpl::stripWhiteSpace()
     unsigned end = m_length - 1;
     
     // skip white space from start
-    while (start <= end && isSpaceOrNewline(m_data[start]))
+    while (start <= end && isSpaceOrNewline((*this)[start]))
         start++;
     
     // only white space
@@ -336,17 +415,19 @@ PassRefPtr<StringImpl> StringImpl::stripWhiteSpace()
         return empty();
 
     // skip white space from end
-    while (end && isSpaceOrNewline(m_data[end]))
+    while (end && isSpaceOrNewline((*this)[end]))
         end--;
 
     if (!start && end == m_length - 1)
         return this;
-    return create(m_data + start, end + 1 - start);
+    if (is8Bit())
+        return create(m_data8 + start, end + 1 - start);
+    return create(m_data16 + start, end + 1 - start);
 }
 
 PassRefPtr<StringImpl> StringImpl::removeCharacters(CharacterMatchFunctionPtr findMatch)
 {
-    const UChar* from = m_data;
+    const UChar* from = characters();
     const UChar* fromend = from + m_length;
 
     // Assume the common case will not remove any characters
@@ -357,10 +438,10 @@ PassRefPtr<StringImpl> StringImpl::removeCharacters(CharacterMatchFunctionPtr fi
 
     StringBuffer data(m_length);
     UChar* to = data.characters();
-    unsigned outc = from - m_data;
+    unsigned outc = from - characters();
 
     if (outc)
-        memcpy(to, m_data, outc * sizeof(UChar));
+        memcpy(to, characters(), outc * sizeof(UChar));
 
     while (true) {
         while (from != fromend && findMatch(*from))
@@ -380,7 +461,7 @@ PassRefPtr<StringImpl> StringImpl::simplifyWhiteSpace()
 {
     StringBuffer data(m_length);
 
-    const UChar* from = m_data;
+    const UChar* from = characters();
     const UChar* fromend = from + m_length;
     int outc = 0;
     bool changedToSpace = false;
@@ -414,62 +495,62 @@ PassRefPtr<StringImpl> StringImpl::simplifyWhiteSpace()
 
 int StringImpl::toIntStrict(bool* ok, int base)
 {
-    return charactersToIntStrict(m_data, m_length, ok, base);
+    return charactersToIntStrict(characters(), m_length, ok, base);
 }
 
 unsigned StringImpl::toUIntStrict(bool* ok, int base)
 {
-    return charactersToUIntStrict(m_data, m_length, ok, base);
+    return charactersToUIntStrict(characters(), m_length, ok, base);
 }
 
 int64_t StringImpl::toInt64Strict(bool* ok, int base)
 {
-    return charactersToInt64Strict(m_data, m_length, ok, base);
+    return charactersToInt64Strict(characters(), m_length, ok, base);
 }
 
 uint64_t StringImpl::toUInt64Strict(bool* ok, int base)
 {
-    return charactersToUInt64Strict(m_data, m_length, ok, base);
+    return charactersToUInt64Strict(characters(), m_length, ok, base);
 }
 
 intptr_t StringImpl::toIntPtrStrict(bool* ok, int base)
 {
-    return charactersToIntPtrStrict(m_data, m_length, ok, base);
+    return charactersToIntPtrStrict(characters(), m_length, ok, base);
 }
 
 int StringImpl::toInt(bool* ok)
 {
-    return charactersToInt(m_data, m_length, ok);
+    return charactersToInt(characters(), m_length, ok);
 }
 
 unsigned StringImpl::toUInt(bool* ok)
 {
-    return charactersToUInt(m_data, m_length, ok);
+    return charactersToUInt(characters(), m_length, ok);
 }
 
 int64_t StringImpl::toInt64(bool* ok)
 {
-    return charactersToInt64(m_data, m_length, ok);
+    return charactersToInt64(characters(), m_length, ok);
 }
 
 uint64_t StringImpl::toUInt64(bool* ok)
 {
-    return charactersToUInt64(m_data, m_length, ok);
+    return charactersToUInt64(characters(), m_length, ok);
 }
 
 intptr_t StringImpl::toIntPtr(bool* ok)
 {
-    return charactersToIntPtr(m_data, m_length, ok);
+    return charactersToIntPtr(characters(), m_length, ok);
 }
 
 double StringImpl::toDouble(bool* ok, bool* didReadNumber)
 {
-    return charactersToDouble(m_data, m_length, ok, didReadNumber);
+    return charactersToDouble(characters(), m_length, ok, didReadNumber);
 }
 
 float StringImpl::toFloat(bool* ok, bool* didReadNumber)
 {
-    return charactersToFloat(m_data, m_length, ok, didReadNumber);
+    return charactersToFloat(characters(), m_length, ok, didReadNumber);
 }
 
 static bool equal(const UChar* a, const char* b, int length)
@@ -524,12 +605,12 @@ int codePointCompare(const StringImpl* s1, const StringImpl* s2)
 
 size_t StringImpl::find(UChar c, unsigned start)
 {
-    return WTF::find(m_data, m_length, c, start);
+    return WTF::find(characters(), m_length, c, start);
 }
 
 size_t StringImpl::find(CharacterMatchFunctionPtr matchFunction, unsigned start)
 {
-    return WTF::find(m_data, m_length, matchFunction, start);
+    return WTF::find(characters(), m_length, matchFunction, start);
 }
 
 size_t StringImpl::find(const char* matchString, unsigned index)
@@ -693,7 +774,7 @@ size_t StringImpl::findIgnoringCase(StringImpl* matchString, unsigned index)
 
 size_t StringImpl::reverseFind(UChar c, unsigned index)
 {
-    return WTF::reverseFind(m_data, m_length, c, index);
+    return WTF::reverseFind(characters(), m_length, c, index);
 }
 
 size_t StringImpl::reverseFind(StringImpl* matchString, unsigned index)
@@ -779,9 +860,10 @@ PassRefPtr<StringImpl> StringImpl::replace(UChar oldC, UChar newC)
 {
     if (oldC == newC)
         return this;
+    const UChar* characters = this->characters();
     unsigned i;
     for (i = 0; i != m_length; ++i)
-        if (m_data[i] == oldC)
+        if (characters[i] == oldC)
             break;
     if (i == m_length)
         return this;
@@ -790,7 +872,7 @@ PassRefPtr<StringImpl> StringImpl::replace(UChar oldC, UChar newC)
     RefPtr<StringImpl> newImpl = createUninitialized(m_length, data);
 
     for (i = 0; i != m_length; ++i) {
-        UChar ch = m_data[i];
+        UChar ch = characters[i];
         if (ch == oldC)
             ch = newC;
         data[i] = ch;
@@ -860,15 +942,15 @@ PassRefPtr<StringImpl> StringImpl::replace(UChar pattern, StringImpl* replacemen
     
     while ((srcSegmentEnd = find(pattern, srcSegmentStart)) != notFound) {
         srcSegmentLength = srcSegmentEnd - srcSegmentStart;
-        memcpy(data + dstOffset, m_data + srcSegmentStart, srcSegmentLength * sizeof(UChar));
+        memcpy(data + dstOffset, characters() + srcSegmentStart, srcSegmentLength * sizeof(UChar));
         dstOffset += srcSegmentLength;
-        memcpy(data + dstOffset, replacement->m_data, repStrLength * sizeof(UChar));
+        memcpy(data + dstOffset, replacement->characters(), repStrLength * sizeof(UChar));
         dstOffset += repStrLength;
         srcSegmentStart = srcSegmentEnd + 1;
     }
 
     srcSegmentLength = m_length - srcSegmentStart;
-    memcpy(data + dstOffset, m_data + srcSegmentStart, srcSegmentLength * sizeof(UChar));
+    memcpy(data + dstOffset, characters() + srcSegmentStart, srcSegmentLength * sizeof(UChar));
 
     ASSERT(dstOffset + srcSegmentLength == newImpl->length());
 
@@ -918,15 +1000,15 @@ PassRefPtr<StringImpl> StringImpl::replace(StringImpl* pattern, StringImpl* repl
     
     while ((srcSegmentEnd = find(pattern, srcSegmentStart)) != notFound) {
         srcSegmentLength = srcSegmentEnd - srcSegmentStart;
-        memcpy(data + dstOffset, m_data + srcSegmentStart, srcSegmentLength * sizeof(UChar));
+        memcpy(data + dstOffset, characters() + srcSegmentStart, srcSegmentLength * sizeof(UChar));
         dstOffset += srcSegmentLength;
-        memcpy(data + dstOffset, replacement->m_data, repStrLength * sizeof(UChar));
+        memcpy(data + dstOffset, replacement->characters(), repStrLength * sizeof(UChar));
         dstOffset += repStrLength;
         srcSegmentStart = srcSegmentEnd + patternLength;
     }
 
     srcSegmentLength = m_length - srcSegmentStart;
-    memcpy(data + dstOffset, m_data + srcSegmentStart, srcSegmentLength * sizeof(UChar));
+    memcpy(data + dstOffset, characters() + srcSegmentStart, srcSegmentLength * sizeof(UChar));
 
     ASSERT(dstOffset + srcSegmentLength == newImpl->length());
 
@@ -946,7 +1028,19 @@ bool equal(const StringImpl* a, const char* b)
         return !a;
 
     unsigned length = a->length();
-    const UChar* as = a->characters();
+    if (a->is8Bit()) {
+        const LChar* as = a->characters8();
+        for (unsigned i = 0; i != length; ++i) {
+            LChar bc = b[i];
+            if (!bc)
+                return false;
+            if (as[i] != bc)
+                return false;
+        }
+        return !b[length];
+    }
+
+    const UChar* as = a->characters16();
     for (unsigned i = 0; i != length; ++i) {
         unsigned char bc = b[i];
         if (!bc)
@@ -1011,8 +1105,9 @@ bool equalIgnoringNullity(StringImpl* a, StringImpl* b)
 
 WTF::Unicode::Direction StringImpl::defaultWritingDirection(bool* hasStrongDirectionality)
 {
+    const UChar* characters = this->characters();
     for (unsigned i = 0; i < m_length; ++i) {
-        WTF::Unicode::Direction charDirection = WTF::Unicode::direction(m_data[i]);
+        WTF::Unicode::Direction charDirection = WTF::Unicode::direction(characters[i]);
         if (charDirection == WTF::Unicode::LeftToRight) {
             if (hasStrongDirectionality)
                 *hasStrongDirectionality = true;
@@ -1060,7 +1155,11 @@ PassRefPtr<StringImpl> StringImpl::createWithTerminatingNullCharacter(const Stri
     if (length >= numeric_limits<unsigned>::max())
         CRASH();
     RefPtr<StringImpl> terminatedString = createUninitialized(length + 1, data);
-    memcpy(data, string.m_data, length * sizeof(UChar));
+    if (string.is8Bit()) {
+        for (unsigned i = 0; i < length; ++i)
+            data[i] = string.m_data8[i];
+    } else
+        memcpy(data, string.m_data16, length * sizeof(UChar));
     data[length] = 0;
     terminatedString->m_length--;
     terminatedString->m_hash = string.m_hash;
@@ -1070,13 +1169,15 @@ PassRefPtr<StringImpl> StringImpl::createWithTerminatingNullCharacter(const Stri
 
 PassRefPtr<StringImpl> StringImpl::threadsafeCopy() const
 {
-    return create(m_data, m_length);
+    if (is8Bit())
+        return create(m_data8, m_length);
+    return create(m_data16, m_length);
 }
 
 PassRefPtr<StringImpl> StringImpl::crossThreadString()
 {
     if (SharedUChar* sharedBuffer = this->sharedBuffer())
-        return adoptRef(new StringImpl(m_data, m_length, sharedBuffer->crossThreadCopy()));
+        return adoptRef(new StringImpl(m_data16, m_length, sharedBuffer->crossThreadCopy()));
 
     // If no shared buffer is available, create a copy.
     return threadsafeCopy();
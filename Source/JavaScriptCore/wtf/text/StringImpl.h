@@ -46,6 +46,7 @@ typedef const struct __CFString * CFStringRef;
 // Landing the file moves in one patch, will follow on with patches to change the namespaces.
 namespace JSC {
 struct IdentifierCStringTranslator;
+struct IdentifierLCharBufferTranslator;
 struct IdentifierUCharBufferTranslator;
 }
 
@@ -54,20 +55,59 @@ namespace WTF {
 struct CStringTranslator;
 struct HashAndCharactersTranslator;
 struct HashAndUTF8CharactersTranslator;
+struct LCharBufferTranslator;
 struct UCharBufferTranslator;
 
 enum TextCaseSensitivity { TextCaseSensitive, TextCaseInsensitive };
 
-typedef OwnFastMallocPtr<const UChar> SharableUChar;
+// A UTF-16 buffer that can be shared between strings on different threads. It is freed with
+// fastFree, unless it belongs to a client that supplied a callback to release it instead.
+class SharableUChar {
+    WTF_MAKE_NONCOPYABLE(SharableUChar); WTF_MAKE_FAST_ALLOCATED;
+public:
+    typedef void (*ReleaseCallback)(const UChar*, void* context);
+
+    explicit SharableUChar(const UChar* characters)
+        : m_characters(characters)
+        , m_releaseCallback(0)
+        , m_releaseContext(0)
+    {
+    }
+
+    SharableUChar(const UChar* characters, ReleaseCallback releaseCallback, void* releaseContext)
+        : m_characters(characters)
+        , m_releaseCallback(releaseCallback)
+        , m_releaseContext(releaseContext)
+    {
+    }
+
+    ~SharableUChar()
+    {
+        if (m_releaseCallback)
+            m_releaseCallback(m_characters, m_releaseContext);
+        else
+            fastFree(const_cast<UChar*>(m_characters));
+    }
+
+    const UChar* get() const { return m_characters; }
+
+private:
+    const UChar* m_characters;
+    ReleaseCallback m_releaseCallback;
+    void* m_releaseContext;
+};
+
 typedef CrossThreadRefCounted<SharableUChar> SharedUChar;
 typedef bool (*CharacterMatchFunctionPtr)(UChar);
 
 class StringImpl : public StringImplBase {
     friend struct JSC::IdentifierCStringTranslator;
+    friend struct JSC::IdentifierLCharBufferTranslator;
     friend struct JSC::IdentifierUCharBufferTranslator;
     friend struct WTF::CStringTranslator;
     friend struct WTF::HashAndCharactersTranslator;
     friend struct WTF::HashAndUTF8CharactersTranslator;
+    friend struct WTF::LCharBufferTranslator;
     friend struct WTF::UCharBufferTranslator;
     friend class AtomicStringImpl;
 private:
@@ -76,9 +116,10 @@ private:
     // static strings will be shared across threads & ref-counted in a non-threadsafe manner.
     StringImpl(const UChar* characters, unsigned length, StaticStringConstructType)
         : StringImplBase(length, ConstructStaticString)
-        , m_data(characters)
+        , m_data16(characters)
         , m_buffer(0)
         , m_hash(0)
+        , m_is8Bit(false)
     {
         // Ensure that the hash is computed so that AtomicStringHash can call existingHash()
         // with impunity. The empty string is special because it is never entered into
@@ -89,45 +130,77 @@ private:
     // Create a normal string with internal storage (BufferInternal)
     StringImpl(unsigned length)
         : StringImplBase(length, BufferInternal)
-        , m_data(reinterpret_cast<const UChar*>(this + 1))
+        , m_data16(reinterpret_cast<const UChar*>(this + 1))
         , m_buffer(0)
         , m_hash(0)
+        , m_is8Bit(false)
     {
-        ASSERT(m_data);
+        ASSERT(m_data16);
+        ASSERT(m_length);
+    }
+
+    // Create a Latin-1 string with internal storage (BufferInternal)
+    enum Force8Bit { Force8BitConstructor };
+    StringImpl(unsigned length, Force8Bit)
+        : StringImplBase(length, BufferInternal)
+        , m_data8(reinterpret_cast<const LChar*>(this + 1))
+        , m_buffer(0)
+        , m_hash(0)
+        , m_is8Bit(true)
+    {
+        ASSERT(m_data8);
         ASSERT(m_length);
     }
 
     // Create a StringImpl adopting ownership of the provided buffer (BufferOwned)
     StringImpl(const UChar* characters, unsigned length)
         : StringImplBase(length, BufferOwned)
-        , m_data(characters)
+        , m_data16(characters)
         , m_buffer(0)
         , m_hash(0)
+        , m_is8Bit(false)
     {
-        ASSERT(m_data);
+        ASSERT(m_data16);
         ASSERT(m_length);
     }
 
     // Used to create new strings that are a substring of an existing StringImpl (BufferSubstring)
     StringImpl(const UChar* characters, unsigned length, PassRefPtr<StringImpl> base)
         : StringImplBase(length, BufferSubstring)
-        , m_data(characters)
+        , m_data16(characters)
+        , m_substringBuffer(base.leakRef())
+        , m_hash(0)
+        , m_is8Bit(false)
+    {
+        ASSERT(m_data16);
+        ASSERT(m_length);
+        ASSERT(m_substringBuffer->bufferOwnership() != BufferSubstring);
+        ASSERT(!m_substringBuffer->is8Bit());
+    }
+
+    // Used to create new strings that are a substring of an existing Latin-1 StringImpl (BufferSubstring)
+    StringImpl(const LChar* characters, unsigned length, PassRefPtr<StringImpl> base)
+        : StringImplBase(length, BufferSubstring)
+        , m_data8(characters)
         , m_substringBuffer(base.leakRef())
         , m_hash(0)
+        , m_is8Bit(true)
     {
-        ASSERT(m_data);
+        ASSERT(m_data8);
         ASSERT(m_length);
         ASSERT(m_substringBuffer->bufferOwnership() != BufferSubstring);
+        ASSERT(m_substringBuffer->is8Bit());
     }
 
     // Used to construct new strings sharing an existing SharedUChar (BufferShared)
     StringImpl(const UChar* characters, unsigned length, PassRefPtr<SharedUChar> sharedBuffer)
         : StringImplBase(length, BufferShared)
-        , m_data(characters)
+        , m_data16(characters)
         , m_sharedBuffer(sharedBuffer.leakRef())
         , m_hash(0)
+        , m_is8Bit(false)
     {
-        ASSERT(m_data);
+        ASSERT(m_data16);
         ASSERT(m_length);
     }
 
@@ -136,7 +209,7 @@ private:
     {
         ASSERT(!isStatic());
         ASSERT(!m_hash);
-        ASSERT(hash == StringHasher::computeHash(m_data, m_length));
+        ASSERT(hash == (is8Bit() ? StringHasher::computeHash(m_data8, m_length) : StringHasher::computeHash(m_data16, m_length)));
         m_hash = hash;
     }
 
@@ -144,9 +217,15 @@ public:
     ~StringImpl();
 
     static PassRefPtr<StringImpl> create(const UChar*, unsigned length);
-    static PassRefPtr<StringImpl> create(const char*, unsigned length);
+    static PassRefPtr<StringImpl> create(const LChar*, unsigned length);
+    static PassRefPtr<StringImpl> create(const char* characters, unsigned length) { return create(reinterpret_cast<const LChar*>(characters), length); }
     static PassRefPtr<StringImpl> create(const char*);
     static PassRefPtr<StringImpl> create(const UChar*, unsigned length, PassRefPtr<SharedUChar> sharedBuffer);
+    // Creates a string using a buffer owned by the caller, which is released through the
+    // callback once no string uses it any more. Short strings are copied, and the buffer
+    // released before this returns.
+    static PassRefPtr<StringImpl> createWithExternalBuffer(const UChar*, unsigned length, SharableUChar::ReleaseCallback, void* releaseContext);
+    static bool canShareBuffer(unsigned length) { return length >= s_minLengthToShare; }
     static ALWAYS_INLINE PassRefPtr<StringImpl> create(PassRefPtr<StringImpl> rep, unsigned offset, unsigned length)
     {
         ASSERT(rep);
@@ -156,10 +235,13 @@ public:
             return empty();
 
         StringImpl* ownerRep = (rep->bufferOwnership() == BufferSubstring) ? rep->m_substringBuffer : rep.get();
-        return adoptRef(new StringImpl(rep->m_data + offset, length, ownerRep));
+        if (rep->is8Bit())
+            return adoptRef(new StringImpl(rep->m_data8 + offset, length, ownerRep));
+        return adoptRef(new StringImpl(rep->m_data16 + offset, length, ownerRep));
     }
 
     static PassRefPtr<StringImpl> createUninitialized(unsigned length, UChar*& data);
+    static PassRefPtr<StringImpl> createUninitialized(unsigned length, LChar*& data);
     static ALWAYS_INLINE PassRefPtr<StringImpl> tryCreateUninitialized(unsigned length, UChar*& output)
     {
         if (!length) {
@@ -180,7 +262,8 @@ public:
         return adoptRef(new(resultImpl) StringImpl(length));
     }
 
-    static unsigned dataOffset() { return OBJECT_OFFSETOF(StringImpl, m_data); }
+    static unsigned dataOffset() { return OBJECT_OFFSETOF(StringImpl, m_data16); }
+    static unsigned is8BitOffset() { return OBJECT_OFFSETOF(StringImpl, m_is8Bit); }
     static PassRefPtr<StringImpl> createWithTerminatingNullCharacter(const StringImpl&);
     static PassRefPtr<StringImpl> createStrippingNullCharacters(const UChar*, unsigned length);
 
@@ -198,7 +281,20 @@ public:
     static PassRefPtr<StringImpl> adopt(StringBuffer&);
 
     SharedUChar* sharedBuffer();
-    const UChar* characters() const { return m_data; }
+
+    bool is8Bit() const { return m_is8Bit; }
+    const LChar* characters8() const { ASSERT(is8Bit()); return m_data8; }
+    const UChar* characters16() const { ASSERT(!is8Bit()); return m_data16; }
+
+    // Latin-1 strings are widened on first request, and the UTF-16 copy is
+    // kept for the lifetime of the string. Callers that can handle either
+    // width should check is8Bit() and use characters8() / characters16().
+    const UChar* characters() const
+    {
+        if (!is8Bit())
+            return m_data16;
+        return getData16SlowCase();
+    }
 
     size_t cost()
     {
@@ -224,7 +320,12 @@ public:
     bool isLower() const { return m_lower; }
     void setIsLower(bool isLower) { m_lower = isLower; }
 
-    unsigned hash() const { if (!m_hash) m_hash = StringHasher::computeHash(m_data, m_length); return m_hash; }
+    unsigned hash() const
+    {
+        if (!m_hash)
+            m_hash = is8Bit() ? StringHasher::computeHash(m_data8, m_length) : StringHasher::computeHash(m_data16, m_length);
+        return m_hash;
+    }
     unsigned existingHash() const { ASSERT(m_hash); return m_hash; }
 
     ALWAYS_INLINE void deref() { --m_refCount; if (!m_refCount && !m_static) delete this; }
@@ -241,6 +342,12 @@ public:
             memcpy(destination, source, numCharacters * sizeof(UChar));
     }
 
+    static void copyChars(UChar* destination, const LChar* source, unsigned numCharacters)
+    {
+        for (unsigned i = 0; i < numCharacters; ++i)
+            destination[i] = source[i];
+    }
+
     // Returns a StringImpl suitable for use on another thread.
     PassRefPtr<StringImpl> crossThreadString();
     // Makes a deep copy. Helpful only if you need to use a String on another thread
@@ -250,7 +357,13 @@ public:
 
     PassRefPtr<StringImpl> substring(unsigned pos, unsigned len = UINT_MAX);
 
-    UChar operator[](unsigned i) { ASSERT(i < m_length); return m_data[i]; }
+    UChar operator[](unsigned i)
+    {
+        ASSERT(i < m_length);
+        if (is8Bit())
+            return m_data8[i];
+        return m_data16[i];
+    }
     UChar32 characterStartingAt(unsigned);
 
     bool containsOnlyWhitespace();
@@ -314,18 +427,28 @@ public:
 private:
     // This number must be at least 2 to avoid sharing empty, null as well as 1 character strings from SmallStrings.
     static const unsigned s_copyCharsInlineCutOff = 20;
+    // Strings shorter than this are copied rather than sharing a SharedUChar.
+    static const unsigned s_minLengthToShare = 20;
 
     static PassRefPtr<StringImpl> createStrippingNullCharactersSlowCase(const UChar*, unsigned length);
     
     BufferOwnership bufferOwnership() const { return static_cast<BufferOwnership>(m_bufferOwnership); }
     bool isStatic() const { return m_static; }
-    const UChar* m_data;
+    const UChar* getData16SlowCase() const;
+
+    union {
+        const LChar* m_data8;
+        const UChar* m_data16;
+    };
     union {
         void* m_buffer;
         StringImpl* m_substringBuffer;
         SharedUChar* m_sharedBuffer;
+        // Only used by Latin-1 strings with internal storage, which have no other use for this slot.
+        mutable UChar* m_copyData16;
     };
     mutable unsigned m_hash;
+    bool m_is8Bit;
 };
 
 bool equal(const StringImpl*, const StringImpl*);
@@ -340,6 +463,22 @@ inline bool equalIgnoringCase(const char* a, const UChar* b, unsigned length) {
 
 bool equalIgnoringNullity(StringImpl*, StringImpl*);
 
+inline bool equal(const LChar* a, const LChar* b, unsigned length)
+{
+    return !memcmp(a, b, length);
+}
+
+inline bool equal(const LChar* a, const UChar* b, unsigned length)
+{
+    for (unsigned i = 0; i != length; ++i) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+inline bool equal(const UChar* a, const LChar* b, unsigned length) { return equal(b, a, length); }
+
 template<size_t inlineCapacity>
 bool equalIgnoringNullity(const Vector<UChar, inlineCapacity>& a, StringImpl* b)
 {
@@ -395,6 +534,8 @@ template<> struct DefaultHash<RefPtr<StringImpl> > {
 
 }
 
+using WTF::SharableUChar;
+using WTF::SharedUChar;
 using WTF::StringImpl;
 using WTF::equal;
 using WTF::TextCaseSensitivity;
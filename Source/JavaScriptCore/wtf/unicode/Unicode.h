@@ -39,6 +39,9 @@
 #error "Unknown Unicode implementation"
 #endif
 
+// Define platform neutral 8 bit character type (L is for Latin-1).
+typedef unsigned char LChar;
+
 COMPILE_ASSERT(sizeof(UChar) == 2, UCharIsTwoBytes);
 
 #endif // WTF_UNICODE_H
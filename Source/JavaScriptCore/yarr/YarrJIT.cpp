@@ -1135,8 +1135,12 @@ class YarrGenerator : private MacroAssembler {
             m_parenBacktrack.linkAlternativeBacktracks(generator);
             m_withinBacktrackJumps.link(generator);
 
-            if (m_term.capture())
+            // Clear both indices, so that a back reference reached after backtracking
+            // out of the parentheses sees the subpattern as not having matched.
+            if (m_term.capture()) {
                 generator->store32(TrustedImm32(-1), Address(output, (m_term.parentheses.subpatternId << 1) * sizeof(int)));
+                generator->store32(TrustedImm32(-1), Address(output, ((m_term.parentheses.subpatternId << 1) + 1) * sizeof(int)));
+            }
 
             if (m_term.quantityType == QuantifierGreedy) {
                 generator->storeToFrame(TrustedImm32(-1), parenthesesFrameLocation);
@@ -1543,6 +1547,68 @@ class YarrGenerator : private MacroAssembler {
         state.setBacktrackLabel(backtrackBegin);
     }
 
+    void generateBackReference(TermGenerationState& state)
+    {
+        const RegisterID character = regT0;
+        const RegisterID patternIndex = regT1;
+        PatternTerm& term = state.term();
+        ASSERT(term.quantityType == QuantifierFixedCount);
+        ASSERT(term.quantityCount == 1);
+        ASSERT(!m_pattern.m_ignoreCase);
+
+        unsigned subpatternId = term.backReferenceSubpatternId;
+        Address matchBegin(output, (subpatternId << 1) * sizeof(int));
+        Address matchEnd(output, ((subpatternId << 1) + 1) * sizeof(int));
+
+        // The frame holds the number of characters consumed, followed by the index on entry.
+        storeToFrame(TrustedImm32(0), term.frameLocation);
+
+        // A reference to a subpattern that has not matched, or matched the empty string, matches the empty string.
+        // An end index before the start can only be left over from an earlier attempt; never walk backwards
+        // through the input for it.
+        JumpList matchesEmpty;
+        load32(matchBegin, patternIndex);
+        matchesEmpty.append(branch32(Equal, patternIndex, TrustedImm32(-1)));
+        load32(matchEnd, character);
+        sub32(patternIndex, character);
+        matchesEmpty.append(branch32(LessThanOrEqual, character, TrustedImm32(0)));
+
+        storeToFrame(character, term.frameLocation);
+        storeToFrame(index, term.frameLocation + 1);
+
+        JumpList failures;
+        add32(character, index);
+        failures.append(branch32(Above, index, length));
+
+        // Compare the characters, using index to walk the input.
+        loadFromFrame(term.frameLocation + 1, index);
+        if (state.inputOffset())
+            add32(Imm32(state.inputOffset()), index);
+        Label loop(this);
+        load16(BaseIndex(input, patternIndex, TimesTwo), character);
+        failures.append(branch16(NotEqual, BaseIndex(input, index, TimesTwo), character));
+        add32(TrustedImm32(1), patternIndex);
+        add32(TrustedImm32(1), index);
+        branch32(NotEqual, patternIndex, matchEnd).linkTo(loop, this);
+        if (state.inputOffset())
+            sub32(Imm32(state.inputOffset()), index);
+        Jump matched = jump();
+
+        failures.link(this);
+        loadFromFrame(term.frameLocation + 1, index);
+        state.jumpToBacktrack(this);
+
+        Label backtrackBegin(this);
+        loadFromFrame(term.frameLocation, character);
+        sub32(character, index);
+        state.jumpToBacktrack(this);
+
+        matchesEmpty.link(this);
+        matched.link(this);
+
+        state.setBacktrackLabel(backtrackBegin);
+    }
+
     void generateParenthesesDisjunction(PatternTerm& parenthesesTerm, TermGenerationState& state, unsigned alternativeFrameLocation)
     {
         ASSERT((parenthesesTerm.type == PatternTerm::TypeParenthesesSubpattern) || (parenthesesTerm.type == PatternTerm::TypeParentheticalAssertion));
@@ -1784,6 +1850,208 @@ class YarrGenerator : private MacroAssembler {
         // Which means that we match whatever we have matched up to this point (even if nothing).
     }
 
+    // If every alternative of a quantified subpattern consumes the same, fixed number of
+    // characters, and contains nothing that could backtrack or capture, then retrying the
+    // other alternatives of an iteration that has matched could only reproduce the same
+    // state. Backtracking into the parentheses then just gives back whole iterations, so
+    // no more than a count need be kept, e.g. for /(a|b)*c/.
+    bool parenthesesHaveFixedSizeIterations(PatternTerm& parenthesesTerm)
+    {
+        PatternDisjunction* disjunction = parenthesesTerm.parentheses.disjunction;
+        if (!disjunction->m_minimumSize)
+            return false;
+
+        for (unsigned alt = 0; alt < disjunction->m_alternatives.size(); ++alt) {
+            PatternAlternative* alternative = disjunction->m_alternatives[alt];
+            if (alternative->m_minimumSize != disjunction->m_minimumSize)
+                return false;
+
+            for (unsigned i = 0; i < alternative->m_terms.size(); ++i) {
+                PatternTerm& term = alternative->m_terms[i];
+                switch (term.type) {
+                case PatternTerm::TypeAssertionBOL:
+                case PatternTerm::TypeAssertionEOL:
+                case PatternTerm::TypeAssertionWordBoundary:
+                case PatternTerm::TypeForwardReference:
+                    break;
+                case PatternTerm::TypePatternCharacter:
+                case PatternTerm::TypeCharacterClass:
+                    if (term.quantityType != QuantifierFixedCount)
+                        return false;
+                    break;
+                default:
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Matches one iteration of the parentheses, falling through on success. On failure
+    // index is left unchanged and control is transferred to one of the failures.
+    void generateFixedSizeIteration(PatternDisjunction* disjunction, TermGenerationState& state, JumpList& failures)
+    {
+        TermGenerationState parenthesesState(disjunction, state.checkedTotal);
+        int countToCheck = disjunction->m_minimumSize;
+        JumpList successes;
+
+        for (parenthesesState.resetAlternative(); parenthesesState.alternativeValid(); parenthesesState.nextAlternative()) {
+            PatternAlternative* alternative = parenthesesState.alternative();
+            optimizeAlternative(alternative);
+
+            parenthesesState.addBacktrackJump(jumpIfNoAvailableInput(countToCheck));
+            parenthesesState.checkedTotal += countToCheck;
+
+            for (parenthesesState.resetTerm(); parenthesesState.termValid(); parenthesesState.nextTerm())
+                generateTerm(parenthesesState);
+
+            successes.append(jump());
+
+            parenthesesState.linkAlternativeBacktracks(this);
+            sub32(Imm32(countToCheck), index);
+            parenthesesState.checkedTotal -= countToCheck;
+        }
+
+        failures.append(jump());
+        successes.link(this);
+    }
+
+    // Record the last iteration as the match for the subpattern, or clear the match if there were none.
+    // A copy follows the fixed count part of a quantifier, e.g. (a){2,}, so with no iterations of its
+    // own the match is still the last iteration of that, which ended at the current index.
+    void storeFixedSizeIterationCapture(TermGenerationState& state, bool hasIterations)
+    {
+        const RegisterID indexTemporary = regT0;
+        PatternTerm& term = state.term();
+        if (!term.capture())
+            return;
+
+        if (!hasIterations && !term.parentheses.isCopy) {
+            store32(TrustedImm32(-1), Address(output, (term.parentheses.subpatternId << 1) * sizeof(int)));
+            store32(TrustedImm32(-1), Address(output, ((term.parentheses.subpatternId << 1) + 1) * sizeof(int)));
+            return;
+        }
+
+        move(index, indexTemporary);
+        if (state.inputOffset())
+            add32(Imm32(state.inputOffset()), indexTemporary);
+        store32(indexTemporary, Address(output, ((term.parentheses.subpatternId << 1) + 1) * sizeof(int)));
+        sub32(Imm32(term.parentheses.disjunction->m_minimumSize), indexTemporary);
+        store32(indexTemporary, Address(output, (term.parentheses.subpatternId << 1) * sizeof(int)));
+    }
+
+    void generateParenthesesFixedSizeIterations(TermGenerationState& state)
+    {
+        const RegisterID countRegister = regT0;
+        PatternTerm& term = state.term();
+        PatternDisjunction* disjunction = term.parentheses.disjunction;
+        ASSERT(term.type == PatternTerm::TypeParenthesesSubpattern);
+        ASSERT(parenthesesHaveFixedSizeIterations(term));
+
+        // The terms within the parentheses may clobber any register other than index, so
+        // the frame holds the iteration count, followed by the index on entry.
+        unsigned countFrameLocation = term.frameLocation;
+        unsigned indexFrameLocation = term.frameLocation + 1;
+        int iterationSize = disjunction->m_minimumSize;
+
+        storeToFrame(TrustedImm32(0), countFrameLocation);
+
+        switch (term.quantityType) {
+        case QuantifierFixedCount: {
+            storeToFrame(index, indexFrameLocation);
+
+            JumpList failures;
+            Label loop(this);
+            generateFixedSizeIteration(disjunction, state, failures);
+            loadFromFrame(countFrameLocation, countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, countFrameLocation);
+            branch32(NotEqual, countRegister, Imm32(term.quantityCount)).linkTo(loop, this);
+            storeFixedSizeIterationCapture(state, true);
+            Jump matched = jump();
+
+            failures.link(this);
+            loadFromFrame(indexFrameLocation, index);
+            state.jumpToBacktrack(this);
+
+            Label backtrackBegin(this);
+            sub32(Imm32(iterationSize * term.quantityCount), index);
+            storeFixedSizeIterationCapture(state, false);
+            state.jumpToBacktrack(this);
+
+            matched.link(this);
+
+            state.setBacktrackLabel(backtrackBegin);
+            break;
+        }
+
+        case QuantifierGreedy: {
+            JumpList done;
+            Label loop(this);
+            if (term.quantityCount != quantifyInfinite) {
+                loadFromFrame(countFrameLocation, countRegister);
+                done.append(branch32(Equal, countRegister, Imm32(term.quantityCount)));
+            }
+            generateFixedSizeIteration(disjunction, state, done);
+            loadFromFrame(countFrameLocation, countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, countFrameLocation);
+            jump(loop);
+
+            Label backtrackBegin(this);
+            loadFromFrame(countFrameLocation, countRegister);
+            state.jumpToBacktrack(this, branchTest32(Zero, countRegister));
+            sub32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, countFrameLocation);
+            sub32(Imm32(iterationSize), index);
+
+            done.link(this);
+            if (term.capture()) {
+                loadFromFrame(countFrameLocation, countRegister);
+                Jump noIterations = branchTest32(Zero, countRegister);
+                storeFixedSizeIterationCapture(state, true);
+                Jump stored = jump();
+                noIterations.link(this);
+                storeFixedSizeIterationCapture(state, false);
+                stored.link(this);
+            }
+
+            state.setBacktrackLabel(backtrackBegin);
+            break;
+        }
+
+        case QuantifierNonGreedy: {
+            storeToFrame(index, indexFrameLocation);
+            storeFixedSizeIterationCapture(state, false);
+            Jump firstTimeDoNothing = jump();
+
+            Label hardFail(this);
+            loadFromFrame(indexFrameLocation, index);
+            storeFixedSizeIterationCapture(state, false);
+            state.jumpToBacktrack(this);
+
+            Label backtrackBegin(this);
+            if (term.quantityCount != quantifyInfinite) {
+                loadFromFrame(countFrameLocation, countRegister);
+                branch32(Equal, countRegister, Imm32(term.quantityCount)).linkTo(hardFail, this);
+            }
+            JumpList failures;
+            generateFixedSizeIteration(disjunction, state, failures);
+            failures.linkTo(hardFail, this);
+            loadFromFrame(countFrameLocation, countRegister);
+            add32(TrustedImm32(1), countRegister);
+            storeToFrame(countRegister, countFrameLocation);
+            storeFixedSizeIterationCapture(state, true);
+
+            firstTimeDoNothing.link(this);
+
+            state.setBacktrackLabel(backtrackBegin);
+            break;
+        }
+        }
+    }
+
     void generateParentheticalAssertion(TermGenerationState& state)
     {
         PatternTerm& term = state.term();
@@ -1897,7 +2165,10 @@ class YarrGenerator : private MacroAssembler {
             break;
 
         case PatternTerm::TypeBackReference:
-            m_shouldFallBack = true;
+            if (term.quantityType == QuantifierFixedCount && term.quantityCount == 1 && !m_pattern.m_ignoreCase)
+                generateBackReference(state);
+            else
+                m_shouldFallBack = true;
             break;
 
         case PatternTerm::TypeForwardReference:
@@ -1908,6 +2179,8 @@ class YarrGenerator : private MacroAssembler {
                 generateParenthesesSingle(state);
             else if (term.parentheses.isTerminal)
                 generateParenthesesGreedyNoBacktrack(state);
+            else if (parenthesesHaveFixedSizeIterations(term))
+                generateParenthesesFixedSizeIterations(state);
             else
                 m_shouldFallBack = true;
             break;
@@ -2240,6 +2513,12 @@ public:
         if (m_pattern.m_body->m_callFrameSize)
             subPtr(Imm32(m_pattern.m_body->m_callFrameSize * sizeof(void*)), stackPointerRegister);
 
+        if (m_pattern.m_containsBackreferences) {
+            Vector<PatternTerm*> enclosingParentheses;
+            if (backReferenceMayReadStaleCapture(m_pattern.m_body, enclosingParentheses))
+                m_shouldFallBack = true;
+        }
+
         generateDisjunction(m_pattern.m_body);
     }
 
@@ -2257,6 +2536,48 @@ public:
     }
 
 private:
+    // The generated code only records a subpattern's end index when the subpattern
+    // exits, and does not clear captures between iterations of repeated parentheses.
+    // A back reference inside the subpattern it refers to, or inside repeated
+    // parentheses that also contain that subpattern, may therefore read an end index
+    // from an earlier attempt, or one that was never written. Leave those patterns
+    // to the interpreter.
+    static bool backReferenceMayReadStaleCapture(PatternDisjunction* disjunction, Vector<PatternTerm*>& enclosingParentheses)
+    {
+        for (unsigned alt = 0; alt < disjunction->m_alternatives.size(); ++alt) {
+            PatternAlternative* alternative = disjunction->m_alternatives[alt];
+            for (unsigned i = 0; i < alternative->m_terms.size(); ++i) {
+                PatternTerm& term = alternative->m_terms[i];
+                switch (term.type) {
+                case PatternTerm::TypeBackReference:
+                    for (unsigned j = 0; j < enclosingParentheses.size(); ++j) {
+                        PatternTerm& parentheses = *enclosingParentheses[j];
+                        if (parentheses.capture() && parentheses.parentheses.subpatternId == term.backReferenceSubpatternId)
+                            return true;
+                        bool repeats = parentheses.quantityType != QuantifierFixedCount || parentheses.quantityCount != 1;
+                        if (repeats && term.backReferenceSubpatternId >= parentheses.parentheses.subpatternId && term.backReferenceSubpatternId <= parentheses.parentheses.lastSubpatternId)
+                            return true;
+                    }
+                    break;
+
+                case PatternTerm::TypeParenthesesSubpattern:
+                case PatternTerm::TypeParentheticalAssertion: {
+                    enclosingParentheses.append(&term);
+                    bool result = backReferenceMayReadStaleCapture(term.parentheses.disjunction, enclosingParentheses);
+                    enclosingParentheses.removeLast();
+                    if (result)
+                        return true;
+                    break;
+                }
+
+                default:
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
     YarrPattern& m_pattern;
     bool m_shouldFallBack;
     GenerationState m_expressionState;
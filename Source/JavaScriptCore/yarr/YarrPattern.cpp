@@ -346,6 +346,7 @@ public:
         , m_characterClassConstructor(pattern.m_ignoreCase)
         , m_beginCharHelper(&pattern.m_beginChars, pattern.m_ignoreCase)
         , m_invertParentheticalAssertion(false)
+        , m_startedWithBOLBeforeParentheses(false)
     {
         m_pattern.m_body = new PatternDisjunction();
         m_alternative = m_pattern.m_body->addNewAlternative();
@@ -509,6 +510,7 @@ public:
                 numBOLAnchoredAlts++;
         }
 
+        m_startedWithBOLBeforeParentheses = m_alternative->m_startsWithBOL;
         if (numBOLAnchoredAlts) {
             m_alternative->m_containsBOL = true;
             // If all the alternatives in parens start with BOL, then so does this one
@@ -583,8 +585,14 @@ public:
                     newDisjunction->m_parent = disjunction->m_parent;
                 }
                 PatternAlternative* newAlternative = newDisjunction->addNewAlternative();
-                for (unsigned i = 0; i < alternative->m_terms.size(); ++i)
-                    newAlternative->m_terms.append(copyTerm(alternative->m_terms[i], filterStartsWithBOL));
+                for (unsigned i = 0; i < alternative->m_terms.size(); ++i) {
+                    PatternTerm termCopy = copyTerm(alternative->m_terms[i], filterStartsWithBOL);
+                    // Optional parentheses whose alternatives all start with BOL can only match
+                    // zero times once past the first position, so leave them out of the copy.
+                    if (termCopy.type >= PatternTerm::TypeParenthesesSubpattern && !termCopy.parentheses.disjunction)
+                        continue;
+                    newAlternative->m_terms.append(termCopy);
+                }
             }
         }
         
@@ -608,6 +616,11 @@ public:
         ASSERT(min <= max);
         ASSERT(m_alternative->m_terms.size());
 
+        // Parentheses that may match zero times cannot anchor the alternative containing
+        // them, so undo the BOL flag that atomParenthesesEnd() bubbled up.
+        if (!min && m_alternative->lastTerm().type >= PatternTerm::TypeParenthesesSubpattern)
+            m_alternative->m_startsWithBOL = m_startedWithBOLBeforeParentheses;
+
         if (!max) {
             m_alternative->removeLastTerm();
             return;
@@ -954,6 +967,7 @@ private:
     BeginCharHelper m_beginCharHelper;
     bool m_invertCharacterClass;
     bool m_invertParentheticalAssertion;
+    bool m_startedWithBOLBeforeParentheses;
 };
 
 const char* YarrPattern::compile(const UString& patternString)
@@ -36,8 +36,14 @@ void JSDOMWrapperOwner::finalize(JSC::Handle<JSC::Unknown> handle, void* context
     uncacheWrapper(m_world, domObject, wrapper);
 }
 
+// String wrappers are cheap to recreate and carry no identity, so unlike
+// m_wrappers the string cache can drop entries to stay bounded between
+// collections.
+static const size_t stringCacheCapacity = 4096;
+
 DOMWrapperWorld::DOMWrapperWorld(JSC::JSGlobalData* globalData, bool isNormal)
-    : m_globalData(globalData)
+    : m_stringCache(stringCacheCapacity)
+    , m_globalData(globalData)
     , m_isNormal(isNormal)
     , m_defaultWrapperOwner(this)
 {
@@ -33,7 +33,7 @@ class JSDOMWrapper;
 class ScriptController;
 
 typedef HashMap<void*, JSC::Weak<JSDOMWrapper> > DOMObjectWrapperMap;
-typedef JSC::WeakGCMap<StringImpl*, JSC::JSString> JSStringCache;
+typedef JSC::WeakGCCache<StringImpl*, JSC::JSString> JSStringCache;
 
 class JSDOMWrapperOwner : public JSC::WeakHandleOwner {
 public:
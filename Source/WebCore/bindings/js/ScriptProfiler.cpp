@@ -32,6 +32,7 @@
 
 #include "GCController.h"
 #include "JSDOMBinding.h"
+#include "JSDOMWindowBase.h"
 #include <profiler/Profiler.h>
 
 namespace WebCore {
@@ -52,6 +53,16 @@ PassRefPtr<ScriptProfile> ScriptProfiler::stop(ScriptState* state, const String&
     return ScriptProfile::create(profile);
 }
 
+void ScriptProfiler::startSampling()
+{
+    JSDOMWindowBase::commonJSGlobalData()->startSamplingProfiler();
+}
+
+String ScriptProfiler::stopSampling()
+{
+    return ustringToString(JSDOMWindowBase::commonJSGlobalData()->stopSamplingProfiler());
+}
+
 } // namespace WebCore
 
 #endif // ENABLE(JAVASCRIPT_DEBUGGER)
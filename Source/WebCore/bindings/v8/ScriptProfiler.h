@@ -56,6 +56,8 @@ public:
     static void collectGarbage();
     static void start(ScriptState* state, const String& title);
     static PassRefPtr<ScriptProfile> stop(ScriptState* state, const String& title);
+    static void startSampling() { }
+    static String stopSampling() { return String(); }
     static PassRefPtr<ScriptHeapSnapshot> takeHeapSnapshot(const String& title, HeapSnapshotProgress*);
     static void initialize();
 };
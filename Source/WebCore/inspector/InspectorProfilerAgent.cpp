@@ -120,6 +120,16 @@ void InspectorProfilerAgent::collectGarbage(WebCore::ErrorString*)
     ScriptProfiler::collectGarbage();
 }
 
+void InspectorProfilerAgent::startSampling(ErrorString*)
+{
+    ScriptProfiler::startSampling();
+}
+
+void InspectorProfilerAgent::stopSampling(ErrorString*, String* stacks)
+{
+    *stacks = ScriptProfiler::stopSampling();
+}
+
 PassRefPtr<InspectorObject> InspectorProfilerAgent::createProfileHeader(const ScriptProfile& profile)
 {
     RefPtr<InspectorObject> header = InspectorObject::create();
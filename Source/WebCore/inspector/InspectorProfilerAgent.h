@@ -71,6 +71,8 @@ public:
     void isEnabled(ErrorString*, bool* result) { *result = enabled(); }
     void start(ErrorString*) { startUserInitiatedProfiling(); }
     void stop(ErrorString*) { stopUserInitiatedProfiling(); }
+    void startSampling(ErrorString*);
+    void stopSampling(ErrorString*, String* stacks);
 
     void disable();
     void enable(bool skipRecompile);
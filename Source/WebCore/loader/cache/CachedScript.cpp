@@ -27,9 +27,11 @@
 #include "config.h"
 #include "CachedScript.h"
 
+#include "CachedMetadata.h"
 #include "MemoryCache.h"
 #include "CachedResourceClient.h"
 #include "CachedResourceClientWalker.h"
+#include "Settings.h"
 #include "SharedBuffer.h"
 #include "TextResourceDecoder.h"
 #include <wtf/Vector.h>
@@ -40,6 +42,12 @@
 
 namespace WebCore {
 
+#if USE(JSC)
+// Identifies the JSC::SourceProviderCache saved in a script's cached metadata.
+// The cache checks the version of its own format when loaded.
+static const unsigned sourceProviderCacheDataTypeID = 0x4A53432E;
+#endif
+
 CachedScript::CachedScript(const ResourceRequest& resourceRequest, const String& charset)
     : CachedResource(resourceRequest, Script)
     , m_decoder(TextResourceDecoder::create("application/javascript", charset))
@@ -117,8 +125,21 @@ void CachedScript::destroyDecodedData()
     m_script = String();
     unsigned extraSize = 0;
 #if USE(JSC)
-    if (m_sourceProviderCache && m_clients.isEmpty())
-        m_sourceProviderCache->clear();
+    if (m_sourceProviderCache && m_clients.isEmpty()) {
+        if (m_sourceProviderCache->isPersistent()) {
+            // Only one set of metadata can be cached for a resource, so the cache is
+            // saved the first time the script stops being used, by when the functions
+            // that run on load have been compiled.
+            if (m_sourceProviderCache->hasUnsavedChanges() && !cachedMetadata(sourceProviderCacheDataTypeID)) {
+                Vector<char> data;
+                m_sourceProviderCache->save(data);
+                setCachedMetadata(sourceProviderCacheDataTypeID, data.data(), data.size());
+            }
+            // With no clients left, nothing refers to the cache any more.
+            m_sourceProviderCache.clear();
+        } else
+            m_sourceProviderCache->clear();
+    }
 
     extraSize = m_sourceProviderCache ? m_sourceProviderCache->byteSize() : 0;
 #endif
@@ -133,10 +154,17 @@ void CachedScript::decodedDataDeletionTimerFired(Timer<CachedScript>*)
 }
 
 #if USE(JSC)
-JSC::SourceProviderCache* CachedScript::sourceProviderCache() const
+JSC::SourceProviderCache* CachedScript::sourceProviderCache()
 {   
-    if (!m_sourceProviderCache) 
-        m_sourceProviderCache = adoptPtr(new JSC::SourceProviderCache); 
+    if (!m_sourceProviderCache) {
+        m_sourceProviderCache = adoptPtr(new JSC::SourceProviderCache);
+        if (Settings::persistentScriptCacheEnabled()) {
+            const String& source = script();
+            m_sourceProviderCache->enablePersistence(source.characters(), source.length());
+            if (CachedMetadata* metadata = cachedMetadata(sourceProviderCacheDataTypeID))
+                m_sourceProviderCache->load(metadata->data(), metadata->size());
+        }
+    }
     return m_sourceProviderCache.get(); 
 }
 
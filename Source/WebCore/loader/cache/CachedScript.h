@@ -58,7 +58,7 @@ namespace WebCore {
         virtual void destroyDecodedData();
 #if USE(JSC)        
         // Allows JSC to cache additional information about the source.
-        JSC::SourceProviderCache* sourceProviderCache() const;
+        JSC::SourceProviderCache* sourceProviderCache();
         void sourceProviderCacheSizeChanged(int delta);
 #endif
     private:
@@ -69,7 +69,7 @@ namespace WebCore {
         RefPtr<TextResourceDecoder> m_decoder;
         Timer<CachedScript> m_decodedDataDeletionTimer;
 #if USE(JSC)        
-        mutable OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
+        OwnPtr<JSC::SourceProviderCache> m_sourceProviderCache;
 #endif
     };
 }
@@ -64,6 +64,10 @@ bool Settings::gShouldPaintNativeControls = true;
 bool Settings::gShouldUseHighResolutionTimers = true;
 #endif
 
+#if USE(JSC)
+bool Settings::gPersistentScriptCacheEnabled = false;
+#endif
+
 // NOTEs
 //  1) EditingMacBehavior comprises Tiger, Leopard, SnowLeopard and iOS builds, as well QtWebKit and Chromium when built on Mac;
 //  2) EditingWindowsBehavior comprises Win32 and WinCE builds, as well as QtWebKit and Chromium when built on Windows;
@@ -929,6 +933,13 @@ void Settings::setShouldUseHighResolutionTimers(bool shouldUseHighResolutionTime
 }
 #endif
 
+#if USE(JSC)
+void Settings::setPersistentScriptCacheEnabled(bool persistentScriptCacheEnabled)
+{
+    gPersistentScriptCacheEnabled = persistentScriptCacheEnabled;
+}
+#endif
+
 void Settings::setWebAudioEnabled(bool enabled)
 {
     m_webAudioEnabled = enabled;
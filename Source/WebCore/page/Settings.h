@@ -395,6 +395,13 @@ namespace WebCore {
         static bool shouldUseHighResolutionTimers() { return gShouldUseHighResolutionTimers; }
 #endif
 
+#if USE(JSC)
+        // Global switch for saving the parser records and bytecode of scripts in
+        // their cached metadata, and reusing them on later loads. Off by default.
+        static void setPersistentScriptCacheEnabled(bool);
+        static bool persistentScriptCacheEnabled() { return gPersistentScriptCacheEnabled; }
+#endif
+
         void setPluginAllowedRunTime(unsigned);
         unsigned pluginAllowedRunTime() const { return m_pluginAllowedRunTime; }
 
@@ -648,6 +655,9 @@ namespace WebCore {
 #endif
 #if PLATFORM(WIN) || (OS(WINDOWS) && PLATFORM(WX))
         static bool gShouldUseHighResolutionTimers;
+#endif
+#if USE(JSC)
+        static bool gPersistentScriptCacheEnabled;
 #endif
     };
 
@@ -32,20 +32,49 @@ class SegmentedSubstring {
 public:
     SegmentedSubstring()
         : m_length(0)
-        , m_current(0)
+        , m_is8Bit(false)
         , m_doNotExcludeLineNumbers(true)
     {
+        m_data.string16Ptr = 0;
     }
 
+    // Latin-1 strings are read in place, so that the parser never asks them
+    // for a widened copy of their characters.
     SegmentedSubstring(const String& str)
         : m_length(str.length())
-        , m_current(str.isEmpty() ? 0 : str.characters())
+        , m_is8Bit(!str.isEmpty() && str.impl()->is8Bit())
         , m_string(str)
         , m_doNotExcludeLineNumbers(true)
     {
+        if (m_is8Bit)
+            m_data.string8Ptr = str.impl()->characters8();
+        else
+            m_data.string16Ptr = str.isEmpty() ? 0 : str.impl()->characters16();
     }
 
-    void clear() { m_length = 0; m_current = 0; }
+    void clear() { m_length = 0; m_is8Bit = false; m_data.string16Ptr = 0; }
+
+    bool is8Bit() const { return m_is8Bit; }
+    const LChar* current8() const { ASSERT(m_is8Bit); return m_data.string8Ptr; }
+    const UChar* current16() const { ASSERT(!m_is8Bit); return m_data.string16Ptr; }
+
+    // Only valid while m_length is non-zero.
+    UChar currentChar() const { return m_is8Bit ? *m_data.string8Ptr : *m_data.string16Ptr; }
+
+    UChar incrementAndGetCurrentChar()
+    {
+        if (m_is8Bit)
+            return *++m_data.string8Ptr;
+        return *++m_data.string16Ptr;
+    }
+
+    void increment()
+    {
+        if (m_is8Bit)
+            ++m_data.string8Ptr;
+        else
+            ++m_data.string16Ptr;
+    }
     
     bool excludeLineNumbers() const { return !m_doNotExcludeLineNumbers; }
     bool doNotExcludeLineNumbers() const { return m_doNotExcludeLineNumbers; }
@@ -56,20 +85,26 @@ public:
 
     void appendTo(String& str) const
     {
-        if (m_string.characters() == m_current) {
+        if (!numberOfCharactersConsumed()) {
             if (str.isEmpty())
                 str = m_string;
             else
                 str.append(m_string);
-        } else
-            str.append(String(m_current, m_length));
+        } else if (m_is8Bit)
+            str.append(String(StringImpl::create(m_data.string8Ptr, m_length)));
+        else
+            str.append(String(m_data.string16Ptr, m_length));
     }
 
 public:
     int m_length;
-    const UChar* m_current;
 
 private:
+    union {
+        const LChar* string8Ptr;
+        const UChar* string16Ptr;
+    } m_data;
+    bool m_is8Bit;
     String m_string;
     bool m_doNotExcludeLineNumbers;
 };
@@ -91,7 +126,7 @@ public:
         : m_pushedChar1(0)
         , m_pushedChar2(0)
         , m_currentString(str)
-        , m_currentChar(m_currentString.m_current)
+        , m_currentChar(m_currentString.m_length ? m_currentString.currentChar() : 0)
         , m_numberOfCharactersConsumedPriorToCurrentString(0)
         , m_numberOfCharactersConsumedPriorToCurrentLine(0)
         , m_currentLine(0)
@@ -116,14 +151,14 @@ public:
     {
         if (!m_pushedChar1) {
             m_pushedChar1 = c;
-            m_currentChar = m_pushedChar1 ? &m_pushedChar1 : m_currentString.m_current;
+            updateCurrentChar();
         } else {
             ASSERT(!m_pushedChar2);
             m_pushedChar2 = c;
         }
     }
 
-    bool isEmpty() const { return !current(); }
+    bool isEmpty() const { return !m_pushedChar1 && !m_currentString.m_length; }
     unsigned length() const;
 
     bool isClosed() const { return m_closed; }
@@ -134,14 +169,14 @@ public:
         NotEnoughCharacters,
     };
 
-    LookAheadResult lookAhead(const String& string) { return lookAheadInline<SegmentedString::equalsLiterally>(string); }
-    LookAheadResult lookAheadIgnoringCase(const String& string) { return lookAheadInline<SegmentedString::equalsIgnoringCase>(string); }
+    LookAheadResult lookAhead(const String& string) { return lookAheadInline<SegmentedString::equalsLiterally, SegmentedString::equalsLiterally8>(string); }
+    LookAheadResult lookAheadIgnoringCase(const String& string) { return lookAheadInline<SegmentedString::equalsIgnoringCase, SegmentedString::equalsIgnoringCase8>(string); }
 
     void advance()
     {
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase();
@@ -149,19 +184,19 @@ public:
 
     void advanceAndASSERT(UChar expectedCharacter)
     {
-        ASSERT_UNUSED(expectedCharacter, *current() == expectedCharacter);
+        ASSERT_UNUSED(expectedCharacter, m_currentChar == expectedCharacter);
         advance();
     }
 
     void advanceAndASSERTIgnoringCase(UChar expectedCharacter)
     {
-        ASSERT_UNUSED(expectedCharacter, WTF::Unicode::foldCase(*current()) == WTF::Unicode::foldCase(expectedCharacter));
+        ASSERT_UNUSED(expectedCharacter, WTF::Unicode::foldCase(m_currentChar) == WTF::Unicode::foldCase(expectedCharacter));
         advance();
     }
 
     void advancePastNewline(int& lineNumber)
     {
-        ASSERT(*current() == '\n');
+        ASSERT(m_currentChar == '\n');
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
             int newLineFlag = m_currentString.doNotExcludeLineNumbers();
             lineNumber += newLineFlag;
@@ -169,7 +204,7 @@ public:
             if (newLineFlag)
                 m_numberOfCharactersConsumedPriorToCurrentLine = numberOfCharactersConsumed() + 1;
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase(lineNumber);
@@ -177,10 +212,10 @@ public:
     
     void advancePastNonNewline()
     {
-        ASSERT(*current() != '\n');
+        ASSERT(m_currentChar != '\n');
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase();
@@ -189,13 +224,13 @@ public:
     void advance(int& lineNumber)
     {
         if (!m_pushedChar1 && m_currentString.m_length > 1) {
-            int newLineFlag = (*m_currentString.m_current == '\n') & m_currentString.doNotExcludeLineNumbers();
+            int newLineFlag = (m_currentChar == '\n') & m_currentString.doNotExcludeLineNumbers();
             lineNumber += newLineFlag;
             m_currentLine += newLineFlag;
             if (newLineFlag)
                 m_numberOfCharactersConsumedPriorToCurrentLine = numberOfCharactersConsumed() + 1;
             --m_currentString.m_length;
-            m_currentChar = ++m_currentString.m_current;
+            m_currentChar = m_currentString.incrementAndGetCurrentChar();
             return;
         }
         advanceSlowCase(lineNumber);
@@ -220,8 +255,8 @@ public:
 
     String toString() const;
 
-    const UChar& operator*() const { return *current(); }
-    const UChar* operator->() const { return current(); }
+    const UChar& operator*() const { return m_currentChar; }
+    const UChar* operator->() const { return &m_currentChar; }
     
 
     // The method is moderately slow, comparing to currentLine method.
@@ -238,18 +273,35 @@ private:
     void advanceSlowCase();
     void advanceSlowCase(int& lineNumber);
     void advanceSubstring();
-    const UChar* current() const { return m_currentChar; }
+
+    void updateCurrentChar()
+    {
+        if (m_pushedChar1)
+            m_currentChar = m_pushedChar1;
+        else
+            m_currentChar = m_currentString.m_length ? m_currentString.currentChar() : 0;
+    }
 
     static bool equalsLiterally(const UChar* str1, const UChar* str2, size_t count) { return !memcmp(str1, str2, count * sizeof(UChar)); }
     static bool equalsIgnoringCase(const UChar* str1, const UChar* str2, size_t count) { return !WTF::Unicode::umemcasecmp(str1, str2, count); }
+    static bool equalsLiterally8(const UChar* str1, const LChar* str2, size_t count) { return WTF::equal(str2, str1, count); }
+    static bool equalsIgnoringCase8(const UChar* str1, const LChar* str2, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            if (WTF::Unicode::foldCase(str1[i]) != WTF::Unicode::foldCase(str2[i]))
+                return false;
+        }
+        return true;
+    }
 
-    template<bool equals(const UChar* str1, const UChar* str2, size_t count)>
+    template<bool equals(const UChar* str1, const UChar* str2, size_t count), bool equals8(const UChar* str1, const LChar* str2, size_t count)>
     inline LookAheadResult lookAheadInline(const String& string)
     {
         if (!m_pushedChar1 && string.length() <= static_cast<unsigned>(m_currentString.m_length)) {
-            if (equals(string.characters(), m_currentString.m_current, string.length()))
-                return DidMatch;
-            return DidNotMatch;
+            bool matched = m_currentString.is8Bit()
+                ? equals8(string.characters(), m_currentString.current8(), string.length())
+                : equals(string.characters(), m_currentString.current16(), string.length());
+            return matched ? DidMatch : DidNotMatch;
         }
         return lookAheadSlowCase<equals>(string);
     }
@@ -275,7 +327,7 @@ private:
     UChar m_pushedChar1;
     UChar m_pushedChar2;
     SegmentedSubstring m_currentString;
-    const UChar* m_currentChar;
+    UChar m_currentChar;
     int m_numberOfCharactersConsumedPriorToCurrentString;
     int m_numberOfCharactersConsumedPriorToCurrentLine;
     int m_currentLine;